@@ -6,6 +6,7 @@
 #include <variant>
 #include <vector>
 
+#include "can/frame.hpp"
 #include "can/types.hpp"
 #include "can/utils/quark.hpp"
 
@@ -63,7 +64,7 @@ class database {
          * For example, if the message is encoded in the second and
          * third bytes of the message, the start bit index will be 8.
          */
-        [[nodiscard]] virtual unsigned char get_start_bit() const = 0;
+        [[nodiscard]] virtual unsigned short get_start_bit() const = 0;
 
         /**
          * This method returns the number of bit used by the signal.
@@ -134,13 +135,26 @@ class database {
         /**
          * This method extracts the raw value of this message in the frame.
          */
-        [[nodiscard]] uint64_t extract(uint8_t* bytes, size_t length) const;
+        [[nodiscard]] uint64_t extract(const uint8_t* bytes, size_t length) const;
 
         /**
          * This method decodes the signal value from the raw value.
          */
         [[nodiscard]] float decode(uint64_t raw_value) const;
 
+        /**
+         * This method inserts the raw value of this signal in the frame,
+         * leaving the other bits untouched. Big-endian signals are not
+         * supported and leave the frame untouched.
+         */
+        void insert(uint64_t raw_value, uint8_t* bytes, size_t length) const;
+
+        /**
+         * This method encodes the raw value from the signal value, saturated
+         * to the range of the raw value.
+         */
+        [[nodiscard]] uint64_t encode(float value) const;
+
         /**
          * This method resolves, if possible, the readable value from the raw value.
          */
@@ -213,18 +227,34 @@ class database {
         /**
          * This method extracts signals from the given frame using the messages definition.
          */
-        [[nodiscard]] std::vector<std::pair<signal::const_ptr, uint64_t>> extract(uint8_t* bytes, size_t length) const;
+        [[nodiscard]] std::vector<std::pair<signal::const_ptr, uint64_t>> extract(const uint8_t* bytes,
+                                                                                  size_t length) const;
+
+        /**
+         * This method extracts signals from the given inline frame using the messages definition.
+         */
+        template <size_t Capacity>
+        [[nodiscard]] std::vector<std::pair<signal::const_ptr, uint64_t>> extract(
+            const static_frame<Capacity>& frame) const;
 
         /**
          * This method decodes signals from the given frame using the messages definition.
          */
-        [[nodiscard]] std::vector<std::pair<signal::const_ptr, float>> decode(uint8_t* bytes, size_t length) const;
+        [[nodiscard]] std::vector<std::pair<signal::const_ptr, float>> decode(const uint8_t* bytes,
+                                                                              size_t length) const;
+
+        /**
+         * This method decodes signals from the given inline frame using the messages definition.
+         */
+        template <size_t Capacity>
+        [[nodiscard]] std::vector<std::pair<signal::const_ptr, float>> decode(
+            const static_frame<Capacity>& frame) const;
 
         /**
          * This method resolves signals from the given frame using the messages definition.
          */
         [[nodiscard]] std::vector<std::pair<signal::const_ptr, std::variant<float, std::string>>> resolve(
-            uint8_t* bytes, size_t length) const;
+            const uint8_t* bytes, size_t length) const;
 
        private:
         const quark quark_;
@@ -251,18 +281,20 @@ class database {
     /**
      * This method extracts signals from the given frame if the message definition exists.
      */
-    [[nodiscard]] std::vector<std::pair<signal::const_ptr, uint64_t>> extract(unsigned int identifier, uint8_t* bytes,
+    [[nodiscard]] std::vector<std::pair<signal::const_ptr, uint64_t>> extract(unsigned int identifier,
+                                                                              const uint8_t* bytes,
                                                                               size_t length) const;
 
     /**
      * This method decodes signals from the given frame if the message definition exists.
      */
-    [[nodiscard]] std::vector<std::pair<signal::const_ptr, float>> decode(unsigned int identifier, uint8_t* bytes,
+    [[nodiscard]] std::vector<std::pair<signal::const_ptr, float>> decode(unsigned int identifier,
+                                                                          const uint8_t* bytes,
                                                                           size_t length) const;
 };
 
 inline std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::extract(unsigned int identifier,
-                                                                                       uint8_t* bytes,
+                                                                                       const uint8_t* bytes,
                                                                                        size_t length) const {
     auto message = get_message(identifier);
     if (message == nullptr) {
@@ -273,7 +305,7 @@ inline std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::e
 }
 
 inline std::vector<std::pair<database::signal::const_ptr, float>> database::decode(unsigned int identifier,
-                                                                                   uint8_t* bytes,
+                                                                                   const uint8_t* bytes,
                                                                                    size_t length) const {
     auto message = get_message(identifier);
     if (message == nullptr) {
@@ -283,6 +315,18 @@ inline std::vector<std::pair<database::signal::const_ptr, float>> database::deco
     return message->decode(bytes, length);
 }
 
+template <size_t Capacity>
+inline std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::message::extract(
+    const static_frame<Capacity>& frame) const {
+    return extract(frame.bytes_.data(), frame.length_);
+}
+
+template <size_t Capacity>
+inline std::vector<std::pair<database::signal::const_ptr, float>> database::message::decode(
+    const static_frame<Capacity>& frame) const {
+    return decode(frame.bytes_.data(), frame.length_);
+}
+
 } /* namespace can */
 
 #endif /* INCLUDE_CAN_DATABASE_DATABASE_HPP */
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef INCLUDE_CAN_DRIVER_BPF_FILTER_HPP
+#define INCLUDE_CAN_DRIVER_BPF_FILTER_HPP
+
+#include <linux/can.h>
+#include <linux/filter.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if !defined(BUILD_LINUX)
+#error "This filter only works under Linux"
+#endif
+
+namespace can::driver {
+
+/**
+ * Boolean expression over the fields of a frame, compiled to a classic BPF
+ * program the kernel runs on every frame received by a socketcan socket.
+ * Frames for which the expression is false are dropped before being copied
+ * to user space.
+ *
+ *     using can::driver::bpf_filter;
+ *     auto filter = bpf_filter::identifier(0x123) && (bpf_filter::byte(0, 1) || bpf_filter::byte(0, 4));
+ */
+class bpf_filter {
+   public:
+    /**
+     * This method matches frames whose identifier, masked by `mask`, equals
+     * the specified identifier masked the same way.
+     */
+    static bpf_filter identifier(uint32_t identifier, uint32_t mask = CAN_SFF_MASK);
+
+    /**
+     * This method matches frames whose payload is `length` bytes long. For
+     * classic frames, this is the DLC.
+     */
+    static bpf_filter length(uint8_t length);
+
+    /**
+     * This method matches frames whose payload byte at `index`, masked by
+     * `mask`, equals the specified value masked the same way. Frames too
+     * short to have this byte never match.
+     */
+    static bpf_filter byte(uint8_t index, uint8_t value, uint8_t mask = UINT8_MAX);
+
+    /**
+     * This method matches frames whose payload bit at `index` has the
+     * specified value. Bits are numbered from the least significant bit of
+     * the first byte.
+     */
+    static bpf_filter bit(uint16_t index, bool value = true);
+
+    friend bpf_filter operator&&(const bpf_filter& lhs, const bpf_filter& rhs);
+    friend bpf_filter operator||(const bpf_filter& lhs, const bpf_filter& rhs);
+    friend bpf_filter operator!(const bpf_filter& operand);
+
+    /**
+     * This method compiles the expression to a program accepting the frames
+     * matched by the expression. It returns an empty program if the expression
+     * is too large to be represented.
+     */
+    [[nodiscard]] std::vector<sock_filter> compile() const;
+
+   private:
+    friend class program_builder;
+
+    struct node;
+
+    std::shared_ptr<const node> node_;
+
+    explicit bpf_filter(std::shared_ptr<const node> node);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_BPF_FILTER_HPP */
@@ -15,11 +15,14 @@ namespace can::driver {
 class candlelight : public transceiver {
    public:
     static std::list<std::string> list_interfaces();
-    static ptr create(const std::string& device);
+    static ptr create(const std::string& device, const options& options = {});
     ~candlelight() override;
 
     bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
     bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
     frame::ptr receive(long timeout_ms = -1) override;
 
    private:
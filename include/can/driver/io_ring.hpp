@@ -0,0 +1,157 @@
+#ifndef INCLUDE_CAN_DRIVER_IO_RING_HPP
+#define INCLUDE_CAN_DRIVER_IO_RING_HPP
+
+#include <linux/can.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "can/transceiver.hpp"
+
+#if !defined(BUILD_LINUX)
+#error "This ring only works under Linux"
+#endif
+
+namespace can::driver {
+
+/**
+ * Frame exchange with a CAN socket through io_uring.
+ *
+ * Frames are received by a single multishot `recvmsg` request, which keeps
+ * filling buffers of a ring registered with the kernel until they are all in
+ * use, so frames are read from completions without any syscall as long as
+ * some are pending. Frames are transmitted by batches of linked non-blocking
+ * sends, submitted at once.
+ *
+ * Receiving and transmitting use separate io_uring instances, so frames can be
+ * transmitted from any thread while a single thread consumes received frames.
+ *
+ * The ring accepts these options:
+ *   - `uring_buffer_count`: number of receive buffers, a power of two (256).
+ */
+class io_ring {
+   public:
+    /**
+     * A received frame, along with its source address and control messages.
+     * The frame points into a receive buffer and is only valid until it is
+     * popped.
+     */
+    struct packet {
+        const canfd_frame* frame_;
+        size_t mtu_;
+        msghdr header_;
+    };
+
+    static std::unique_ptr<io_ring> create(int socket, const transceiver::options& options = {});
+    ~io_ring();
+
+    io_ring(const io_ring& other)            = delete;
+    io_ring& operator=(const io_ring& other) = delete;
+    io_ring(io_ring&& other)                 = delete;
+    io_ring& operator=(io_ring&& other)      = delete;
+
+    /**
+     * This method returns a file descriptor that is readable when received
+     * frames are pending.
+     */
+    [[nodiscard]] int get_fd() const;
+
+    /**
+     * This method returns the next received frame without consuming it,
+     * waiting at most `timeout_ms` for one.
+     */
+    std::optional<packet> peek(long timeout_ms = -1);
+
+    /**
+     * This method consumes the frame returned by `peek()`, giving its buffer
+     * back to the kernel.
+     */
+    void pop();
+
+    /**
+     * This method writes the specified kernel frames to the socket, in order,
+     * as linked non-blocking sends. It returns the number of frames written,
+     * which stops at the first frame that could not be written. Frames refused
+     * because the socket buffer or the transmit queue of the interface is full
+     * are not reported as errors, they are left to the caller. It waits at
+     * most `timeout_ms` for the kernel to complete the writes, or forever if
+     * it's negative.
+     *
+     * The frame after the returned count may only be retried by the caller
+     * when `has_pending_writes()` returns false. Otherwise the sends of the
+     * frames after the returned count are still with the kernel, which may
+     * write them later, and retrying them could send them twice or out of
+     * order.
+     */
+    size_t transmit(std::span<const iovec> frames, long timeout_ms = -1);
+
+    /**
+     * This method returns whether sends of a previous transmission are still
+     * with the kernel, because their completions didn't arrive in time.
+     */
+    bool has_pending_writes();
+
+   private:
+    static constexpr size_t TRANSMIT_SLOTS = 64;
+
+    struct queue;
+
+    const int socket_;
+    const std::unique_ptr<queue> receive_;
+    const std::unique_ptr<queue> transmit_;
+
+    /**
+     * The registered receive buffers and the ring handing them to the kernel.
+     */
+    std::vector<uint8_t> buffers_;
+    void* const buffer_ring_;
+    const uint32_t buffer_count_;
+    uint16_t buffer_tail_;
+
+    /**
+     * The header of the multishot request, which is armed again whenever the
+     * kernel stops it, and the buffer of the frame being consumed.
+     */
+    msghdr receive_header_;
+    bool armed_;
+    std::optional<uint16_t> current_;
+
+    /**
+     * Mutex used to protect the transmit queue and the frames it writes.
+     */
+    std::mutex transmit_mutex_;
+    std::array<canfd_frame, TRANSMIT_SLOTS> slots_;
+
+    /**
+     * Number of writes submitted, or published by a failed submission, whose
+     * completion wasn't consumed yet. Their slots can't be reused until then.
+     */
+    uint32_t transmit_pending_;
+
+    io_ring(int socket, std::unique_ptr<queue> receive, std::unique_ptr<queue> transmit, void* buffer_ring,
+            uint32_t buffer_count);
+
+    [[nodiscard]] uint8_t* get_buffer(uint16_t id);
+
+    void recycle_buffer(uint16_t id);
+    bool arm_receive();
+
+    /**
+     * This method waits for the completions of the writes left pending by a
+     * previous transmission, until the deadline if any. The transmit mutex
+     * must be held.
+     */
+    bool drain_transmit(std::optional<std::chrono::steady_clock::time_point> deadline);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_IO_RING_HPP */
@@ -0,0 +1,152 @@
+#ifndef INCLUDE_CAN_DRIVER_PACKET_RING_HPP
+#define INCLUDE_CAN_DRIVER_PACKET_RING_HPP
+
+#include <linux/can.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "can/transceiver.hpp"
+
+#if !defined(BUILD_LINUX)
+#error "This ring only works under Linux"
+#endif
+
+namespace can::driver {
+
+/**
+ * Receive ring shared with the kernel, made of the blocks of a `PACKET_RX_RING`
+ * (TPACKET_V3) mapped from an `AF_PACKET` socket bound to a CAN interface.
+ *
+ * The kernel fills whole blocks of frames and hands them over at once, so
+ * frames are read straight from the mapping without any copy or syscall as
+ * long as blocks are ready. A block is given back to the kernel once all of
+ * its frames are consumed.
+ *
+ * The kernel hands the frames transmitted from this host over to the ring on
+ * their way out. Like a raw CAN socket, the ring delivers the frames of the
+ * other sockets but skips the frames its owner announced with
+ * `expect_sent()`. The ring may only be consumed by a single thread.
+ *
+ * The ring accepts these options:
+ *   - `ring_block_size`: size of each block in bytes, a multiple of the page size (64 KiB).
+ *   - `ring_block_count`: number of blocks in the ring (32).
+ *   - `ring_timeout_ms`: time after which the kernel hands over a partially filled block (10 ms).
+ *   - `timestamping`: set to "hardware" to prefer the timestamps of the device.
+ */
+class packet_ring {
+   public:
+    /**
+     * A frame in the ring. The frame points into the mapping and is only
+     * valid until it is popped.
+     */
+    struct packet {
+        const canfd_frame* frame_;
+        size_t mtu_;
+        uint64_t timestamp_;
+        bool hardware_timestamp_;
+        uint32_t interface_;
+    };
+
+    static std::unique_ptr<packet_ring> create(const std::string& interface, const transceiver::options& options = {});
+    ~packet_ring();
+
+    packet_ring(const packet_ring& other)            = delete;
+    packet_ring& operator=(const packet_ring& other) = delete;
+    packet_ring(packet_ring&& other)                 = delete;
+    packet_ring& operator=(packet_ring&& other)      = delete;
+
+    /**
+     * This method returns the socket the ring is mapped from.
+     */
+    [[nodiscard]] int get_socket() const;
+
+    /**
+     * This method returns the next frame of the ring without consuming it,
+     * waiting at most `timeout_ms` for the kernel to hand over a block.
+     */
+    std::optional<packet> peek(long timeout_ms = -1);
+
+    /**
+     * This method consumes the frame returned by `peek()`, giving its block
+     * back to the kernel if it was the last frame of the block.
+     */
+    void pop();
+
+    /**
+     * This method announces a frame about to be written by the owner of the
+     * ring, so that it's skipped when it's seen on its way out. It must be
+     * called before the frame is written, and the frames that couldn't be
+     * written must be withdrawn with `cancel_sent()`. It may be called from
+     * any thread.
+     */
+    void expect_sent(const canfd_frame& frame, size_t mtu);
+
+    /**
+     * This method withdraws the last `count` frames announced with
+     * `expect_sent()`. It may be called from any thread.
+     */
+    void cancel_sent(size_t count);
+
+    /**
+     * This method returns the number of frames the kernel dropped because the
+     * ring was full. It may be called from any thread.
+     */
+    uint64_t get_drop_count();
+
+   private:
+    const int socket_;
+    uint8_t* const map_;
+    const size_t block_size_;
+    const size_t block_count_;
+
+    /**
+     * The block being consumed, and the position in this block.
+     */
+    size_t block_index_;
+    uint32_t remaining_;
+    const uint8_t* next_;
+
+    /**
+     * Frames dropped so far, as the kernel resets its counters when they are
+     * read.
+     */
+    std::atomic<uint64_t> drops_;
+
+    /**
+     * Frames written by the owner of the ring and not seen yet, in the order
+     * they were written. Mutex used to protect them, as they may be written
+     * from another thread.
+     */
+    std::mutex sent_mutex_;
+    std::deque<std::pair<canfd_frame, size_t>> sent_;
+    const size_t max_sent_;
+
+    packet_ring(int socket, uint8_t* map, size_t block_size, size_t block_count, size_t frame_count);
+
+    [[nodiscard]] uint8_t* get_block(size_t index) const;
+
+    bool wait_for_block(long timeout_ms);
+    void release_block();
+
+    /**
+     * This method returns whether an outgoing frame was written by the owner
+     * of the ring, forgetting only the matching frame. Frames from other
+     * sockets may carry the same content, so the frames announced before it
+     * are kept until they are seen or pushed out by newer ones.
+     */
+    bool is_sent(const canfd_frame& frame, size_t mtu);
+};
+
+inline int packet_ring::get_socket() const {
+    return socket_;
+}
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_PACKET_RING_HPP */
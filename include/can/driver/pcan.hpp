@@ -23,20 +23,41 @@ class pcan : public transceiver {
 #endif /* BUILD_WINDOWS */
 
     static std::list<std::string> list_interfaces();
-    static ptr create(const std::string& interface);
+    /**
+     * The channel is opened in CAN FD mode when the `fd_bitrate` option is given,
+     * using the PCAN-Basic FD bitrate string format.
+     */
+    static ptr create(const std::string& interface, const options& options = {});
     ~pcan() override;
 
     bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
     bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
     frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+
+    /**
+     * This method waits for a frame, then reads every frame queued in the
+     * driver until the batch is full, without waiting again.
+     */
+    size_t receive_batch(frame_batch& batch, long timeout_ms = -1) override;
+    [[nodiscard]] int get_poll_fd() const override;
 
    private:
     const unsigned int device_;
     const event_type event_;
+    const bool fd_;
+
+    pcan(unsigned int device, event_type event, bool fd);
 
-    pcan(unsigned int device, event_type event);
+    /**
+     * This method reads a frame queued in the driver, if any, without waiting.
+     */
+    bool try_receive(fd_frame& msg);
 
-    frame::ptr try_receive();
+    bool wait_for_frames(long timeout_ms);
 };
 
 } /* namespace can::driver */
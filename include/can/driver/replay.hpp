@@ -0,0 +1,114 @@
+#ifndef INCLUDE_CAN_DRIVER_REPLAY_HPP
+#define INCLUDE_CAN_DRIVER_REPLAY_HPP
+
+#include <chrono>
+#include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "can/transceiver.hpp"
+
+namespace can::driver {
+
+/**
+ * Driver serving a recorded capture, registered as the "replay" driver. The interface is the path of the capture, in
+ * the log format of the candump utility of can-utils, one frame per line:
+ *
+ *     (1436509052.249713) can0 123#DEADBEEF
+ *     (1436509052.250117) can0 456##1DEADBEEF
+ *
+ * Frames are received with their recorded timestamps, and are paced by the time elapsed between them unless the
+ * capture is replayed as fast as possible. The capture is streamed, so its size is not limited by the memory. Lines
+ * that can't be parsed are skipped with a warning, remote frames are skipped silently. Nothing can be transmitted.
+ *
+ * It accepts the following options:
+ *   - `speed`: playback speed relative to the recorded time, 0 to replay as fast as possible (1).
+ *   - `repeat`: number of times the capture is played, 0 to play it forever (1). Each pass shifts the timestamps
+ *     by the duration of the capture plus its average frame interval, so they keep increasing.
+ *   - `remap`: identifiers replaced when the capture is read, as comma separated hexadecimal pairs, such as
+ *     "123:223,124:224". Filters apply to the replaced identifiers.
+ *
+ * Once the capture is over, receptions wait for their timeout and return `nullptr`, immediately when they would
+ * wait forever.
+ */
+class replay : public transceiver {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Captures aren't enumerated, this method returns an empty list.
+     */
+    static std::list<std::string> list_interfaces();
+    static ptr create(const std::string& interface, const options& options = {});
+
+    bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
+    bool transmit(frame::ptr msg) override;
+    frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+    bool set_filter(const std::vector<uint32_t>& identifiers) override;
+    bool clear_filter() override;
+
+    /**
+     * This method returns whether every pass of the capture was received.
+     */
+    [[nodiscard]] bool finished() const;
+
+   private:
+    const std::string path_;
+    std::ifstream file_;
+    const double speed_;
+    const uint64_t repeat_;
+    const std::map<uint32_t, uint32_t> remap_;
+
+    /**
+     * Mutex used to protect the filter and the position in the capture, as
+     * filters may be changed while another thread receives.
+     */
+    mutable std::mutex mutex_;
+
+    bool filtered_;
+    std::vector<uint32_t> filter_;
+
+    /* position in the capture */
+    size_t line_;
+    uint64_t pass_;
+    size_t pass_frames_;
+    size_t capture_frames_;
+    bool finished_;
+
+    /* recorded timestamps of the first and last frames read, and the shift applied to the current pass */
+    std::optional<uint64_t> first_timestamp_;
+    uint64_t last_timestamp_;
+    uint64_t offset_ns_;
+
+    /* time at which the first frame was received, the others are paced from it */
+    std::optional<clock::time_point> started_;
+
+    /* next frame of the capture, read ahead to know when it is due */
+    std::optional<fd_frame> next_;
+
+    replay(std::string path, std::ifstream file, double speed, uint64_t repeat, std::map<uint32_t, uint32_t> remap);
+
+    /**
+     * This method reads the next frame accepted by the filter, starting the
+     * next pass at the end of the capture. It returns `false` once the last
+     * pass is over. The mutex must be held.
+     */
+    bool read_next();
+
+    /**
+     * This method waits for the next frame to be due, at most `timeout_ms`.
+     * It returns `false` if it isn't due by then or if the capture is over.
+     * The mutex must be held through `lock`, it is released while sleeping.
+     */
+    bool wait_for_next(std::unique_lock<std::mutex>& lock, long timeout_ms);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_REPLAY_HPP */
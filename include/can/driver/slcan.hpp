@@ -0,0 +1,150 @@
+#ifndef INCLUDE_CAN_DRIVER_SLCAN_HPP
+#define INCLUDE_CAN_DRIVER_SLCAN_HPP
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "can/transceiver.hpp"
+
+#if !defined(BUILD_LINUX)
+#error "This driver only works under Linux"
+#endif
+
+namespace can::driver {
+
+/**
+ * Driver for adapters speaking the slcan (Lawicel) ASCII protocol over a serial line, registered as the "slcan"
+ * driver. The interface is the path of the tty, such as "/dev/ttyACM0".
+ *
+ * Frames are exchanged as lines terminated by a carriage return, such as "t1234DEADBEEF" for a classic frame,
+ * "T" for extended identifiers, "d"/"D" for CAN FD frames and "b"/"B" for CAN FD frames switching bitrate. The tty
+ * is read by large chunks, each parsed into as many frames as it holds. Remote frames and command replies are
+ * skipped.
+ *
+ * It accepts the following options:
+ *   - `baudrate`: speed of the serial line, ignored by USB adapters (115200).
+ *   - `bitrate`: bitrate the channel is opened with, otherwise the adapter keeps its own.
+ *   - `listen_only`: 1 to open the channel without acknowledging frames nor transmitting (0).
+ *   - `timestamps`: "host" to timestamp frames with the realtime clock of the host when read (default), or
+ *     "device" to use the millisecond timestamps of the adapter, flagged as hardware timestamps. They wrap every
+ *     minute, and are aligned on the host clock.
+ *   - `tx_timeout_ms`: time after which a transmission waiting for the tty fails, negative to wait forever (1000).
+ */
+class slcan : public transceiver {
+   public:
+    enum class timestamp_mode { HOST, DEVICE };
+
+    /**
+     * This method lists the ttys of USB serial adapters.
+     */
+    static std::list<std::string> list_interfaces();
+    static ptr create(const std::string& interface, const options& options = {});
+
+    /**
+     * The channel is closed before the tty.
+     */
+    ~slcan() override;
+
+    /**
+     * This method reopens the channel with one of the standard bitrates of the
+     * protocol, from 10 kbit/s to 1 Mbit/s.
+     */
+    bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
+    bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
+
+    /**
+     * This method writes the lines of as many frames as possible at once.
+     */
+    size_t transmit_batch(const frame_batch_view& batch) override;
+    frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+
+    /**
+     * Frames with other identifiers are dropped when parsed.
+     */
+    bool set_filter(const std::vector<uint32_t>& identifiers) override;
+    bool clear_filter() override;
+
+   private:
+    static constexpr size_t READ_SIZE = 4096;
+
+    /* longest line: extended CAN FD frame of 64 bytes with a timestamp */
+    static constexpr size_t MAX_LINE_SIZE = 1 + 8 + 1 + 2 * 64 + 4 + 1;
+
+    const int fd_;
+    const std::string path_;
+    const timestamp_mode timestamps_;
+    const bool listen_only_;
+    const long transmit_timeout_ms_;
+
+    /* characters read from the tty and not parsed yet, between `begin_` and `end_` */
+    std::array<char, READ_SIZE + MAX_LINE_SIZE> buffer_;
+    size_t begin_;
+    size_t end_;
+
+    /* whether the tty was hung up, it is then never read again */
+    bool hung_up_;
+
+    /**
+     * Mutex used to protect the filter, as it may be changed while another
+     * thread receives.
+     */
+    std::mutex filter_mutex_;
+    bool filtered_;
+    std::vector<uint32_t> filter_;
+
+    /* realtime clock of the host when the tty was last read */
+    uint64_t read_time_ns_;
+
+    /* host time at which the minute of the last device timestamp started, and that timestamp in milliseconds */
+    std::optional<uint64_t> device_base_ns_;
+    uint16_t device_last_ms_;
+
+    std::mutex transmit_mutex_;
+
+    slcan(int fd, std::string path, timestamp_mode timestamps, bool listen_only, long transmit_timeout_ms);
+
+    /**
+     * This method writes the whole text to the tty, waiting for it to drain
+     * if needed. The transmit mutex must be held.
+     */
+    bool write_all(std::string_view text);
+
+    /**
+     * This method parses the next frame already read and accepted by the
+     * filter, if any.
+     */
+    bool parse_next(fd_frame& msg);
+
+    /**
+     * This method reads the tty after the characters not parsed yet, waiting
+     * at most `timeout_ms` for them. It returns false if the timeout expired
+     * or if the tty can't be read. Once the tty is hung up, it waits like on
+     * an idle bus.
+     */
+    bool read_more(long timeout_ms);
+
+    /**
+     * This method parses the next frame, reading the tty until one is
+     * available or the timeout expires.
+     */
+    bool next_frame(fd_frame& msg, long timeout_ms);
+
+    /**
+     * This method converts a device timestamp, in milliseconds within a
+     * minute, to nanoseconds since the epoch.
+     */
+    uint64_t to_host_time(uint16_t device_ms);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_SLCAN_HPP */
@@ -1,10 +1,17 @@
 #ifndef INCLUDE_CAN_DRIVER_SOCKETCAN_HPP
 #define INCLUDE_CAN_DRIVER_SOCKETCAN_HPP
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
 
+#include "can/driver/bpf_filter.hpp"
+#include "can/driver/io_ring.hpp"
+#include "can/driver/packet_ring.hpp"
 #include "can/transceiver.hpp"
 
 #if !defined(BUILD_LINUX)
@@ -13,22 +20,207 @@
 
 namespace can::driver {
 
+/**
+ * Driver for SocketCAN interfaces.
+ *
+ * The "any" interface receives the frames of every CAN interface through a single socket, each tagged with the
+ * index of its source interface in `interface_`. Frames transmitted through it must specify their egress interface
+ * the same way. Only the "raw" backend is available for this interface, and its bitrate can't be set.
+ *
+ * Besides the options of `packet_ring` and `io_ring`, it accepts:
+ *   - `backend`: "raw" to receive frames from the CAN socket (default), "mmap" to receive them from a
+ *     `packet_ring` instead, or "io_uring" to receive them and transmit batches through an `io_ring`.
+ *     Single frames are always written to the CAN socket directly. Every backend receives the frames transmitted
+ *     by the other sockets of this host, but not those of the transceiver.
+ *   - `timestamping`: "software" or "hardware" to timestamp frames with SO_TIMESTAMPING.
+ *   - `rcvbuf`: size of the socket receive buffer in bytes (SO_RCVBUF), capped by `net.core.rmem_max`.
+ *   - `rcvbuf_force`: size of the socket receive buffer in bytes, ignoring `net.core.rmem_max` (SO_RCVBUFFORCE).
+ *     This requires CAP_NET_ADMIN.
+ *   - `busy_poll_us`: time in microseconds the kernel busy polls the device for frames on blocking receptions
+ *     (SO_BUSY_POLL). Raising it above `net.core.busy_read` requires CAP_NET_ADMIN.
+ *   - `sndbuf`: size of the socket send buffer in bytes (SO_SNDBUF).
+ *   - `tx_queue_size`: number of frames held in user space while the transmit queue of the interface is full (0).
+ *     Held frames are written first by the next transmission, or by `flush()`.
+ *   - `tx_policy`: what a transmission does when both queues are full, see `transmit_policy` ("block").
+ *   - `tx_timeout_ms`: time after which a blocked transmission fails, negative to wait forever (1000 ms).
+ */
 class socketcan : public transceiver {
    public:
+    static constexpr const char* ANY_INTERFACE = "any";
+
+    /**
+     * Behavior of a transmission when neither the interface nor the user space queue can take the frame.
+     */
+    enum class transmit_policy {
+        BLOCK,       /* wait for the interface to accept frames, up to `tx_timeout_ms` */
+        DROP_OLDEST, /* discard the oldest frame held in user space, or the frame itself if none is held */
+        FAIL_FAST,   /* fail the transmission immediately */
+    };
+
+    /**
+     * Transmit counters of a transceiver.
+     */
+    struct transmit_statistics {
+        size_t queue_depth_;     /* frames currently held in user space */
+        size_t max_queue_depth_; /* largest number of frames held in user space at once */
+        uint64_t queued_;        /* frames held in user space because the interface was full */
+        uint64_t dropped_;       /* frames discarded by the DROP_OLDEST policy or after a write error */
+        uint64_t rejected_;      /* frames failed by the FAIL_FAST policy or after a blocking timeout */
+    };
+
+    /**
+     * Receive counters of a transceiver.
+     */
+    struct receive_statistics {
+        uint64_t received_;  /* frames returned by the transceiver */
+        uint64_t dropped_;   /* frames dropped by the kernel because the receive buffer or ring was full */
+        size_t buffer_size_; /* size of the socket receive buffer in bytes, as reported by the kernel */
+    };
+
     static std::list<std::string> list_interfaces();
-    static ptr create(const std::string& interface);
+    static ptr create(const std::string& interface, const options& options = {});
     ~socketcan() override;
 
     bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
     bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
+    size_t transmit_batch(const frame_batch_view& batch) override;
     frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+    size_t receive_batch(frame_batch& batch, long timeout_ms = -1) override;
+    bool set_filter(const std::vector<uint32_t>& identifiers) override;
+    bool clear_filter() override;
+    [[nodiscard]] int get_poll_fd() const override;
+
+    /**
+     * This method attaches a BPF program to the receiving socket, so the kernel
+     * drops the frames not matched by the filter. It replaces any attached
+     * program and applies on top of the identifier filter.
+     */
+    bool attach_filter(const bpf_filter& filter);
+
+    /**
+     * This method detaches the BPF program attached to the socket, if any.
+     */
+    bool detach_filter();
+
+    /**
+     * This method writes the frames held in user space, waiting at most `timeout_ms` for the interface to accept
+     * them. It returns false if some frames are still held.
+     */
+    bool flush(long timeout_ms = -1);
+
+    /**
+     * This method returns the transmit counters of the transceiver.
+     */
+    transmit_statistics get_transmit_statistics();
+
+    /**
+     * This method returns the receive counters of the transceiver. Frames
+     * dropped by the kernel are only reported once a later frame is received,
+     * except with the "mmap" backend.
+     */
+    receive_statistics get_receive_statistics() const;
 
    private:
+    /**
+     * A kernel frame ready to be written, along with its egress interface.
+     */
+    struct pending_frame {
+        canfd_frame frame_;
+        size_t mtu_;
+        uint32_t interface_;
+    };
+
+    enum class write_result { WRITTEN, FULL, FAILED };
+
+    struct transmit_settings {
+        transmit_policy policy_;
+        size_t queue_size_;
+        long timeout_ms_;
+    };
+
     const int socket_;
     const std::string interface_;
-    std::mutex receive_mutex_;
+    const bool any_interface_;
+
+    /**
+     * The ring frames are received from with the "mmap" backend, or `nullptr`.
+     */
+    const std::unique_ptr<packet_ring> ring_;
+
+    /**
+     * The io_uring instances frames are exchanged through with the "io_uring" backend, or `nullptr`.
+     */
+    const std::unique_ptr<io_ring> uring_;
+
+    const transmit_settings transmit_settings_;
+
+    /**
+     * Mutex used to protect the user space transmit queue and the transmit counters.
+     */
+    std::mutex transmit_mutex_;
+    std::deque<pending_frame> transmit_queue_;
+    transmit_statistics transmit_statistics_;
+
+    /**
+     * Whether the last refused write was refused by the interface (ENOBUFS)
+     * rather than by the socket, in which case POLLOUT doesn't tell when to
+     * try again.
+     */
+    bool interface_full_;
+
+    /**
+     * Receive counters, updated by the receiving thread. The kernel reports
+     * the total number of frames dropped by the socket along with each
+     * frame received after a drop.
+     */
+    std::atomic<uint64_t> received_frames_;
+    std::atomic<uint32_t> dropped_frames_;
+
+    socketcan(int socket, std::string interface, std::unique_ptr<packet_ring> ring, std::unique_ptr<io_ring> uring,
+              transmit_settings transmit_settings);
+
+    [[nodiscard]] int get_receive_socket() const;
+
+    bool wait_for_frames(long timeout_ms);
+
+    /**
+     * This method counts a frame received from the socket, along with the
+     * drops reported in its control messages.
+     */
+    void count_received(msghdr& header);
+
+    bool receive_from_ring(fd_frame& msg, long timeout_ms);
+    size_t receive_batch_from_ring(frame_batch& batch, long timeout_ms);
+
+    bool receive_from_uring(fd_frame& msg, long timeout_ms);
+    size_t receive_batch_from_uring(frame_batch& batch, long timeout_ms);
+
+    /**
+     * This method writes a frame without blocking.
+     */
+    write_result write_frame(const pending_frame& frame);
+
+    /**
+     * This method transmits a frame after the frames held in user space, applying the transmit policy if it can't
+     * be written nor held. The transmit mutex must be held.
+     */
+    bool send_frame(const pending_frame& frame);
+
+    /**
+     * This method writes the frames held in user space until the interface refuses one. It returns false if some
+     * frames are still held. The transmit mutex must be held.
+     */
+    bool drain_queue();
 
-    socketcan(int socket, std::string interface);
+    /**
+     * This method waits for the interface to accept frames again, until the deadline. The transmit mutex must be
+     * held.
+     */
+    bool wait_for_room(std::optional<std::chrono::steady_clock::time_point> deadline);
 };
 
 } /* namespace can::driver */
@@ -0,0 +1,135 @@
+#ifndef INCLUDE_CAN_DRIVER_SYNTHETIC_HPP
+#define INCLUDE_CAN_DRIVER_SYNTHETIC_HPP
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "can/database.hpp"
+#include "can/transceiver.hpp"
+
+namespace can::driver {
+
+/**
+ * Driver generating the traffic described by a database, registered as the "synthetic" driver, whose interface is
+ * the path of the database. Every message with a cycle time, the `GenMsgCycleTime` attribute of DBC messages, is
+ * received once per cycle, with its signals filled by generators:
+ *   - "constant:VALUE": always the same value, the minimum of the signal by default.
+ *   - "ramp:STEP": from the minimum to the maximum of the signal by steps, then again from the minimum. The default
+ *     step is the scale of the signal.
+ *   - "random": uniformly distributed between the minimum and the maximum of the signal.
+ *
+ * The range of a signal is given by its minimum and maximum when set, and by its raw value otherwise. Messages are
+ * sent at the beginning of the first cycle and are ordered by identifier when due at once, like after arbitration.
+ * Frames are timestamped with the realtime clock of the host at the first reception, plus their scheduled time.
+ *
+ * It accepts the following options:
+ *   - `speed`: playback speed relative to the schedule, 0 to generate frames as fast as possible (1).
+ *   - `cycle_time_ms`: cycle time of the messages without one, 0 to leave them out (0).
+ *   - `generator`: generator of every signal ("random").
+ *   - `generator.MESSAGE.SIGNAL`: generator of a single signal.
+ *   - `seed`: seed of the random generators, so runs are reproducible (0).
+ *
+ * Nothing can be transmitted.
+ */
+class synthetic : public transceiver {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr const char* CYCLE_TIME_ATTRIBUTE = "GenMsgCycleTime";
+
+    /**
+     * Databases aren't enumerated, this method returns an empty list.
+     */
+    static std::list<std::string> list_interfaces();
+    static ptr create(const std::string& interface, const options& options = {});
+
+    /**
+     * This method generates the traffic of an already loaded database.
+     */
+    static ptr create(database::const_ptr database, const options& options = {});
+
+    bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
+    bool transmit(frame::ptr msg) override;
+    frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+
+    /**
+     * This method stops generating the messages with other identifiers. They
+     * stay scheduled, so clearing the filter restores the same traffic.
+     */
+    bool set_filter(const std::vector<uint32_t>& identifiers) override;
+    bool clear_filter() override;
+
+   private:
+    struct generator {
+        enum class kind { CONSTANT, RAMP, RANDOM };
+
+        database::signal::const_ptr signal_;
+        kind kind_;
+        double min_;
+        double max_;
+        double step_;
+        double value_;
+    };
+
+    struct schedule {
+        database::message::const_ptr message_;
+        uint64_t cycle_time_ns_;
+        bool enabled_;
+
+        /* the multiplexer, if any, is generated first */
+        std::vector<generator> generators_;
+    };
+
+    /* due time in nanoseconds since the start, identifier and index of a message */
+    using due_message = std::tuple<uint64_t, uint32_t, size_t>;
+
+    const database::const_ptr database_;
+    const double speed_;
+
+    /**
+     * Mutex used to protect the schedules and the generators, as filters may
+     * be changed while another thread receives.
+     */
+    std::mutex mutex_;
+
+    std::vector<schedule> schedules_;
+    size_t enabled_count_;
+    std::priority_queue<due_message, std::vector<due_message>, std::greater<>> queue_;
+    std::mt19937_64 random_;
+
+    /* realtime clock and steady clock at the first reception */
+    uint64_t epoch_ns_;
+    std::optional<clock::time_point> started_;
+
+    synthetic(database::const_ptr database, double speed, std::vector<schedule> schedules, uint64_t seed);
+
+    /**
+     * This method waits for the next frame to be due, at most `timeout_ms`.
+     * It returns `false` if it isn't due by then. While every message is
+     * filtered, it waits like on an idle bus.
+     * The mutex must be held through `lock`, it is released while sleeping.
+     */
+    bool wait_for_next(std::unique_lock<std::mutex>& lock, long timeout_ms);
+
+    /**
+     * This method generates the next frame and schedules its next cycle. The
+     * mutex must be held.
+     */
+    void generate(fd_frame& msg);
+
+    double next_value(generator& source);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_SYNTHETIC_HPP */
@@ -0,0 +1,123 @@
+#ifndef INCLUDE_CAN_DRIVER_VIRTUAL_CAN_HPP
+#define INCLUDE_CAN_DRIVER_VIRTUAL_CAN_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "can/transceiver.hpp"
+#include "can/utils/bounded_queue.hpp"
+
+namespace can::driver {
+
+/**
+ * Driver for in-process virtual CAN buses, registered as the "virtual" driver.
+ *
+ * Every transceiver created on the same interface name is attached to the same bus, which exists as long as one of
+ * them does. A transmitted frame is copied into the receive queue of every other transceiver of the bus, a lock-free
+ * queue filled by the transmitting threads, and is dropped for the transceivers whose queue is full or whose filter
+ * rejects it. Nothing leaves the process, so no privileges or kernel interfaces are needed.
+ *
+ * Without a bitrate, transmissions complete immediately and frames are timestamped with the realtime clock of the
+ * host. With a bitrate, each frame occupies the bus for its length on the wire, see `utils::wire`: transmissions are
+ * serialized on the bus and complete once the frame would have been sent. In virtual time, they complete immediately
+ * and frames are instead timestamped with the bus time, the sum of the durations of the frames sent so far, so runs
+ * are reproducible regardless of the load of the host.
+ *
+ * It accepts the following options:
+ *   - `loopback`: 1 to also receive the frames transmitted by the transceiver itself (0).
+ *   - `queue_size`: number of frames the receive queue holds, rounded up to a power of two (4096).
+ *   - `bitrate`: nominal bitrate of the bus in bit/s, 0 for no timing (0).
+ *   - `data_bitrate`: bitrate of the data phase of CAN FD frames switching bitrate (`bitrate`).
+ *   - `virtual_time`: 1 to timestamp frames with the bus time instead of waiting for them (0), requires a bitrate.
+ *     Frames then carry the `HW_TIMESTAMP` flag, their epoch being the creation of the bus.
+ *
+ * The timing options apply to the whole bus and are taken from the transceiver creating it, later transceivers
+ * asking for another time mode fail. `set_bitrate()` changes the bitrates of the bus.
+ */
+class virtual_can : public transceiver {
+   public:
+    static constexpr size_t DEFAULT_QUEUE_SIZE = 4096;
+
+    static std::list<std::string> list_interfaces();
+    static ptr create(const std::string& interface, const options& options = {});
+    ~virtual_can() override;
+
+    virtual_can(const virtual_can& other)            = delete;
+    virtual_can& operator=(const virtual_can& other) = delete;
+    virtual_can(virtual_can&& other)                 = delete;
+    virtual_can& operator=(virtual_can&& other)      = delete;
+
+    bool set_bitrate(unsigned long bitrate) override;
+    using transmitter::transmit;
+    bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
+
+    /**
+     * This method hands every frame of the batch to the bus at once when it
+     * has no timing, and transmits them one by one otherwise.
+     */
+    size_t transmit_batch(const frame_batch_view& batch) override;
+    frame::ptr receive(long timeout_ms = -1) override;
+    bool receive_into(fd_frame& msg, long timeout_ms = -1) override;
+    bool set_filter(const std::vector<uint32_t>& identifiers) override;
+    bool clear_filter() override;
+
+    /**
+     * This method returns the number of frames dropped because the receive
+     * queue was full.
+     */
+    [[nodiscard]] uint64_t get_overrun_count() const;
+
+   private:
+    struct bus;
+
+    const std::shared_ptr<bus> bus_;
+    const bool loopback_;
+    utils::bounded_queue<fd_frame> queue_;
+    std::atomic<uint64_t> overruns_;
+
+    /**
+     * Filter of the transceiver, sorted, protected by the mutex of the bus.
+     */
+    bool filtered_;
+    std::vector<uint32_t> filter_;
+
+    /**
+     * Mutex and condition used to wake up a receiving thread, only notified
+     * while it is waiting.
+     */
+    std::mutex wait_mutex_;
+    std::condition_variable wait_condition_;
+    std::atomic_bool waiting_;
+
+    virtual_can(std::shared_ptr<bus> bus, bool loopback, size_t queue_size);
+
+    /**
+     * This method timestamps a frame and copies it to the transceivers of the
+     * bus, after waiting for the bus if it has a bitrate.
+     */
+    void send(fd_frame& msg);
+
+    /**
+     * This method copies a frame to the transceivers of the bus. The mutex of
+     * the bus must be held, at least shared.
+     */
+    void deliver(const fd_frame& msg);
+
+    /**
+     * This method queues a frame received from the bus, dropping it if the
+     * queue is full or the filter rejects it.
+     */
+    void push(const fd_frame& msg);
+
+    bool wait_for_frames(long timeout_ms);
+};
+
+} /* namespace can::driver */
+
+#endif /* INCLUDE_CAN_DRIVER_VIRTUAL_CAN_HPP */
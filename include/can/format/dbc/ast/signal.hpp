@@ -9,12 +9,12 @@ class signal {
    public:
     using endian = can::database::signal::endian;
 
-    signal(std::string name, unsigned char start_bit, unsigned char bit_count, endian byte_order, bool is_signed,
+    signal(std::string name, unsigned short start_bit, unsigned char bit_count, endian byte_order, bool is_signed,
            float scale, float offset, float min, float max, std::string unit, std::vector<std::string> nodes,
            std::variant<bool, unsigned short> multiplexing);
 
     const std::string& get_name() const;
-    unsigned char get_start_bit() const;
+    unsigned short get_start_bit() const;
     unsigned char get_bit_count() const;
     endian get_byte_order() const;
     bool is_signed() const;
@@ -29,7 +29,7 @@ class signal {
    private:
     std::string name_;
 
-    unsigned char start_bit_;
+    unsigned short start_bit_;
     unsigned char bit_count_;
     endian byte_order_;
     bool is_signed_;
@@ -50,7 +50,7 @@ inline const std::string& signal::get_name() const {
     return name_;
 }
 
-inline unsigned char signal::get_start_bit() const {
+inline unsigned short signal::get_start_bit() const {
     return start_bit_;
 }
 
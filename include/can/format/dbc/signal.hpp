@@ -23,7 +23,7 @@ class signal : public can::database::signal, public object {
     /* inherited methods from can::database::signal */
 
     [[nodiscard]] const std::string& get_name() const override;
-    [[nodiscard]] unsigned char get_start_bit() const override;
+    [[nodiscard]] unsigned short get_start_bit() const override;
     [[nodiscard]] unsigned char get_bit_count() const override;
     [[nodiscard]] endian get_byte_order() const override;
     [[nodiscard]] bool is_integral() const override;
@@ -49,7 +49,7 @@ class signal : public can::database::signal, public object {
 
    private:
     std::string name_;
-    unsigned char start_bit_;
+    unsigned short start_bit_;
     unsigned char bit_count_;
     endian byte_order_;
     bool is_integral_;
@@ -68,7 +68,7 @@ inline const std::string& signal::get_name() const {
     return name_;
 }
 
-inline unsigned char signal::get_start_bit() const {
+inline unsigned short signal::get_start_bit() const {
     return start_bit_;
 }
 
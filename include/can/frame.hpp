@@ -1,26 +1,140 @@
 #ifndef INCLUDE_CAN_MESSAGE_HPP
 #define INCLUDE_CAN_MESSAGE_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <memory>
-
-#include "can/utils/array_delete.hpp"
+#include <optional>
+#include <type_traits>
+#include <vector>
 
 namespace can {
 
 struct frame {
-    using ptr = std::unique_ptr<frame, utils::array_delete<uint8_t>>;
+    /**
+     * Frames are carved from per-size-class pools when possible. This deleter
+     * returns the frame to the pool it came from, or frees it from the heap.
+     */
+    struct deleter {
+        void operator()(frame* ptr) const;
+    };
+
+    using ptr = std::unique_ptr<frame, deleter>;
+
+    /**
+     * Usage counters of a single frame pool size class.
+     */
+    struct pool_statistics {
+        size_t max_length_;
+        size_t capacity_;
+        uint64_t hits_;
+        uint64_t misses_;
+    };
+
+    /**
+     * Format flags of a frame, combined as a bit mask in `flags_`.
+     */
+    enum flag : uint8_t {
+        FD           = 0x01, /* CAN FD frame, up to 64 bytes of payload */
+        BRS          = 0x02, /* CAN FD bit rate switch */
+        ESI          = 0x04, /* CAN FD error state indicator */
+        HW_TIMESTAMP = 0x08, /* timestamp taken from the clock of the device */
+    };
 
     uint32_t identifier_;
+
+    /**
+     * Reception time in nanoseconds. It is measured against the realtime clock
+     * of the host (UNIX epoch), or against the clock of the device if the
+     * `HW_TIMESTAMP` flag is set, in which case the epoch is device specific.
+     */
     uint64_t timestamp_;
     size_t length_;
+    uint8_t flags_;
+
+    /**
+     * Index of the interface the frame was received from, or is to be
+     * transmitted through, for transceivers spanning several interfaces. It is
+     * driver specific (the ifindex for SocketCAN), and 0 when unspecified.
+     */
+    uint32_t interface_;
 
     /* NOLINTNEXTLINE(modernize-avoid-c-arrays): flexible array member */
     uint8_t bytes_[];
 
-    static ptr create(uint32_t identifier, size_t length, uint8_t* bytes, uint64_t timestamp = 0);
+    static ptr create(uint32_t identifier, size_t length, const uint8_t* bytes, uint64_t timestamp = 0,
+                      uint8_t flags = 0, uint32_t interface = 0);
+
+    /**
+     * This method returns the counters of every frame pool size class.
+     */
+    static std::vector<pool_statistics> get_pool_statistics();
 };
 
+/**
+ * Trivially copyable frame with an inline payload of fixed capacity. Unlike
+ * `frame`, it can live on the stack or by value in containers, so hot paths
+ * don't need any allocation.
+ */
+template <size_t Capacity>
+struct static_frame {
+    static constexpr size_t CAPACITY = Capacity;
+
+    uint32_t identifier_;
+    uint64_t timestamp_;
+    size_t length_;
+    uint8_t flags_;
+    uint32_t interface_;
+    std::array<uint8_t, Capacity> bytes_;
+
+    /**
+     * This method copies a heap frame into an inline frame. It fails if the
+     * payload doesn't fit in the capacity.
+     */
+    static std::optional<static_frame> from(const frame& frame);
+
+    /**
+     * This method copies the inline frame into a heap frame.
+     */
+    [[nodiscard]] frame::ptr to_ptr() const;
+};
+
+/**
+ * Inline frame large enough for any classic CAN frame.
+ */
+using classic_frame = static_frame<8>;
+
+/**
+ * Inline frame large enough for any CAN FD frame.
+ */
+using fd_frame = static_frame<64>;
+
+static_assert(std::is_trivially_copyable_v<classic_frame>);
+static_assert(std::is_trivially_copyable_v<fd_frame>);
+
+template <size_t Capacity>
+inline std::optional<static_frame<Capacity>> static_frame<Capacity>::from(const frame& frame) {
+    if (frame.length_ > Capacity) {
+        return {};
+    }
+
+    static_frame<Capacity> copy{};
+    copy.identifier_ = frame.identifier_;
+    copy.timestamp_  = frame.timestamp_;
+    copy.length_     = frame.length_;
+    copy.flags_      = frame.flags_;
+    copy.interface_  = frame.interface_;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): flexible array member */
+    std::copy(frame.bytes_, frame.bytes_ + frame.length_, copy.bytes_.begin());
+    return copy;
+}
+
+template <size_t Capacity>
+inline frame::ptr static_frame<Capacity>::to_ptr() const {
+    return frame::create(identifier_, length_, bytes_.data(), timestamp_, flags_, interface_);
+}
+
 } /* namespace can */
 
-#endif /* INCLUDE_CAN_MESSAGE_HPP */
\ No newline at end of file
+#endif /* INCLUDE_CAN_MESSAGE_HPP */
@@ -0,0 +1,280 @@
+#ifndef INCLUDE_CAN_FRAME_BATCH_HPP
+#define INCLUDE_CAN_FRAME_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+
+#include "can/frame.hpp"
+
+namespace can {
+
+/**
+ * Non-owning view over frames stored column-wise (structure of arrays).
+ *
+ * Each column is contiguous, so scanning identifiers or timestamps is a
+ * linear pass over a single array. Payloads are stored in a single block
+ * with a fixed stride per frame.
+ */
+class frame_batch_view {
+   public:
+    /**
+     * A single frame of the batch. The payload points into the batch storage.
+     */
+    struct entry {
+        uint32_t identifier_;
+        uint64_t timestamp_;
+        uint8_t flags_;
+        uint32_t interface_;
+        std::span<const uint8_t> bytes_;
+
+        /**
+         * This method copies the entry into a heap frame.
+         */
+        [[nodiscard]] frame::ptr to_ptr() const;
+    };
+
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = entry;
+        using pointer           = void;
+        using reference         = entry;
+
+        iterator() = default;
+        iterator(const frame_batch_view* view, size_t index);
+
+        entry operator*() const;
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==(const iterator& other) const = default;
+
+       private:
+        const frame_batch_view* view_ = nullptr;
+        size_t index_                 = 0;
+    };
+
+    frame_batch_view(const uint32_t* identifiers, const uint64_t* timestamps, const uint8_t* lengths,
+                     const uint8_t* flags, const uint32_t* interfaces, const uint8_t* bytes, size_t size,
+                     size_t stride);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t stride() const;
+
+    [[nodiscard]] iterator begin() const;
+    [[nodiscard]] iterator end() const;
+
+    /**
+     * This method returns the frame at the specified index.
+     */
+    [[nodiscard]] entry operator[](size_t index) const;
+
+    /**
+     * This method returns the identifier column.
+     */
+    [[nodiscard]] std::span<const uint32_t> get_identifiers() const;
+
+    /**
+     * This method returns the timestamp column.
+     */
+    [[nodiscard]] std::span<const uint64_t> get_timestamps() const;
+
+    /**
+     * This method returns the payload length column.
+     */
+    [[nodiscard]] std::span<const uint8_t> get_lengths() const;
+
+    /**
+     * This method returns the format flags column.
+     */
+    [[nodiscard]] std::span<const uint8_t> get_flags() const;
+
+    /**
+     * This method returns the interface column.
+     */
+    [[nodiscard]] std::span<const uint32_t> get_interfaces() const;
+
+    /**
+     * This method returns the payload of the frame at the specified index.
+     */
+    [[nodiscard]] std::span<const uint8_t> get_bytes(size_t index) const;
+
+    /**
+     * This method returns a view over the frames in [begin, end).
+     */
+    [[nodiscard]] frame_batch_view slice(size_t begin, size_t end) const;
+
+    /**
+     * This method returns the index of the first frame, starting at `from`, with
+     * the specified identifier. It returns `size()` if there is none.
+     */
+    [[nodiscard]] size_t find(uint32_t identifier, size_t from = 0) const;
+
+    /**
+     * This method returns the index of the first frame whose timestamp isn't
+     * before the specified timestamp. Frames must be ordered by timestamp.
+     */
+    [[nodiscard]] size_t lower_bound(uint64_t timestamp) const;
+
+   protected:
+    const uint32_t* identifiers_;
+    const uint64_t* timestamps_;
+    const uint8_t* lengths_;
+    const uint8_t* flags_;
+    const uint32_t* interfaces_;
+    const uint8_t* bytes_;
+    size_t size_;
+    size_t stride_;
+};
+
+/**
+ * Fixed-capacity container of frames stored column-wise in a single
+ * allocation. It is the unit exchanged by batched receives and bulk
+ * decoders, and it is never reallocated once created.
+ */
+class frame_batch : public frame_batch_view {
+   public:
+    static constexpr size_t CLASSIC_STRIDE = 8;
+    static constexpr size_t FD_STRIDE      = 64;
+
+    frame_batch(size_t capacity, size_t stride = CLASSIC_STRIDE);
+
+    frame_batch(const frame_batch& other)            = delete;
+    frame_batch& operator=(const frame_batch& other) = delete;
+    frame_batch(frame_batch&& other) noexcept;
+    frame_batch& operator=(frame_batch&& other) noexcept;
+    ~frame_batch() = default;
+
+    [[nodiscard]] size_t capacity() const;
+    [[nodiscard]] bool full() const;
+
+    /**
+     * This method removes all frames from the batch.
+     */
+    void clear();
+
+    /**
+     * This method appends a frame to the batch. It fails if the batch is full
+     * or if the payload is larger than the stride.
+     */
+    bool push_back(uint32_t identifier, size_t length, const uint8_t* bytes, uint64_t timestamp = 0,
+                   uint8_t flags = 0, uint32_t interface = 0);
+
+    /**
+     * This method appends a heap frame to the batch.
+     */
+    bool push_back(const frame& frame);
+
+   private:
+    /**
+     * Mutable pointers to the columns of the storage, the view only exposes
+     * them as constant.
+     */
+    struct columns {
+        uint32_t* identifiers_ = nullptr;
+        uint64_t* timestamps_  = nullptr;
+        uint8_t* lengths_      = nullptr;
+        uint8_t* flags_        = nullptr;
+        uint32_t* interfaces_  = nullptr;
+        uint8_t* bytes_        = nullptr;
+    };
+
+    /**
+     * This method detaches the batch from its storage, leaving it empty.
+     */
+    void release();
+
+    size_t capacity_;
+    columns columns_;
+
+    /* NOLINTNEXTLINE(modernize-avoid-c-arrays): single allocation for every column */
+    std::unique_ptr<std::byte[]> storage_;
+};
+
+inline size_t frame_batch_view::size() const {
+    return size_;
+}
+
+inline bool frame_batch_view::empty() const {
+    return size_ == 0;
+}
+
+inline size_t frame_batch_view::stride() const {
+    return stride_;
+}
+
+inline frame_batch_view::iterator frame_batch_view::begin() const {
+    return {this, 0};
+}
+
+inline frame_batch_view::iterator frame_batch_view::end() const {
+    return {this, size_};
+}
+
+inline std::span<const uint32_t> frame_batch_view::get_identifiers() const {
+    return {identifiers_, size_};
+}
+
+inline std::span<const uint64_t> frame_batch_view::get_timestamps() const {
+    return {timestamps_, size_};
+}
+
+inline std::span<const uint8_t> frame_batch_view::get_lengths() const {
+    return {lengths_, size_};
+}
+
+inline std::span<const uint8_t> frame_batch_view::get_flags() const {
+    return {flags_, size_};
+}
+
+inline std::span<const uint32_t> frame_batch_view::get_interfaces() const {
+    return {interfaces_, size_};
+}
+
+inline std::span<const uint8_t> frame_batch_view::get_bytes(size_t index) const {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): fixed stride payload block */
+    return {bytes_ + index * stride_, lengths_[index]};
+}
+
+inline frame_batch_view::entry frame_batch_view::operator[](size_t index) const {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): column access */
+    return {identifiers_[index], timestamps_[index], flags_[index], interfaces_[index], get_bytes(index)};
+}
+
+inline frame_batch_view::iterator::iterator(const frame_batch_view* view, size_t index)
+    : view_(view), index_(index) {}
+
+inline frame_batch_view::entry frame_batch_view::iterator::operator*() const {
+    return (*view_)[index_];
+}
+
+inline frame_batch_view::iterator& frame_batch_view::iterator::operator++() {
+    index_++;
+    return *this;
+}
+
+inline frame_batch_view::iterator frame_batch_view::iterator::operator++(int) {
+    auto copy = *this;
+    index_++;
+    return copy;
+}
+
+inline size_t frame_batch::capacity() const {
+    return capacity_;
+}
+
+inline bool frame_batch::full() const {
+    return size_ == capacity_;
+}
+
+inline void frame_batch::clear() {
+    size_ = 0;
+}
+
+} /* namespace can */
+
+#endif /* INCLUDE_CAN_FRAME_BATCH_HPP */
@@ -6,6 +6,8 @@
 #include <shared_mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "can/database.hpp"
 #include "can/frame.hpp"
@@ -20,6 +22,14 @@ class listener : public std::enable_shared_from_this<listener> {
     using callback = std::function<void(const frame::ptr&)>;
 
     listener();
+
+    /**
+     * This constructor creates a listener in reactor mode. Transceivers with a poll file descriptor are then serviced
+     * by `io_threads` shared threads, each waiting on an epoll set, instead of a producer thread each. Other
+     * transceivers still get their own producer thread. Reactor mode is only available under Linux.
+     */
+    explicit listener(unsigned int io_threads);
+
     ~listener();
 
     /**
@@ -27,6 +37,14 @@ class listener : public std::enable_shared_from_this<listener> {
      */
     quark start(utils::unique_owner_ptr<transceiver> transceiver);
 
+    /**
+     * This method attaches a new transceiver to the listener in busy-poll mode. Its thread spins on non-blocking
+     * receptions, pinned to `cpu` if specified, and calls the subscribers itself instead of handing frames over to
+     * the consumer thread. This trades a whole core for the lowest latency, and subscribers may then be called
+     * from several threads at once. CPU pinning is only available under Linux.
+     */
+    quark start_busy_poll(utils::unique_owner_ptr<transceiver> transceiver, std::optional<unsigned int> cpu = {});
+
     /**
      * This method shutdowns a single transceiver.
      */
@@ -64,6 +82,16 @@ class listener : public std::enable_shared_from_this<listener> {
      */
     subscriber_guard::ptr subscribe(callback callback, std::optional<unsigned int> identifier = {});
 
+    /**
+     * This method restricts subscribers of all frames to the messages of the database.
+     */
+    void restrict_to(const database& database);
+
+    /**
+     * This method lifts the restriction set by `restrict_to()`.
+     */
+    void unrestrict();
+
    private:
     /**
      * This class represents a subscriber to raw frames.
@@ -85,24 +113,78 @@ class listener : public std::enable_shared_from_this<listener> {
      */
     std::unordered_map<quark, subscriber> subscribers_;
 
+    /**
+     * The identifiers subscribers of all frames are restricted to, if any.
+     */
+    std::optional<std::unordered_set<unsigned int>> restriction_;
+
     /**
      * This method removes a subscriber from the listener.
      */
     void unsubscribe(quark quark);
 
     /**
-     * This class represents a thread in the listener (procuder or consumer).
+     * Mutex used to serialize filter updates, so that every transceiver ends up with the latest filter.
+     */
+    std::mutex filter_mutex_;
+
+    /**
+     * This method returns the identifiers the subscribers are interested in, or nothing if they need every frame.
+     */
+    std::optional<std::vector<uint32_t>> get_filter();
+
+    /**
+     * This method pushes the identifiers the subscribers are interested in down to every transceiver, so they can
+     * drop the other frames before they reach the listener. Filters are applied while the transceivers receive, see
+     * `receiver::set_filter()`.
+     */
+    void update_filters();
+
+    struct reactor;
+
+    /**
+     * This class represents a thread in the listener (procuder, busy-poll, reactor or consumer).
      */
     struct listener_thread {
         std::atomic_bool running_;
+        transceiver* const transceiver_;
         std::thread thread_;
 
+        template <typename Method, typename Class, typename... Args>
+        listener_thread(Method method, Class obj, utils::unique_owner_ptr<transceiver> transceiver, Args... args)
+            : running_(true),
+              transceiver_(transceiver.get()),
+              thread_(method, obj, this, std::move(transceiver), args...) {}
+
         template <typename Method, typename Class>
-        listener_thread(Method method, Class obj, utils::unique_owner_ptr<transceiver> transceiver)
-            : running_(true), thread_(method, obj, this, std::move(transceiver)) {}
+        listener_thread(Method method, Class obj, reactor* reactor)
+            : running_(true), transceiver_(nullptr), thread_(method, obj, this, reactor) {}
 
         template <typename Method, typename Class>
-        listener_thread(Method method, Class obj) : running_(true), thread_(method, obj, this) {}
+        listener_thread(Method method, Class obj) : running_(true), transceiver_(nullptr), thread_(method, obj, this) {}
+    };
+
+    /**
+     * This class represents an epoll set of transceivers, serviced by a single reactor thread.
+     */
+    struct reactor {
+        const int epoll_;
+
+        /**
+         * Mutex used to protect the transceiver list, held while receiving from them.
+         */
+        std::mutex mutex_;
+
+        std::unordered_map<quark, utils::unique_owner_ptr<transceiver>> transceivers_;
+        std::unique_ptr<listener_thread> thread_;
+
+        explicit reactor(int epoll);
+        ~reactor();
+
+        reactor(const reactor& other)            = delete;
+        reactor& operator=(const reactor& other) = delete;
+        reactor(reactor&& other)                 = delete;
+        reactor& operator=(reactor&& other)      = delete;
     };
 
     /**
@@ -111,25 +193,52 @@ class listener : public std::enable_shared_from_this<listener> {
     std::mutex transceiver_mutex_;
 
     /**
-     * The current list of producer (transceiver) threads.
+     * The current list of producer and busy-poll (transceiver) threads.
      */
     std::unordered_map<quark, listener_thread> producer_threads_;
 
     /**
-     * The single consumer thread.
+     * The reactors of the listener, empty unless it is in reactor mode.
      */
-    listener_thread consumer_thread_;
+    std::vector<std::unique_ptr<reactor>> reactors_;
 
     /**
      * The queue of frames that the consumer needs to consume.
      */
     utils::blocking_queue<frame::ptr> frames_;
 
+    /**
+     * The single consumer thread, started once the queue it consumes is constructed.
+     */
+    listener_thread consumer_thread_;
+
     /**
      * The thread function of a producer thread.
      */
     void producer_thread_function(listener_thread* thread, utils::unique_owner_ptr<transceiver> transceiver);
 
+    /**
+     * The thread function of a busy-poll thread.
+     */
+    void busy_poll_thread_function(listener_thread* thread, utils::unique_owner_ptr<transceiver> transceiver,
+                                   std::optional<unsigned int> cpu);
+
+    /**
+     * The thread function of a reactor thread.
+     */
+    void reactor_thread_function(listener_thread* thread, reactor* reactor);
+
+    /**
+     * This method registers a transceiver in the least loaded reactor. It leaves the transceiver untouched and
+     * returns false if it can't be registered.
+     */
+    bool attach_to_reactor(quark quark, utils::unique_owner_ptr<transceiver>& transceiver);
+
+    /**
+     * This method unregisters and frees a transceiver from its reactor. It returns false if no reactor owns it.
+     */
+    bool detach_from_reactor(quark quark);
+
     /**
      * The thread function of the consumer thread.
      */
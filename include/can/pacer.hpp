@@ -0,0 +1,97 @@
+#ifndef INCLUDE_CAN_PACER_HPP
+#define INCLUDE_CAN_PACER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "can/frame.hpp"
+#include "can/transceiver.hpp"
+
+namespace can {
+
+/**
+ * Transmitter decorator shaping the bus load caused by its transmissions.
+ *
+ * The time each frame occupies the bus is computed from its length on the
+ * wire, stuff bits included, and the bitrates of the bus. Transmissions are
+ * then delayed so this bus time stays below a share of the elapsed time, using
+ * a token bucket refilled with bus time at the target load. The bucket holds
+ * `burst` of bus time, which may be sent back to back after an idle period.
+ *
+ * Transmissions are serialized and block while the load is above the target.
+ */
+class pacer : public transmitter {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::microseconds DEFAULT_BURST{1000};
+
+    /**
+     * Counters of a pacer, since its first transmission.
+     */
+    struct statistics {
+        uint64_t frames_;      /* frames accepted by the wrapped transmitter */
+        uint64_t bits_;        /* bits of these frames on the wire, stuff bits included */
+        uint64_t bus_time_ns_; /* time these frames occupied the bus */
+        uint64_t elapsed_ns_;  /* time elapsed since the first transmission */
+        double load_;          /* achieved bus load in percent, bus time over elapsed time */
+    };
+
+    /**
+     * This method wraps a transmitter on a bus of the specified bitrate,
+     * pacing its transmissions to `load` percent of the bus. The data bitrate
+     * applies to the data phase of CAN FD frames switching bitrate, and
+     * defaults to the nominal bitrate. It returns `nullptr` if the load or the
+     * bitrates are invalid.
+     */
+    static std::shared_ptr<pacer> create(std::shared_ptr<transmitter> transmitter, unsigned long bitrate, double load,
+                                         unsigned long data_bitrate = 0,
+                                         std::chrono::nanoseconds burst = DEFAULT_BURST);
+
+    using transmitter::transmit;
+    bool transmit(frame::ptr msg) override;
+    bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                  uint32_t interface = 0) override;
+
+    /**
+     * This method returns the counters of the pacer.
+     */
+    statistics get_statistics();
+
+   private:
+    const std::shared_ptr<transmitter> transmitter_;
+    const unsigned long bitrate_;
+    const unsigned long data_bitrate_;
+    const double load_;
+    const double capacity_ns_;
+
+    /**
+     * Mutex used to protect the bucket and the counters, held during the
+     * transmissions to serialize them.
+     */
+    std::mutex mutex_;
+    double tokens_ns_;
+    clock::time_point refilled_;
+    std::optional<clock::time_point> started_;
+    statistics statistics_;
+
+    pacer(std::shared_ptr<transmitter> transmitter, unsigned long bitrate, double load, unsigned long data_bitrate,
+          std::chrono::nanoseconds burst);
+
+    /**
+     * This method waits for the bucket to hold tokens again, then takes the
+     * bus time of a frame from it.
+     */
+    void acquire(uint64_t bus_time_ns);
+
+    void refill(clock::time_point now);
+
+    void account(bool transmitted, uint64_t bits, uint64_t bus_time_ns);
+};
+
+} /* namespace can */
+
+#endif /* INCLUDE_CAN_PACER_HPP */
@@ -0,0 +1,128 @@
+#ifndef INCLUDE_CAN_SCHEDULER_HPP
+#define INCLUDE_CAN_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "can/frame.hpp"
+#include "can/transceiver.hpp"
+
+namespace can {
+
+/**
+ * Transmitter decorator ordering pending frames like bus arbitration does.
+ *
+ * Frames are queued by the scheduler and handed one at a time to the wrapped
+ * transmitter by a dispatch thread, lowest identifier first and in call order
+ * for equal identifiers. As the driver is never given more than a single frame
+ * ahead, an urgent frame only waits for the frames already queued in the
+ * driver, which should be kept shallow (e.g. the `sndbuf` option of
+ * socketcan).
+ *
+ * Transmissions are asynchronous: they succeed once the frame is queued, and
+ * the outcome of each frame is only reported by the statistics.
+ */
+class scheduler : public transmitter {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    /**
+     * Counters of a scheduler.
+     */
+    struct statistics {
+        size_t pending_;       /* frames queued in the scheduler */
+        uint64_t transmitted_; /* frames accepted by the wrapped transmitter */
+        uint64_t failed_;      /* frames refused by the wrapped transmitter */
+        uint64_t expired_;     /* frames dropped because their deadline passed before they were dispatched */
+        uint64_t rejected_;    /* frames refused because the scheduler was full */
+    };
+
+    /**
+     * This constructor wraps a transmitter, queuing at most `capacity` frames.
+     */
+    explicit scheduler(std::shared_ptr<transmitter> transmitter, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * This destructor stops the dispatch thread, dropping the frames still queued.
+     */
+    ~scheduler() override;
+
+    scheduler(const scheduler& other)            = delete;
+    scheduler& operator=(const scheduler& other) = delete;
+    scheduler(scheduler&& other)                 = delete;
+    scheduler& operator=(scheduler&& other)      = delete;
+
+    using transmitter::transmit;
+
+    /**
+     * This method queues a frame without deadline.
+     */
+    bool transmit(frame::ptr msg) override;
+
+    /**
+     * This method queues a frame which is dropped if it isn't dispatched to
+     * the wrapped transmitter before `deadline`.
+     */
+    bool transmit(frame::ptr msg, clock::time_point deadline);
+
+    /**
+     * This method waits at most `timeout_ms` for every queued frame to be
+     * dispatched. It returns false if some frames are still queued.
+     */
+    bool flush(long timeout_ms = -1);
+
+    /**
+     * This method returns the counters of the scheduler.
+     */
+    statistics get_statistics();
+
+   private:
+    /**
+     * A queued frame, ordered by identifier and then by sequence number.
+     */
+    using key = std::pair<uint32_t, uint64_t>;
+
+    struct pending_frame {
+        frame::ptr frame_;
+        std::optional<clock::time_point> deadline_;
+    };
+
+    const std::shared_ptr<transmitter> transmitter_;
+    const size_t capacity_;
+
+    /**
+     * Mutex used to protect the queue and the counters.
+     */
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::map<key, pending_frame> pending_;
+    uint64_t sequence_;
+    bool dispatching_;
+    bool running_;
+    statistics statistics_;
+
+    /**
+     * The dispatch thread, started once the queue is constructed.
+     */
+    std::thread thread_;
+
+    bool enqueue(frame::ptr msg, std::optional<clock::time_point> deadline);
+
+    /**
+     * The thread function of the dispatch thread.
+     */
+    void dispatch_thread_function();
+};
+
+} /* namespace can */
+
+#endif /* INCLUDE_CAN_SCHEDULER_HPP */
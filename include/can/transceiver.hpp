@@ -4,9 +4,12 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "can/frame.hpp"
+#include "can/frame_batch.hpp"
 #include "can/utils/unique_owner_ptr.hpp"
 
 namespace can {
@@ -15,12 +18,91 @@ class transmitter {
    public:
     virtual ~transmitter()                = default;
     virtual bool transmit(frame::ptr msg) = 0;
+
+    /**
+     * This method transmits a frame given by its fields, so callers don't need
+     * to allocate one. The interface only matters to drivers bound to several
+     * interfaces.
+     *
+     * The default implementation copies it into a heap frame, drivers should
+     * override it to fill their native frame directly.
+     */
+    virtual bool transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags = 0,
+                          uint32_t interface = 0);
+
+    /**
+     * These methods transmit an inline frame, without any allocation if the
+     * driver overrides the transmission of frame fields.
+     */
+    bool transmit(const fd_frame& msg);
+    bool transmit(const classic_frame& msg);
+
+    /**
+     * This method transmits the frames of the batch in order. It stops at the
+     * first frame that can't be transmitted and returns the number of frames
+     * transmitted before it.
+     *
+     * The default implementation transmits the frames one by one, drivers
+     * should override it to hand several frames at once to the system.
+     */
+    virtual size_t transmit_batch(const frame_batch_view& batch);
 };
 
 class receiver {
    public:
     virtual ~receiver()                              = default;
     virtual frame::ptr receive(long timeout_ms = -1) = 0;
+
+    /**
+     * This method receives a frame into a frame owned by the caller, so polling
+     * loops don't need any allocation. It returns false if no frame was
+     * received, in which case the content of the frame is unspecified.
+     *
+     * The default implementation copies the frame returned by `receive()`,
+     * drivers should override it to fill the frame from their native frame.
+     */
+    virtual bool receive_into(fd_frame& msg, long timeout_ms = -1);
+
+    /**
+     * This method appends received frames to the batch until it is full or no
+     * more frames are immediately available, waiting at most `timeout_ms` for
+     * the first one. It returns the number of appended frames.
+     *
+     * The default implementation waits for a frame with `receive_into()`,
+     * then takes the frames it returns without waiting until the batch is
+     * full. Drivers should override it to drain several frames per system
+     * call.
+     */
+    virtual size_t receive_batch(frame_batch& batch, long timeout_ms = -1);
+
+    /**
+     * This method restricts reception to frames with one of the specified
+     * identifiers, letting the driver drop other frames before they are copied
+     * to user space. An empty list rejects every frame.
+     *
+     * The default implementation doesn't filter and returns false, callers must
+     * still expect frames with other identifiers.
+     *
+     * The listener calls it from the thread changing the subscriptions, while
+     * another thread may be receiving. Drivers must make it safe against a
+     * concurrent reception, which may still return frames accepted by the
+     * previous filter.
+     */
+    virtual bool set_filter(const std::vector<uint32_t>& identifiers);
+
+    /**
+     * This method removes the filter installed by `set_filter()`. It must be
+     * safe against a concurrent reception as well.
+     */
+    virtual bool clear_filter();
+
+    /**
+     * This method returns a file descriptor that becomes readable (level
+     * triggered) while frames are available, so several receivers can be
+     * waited on at once with poll() or epoll. It returns -1 if the driver
+     * can't be waited on this way, which is the default.
+     */
+    [[nodiscard]] virtual int get_poll_fd() const;
 };
 
 class transceiver : public transmitter, public receiver {
@@ -39,8 +121,13 @@ class transceiver : public transmitter, public receiver {
         std::shared_ptr<transceiver> transmitter_;
     };
 
+    /**
+     * Driver specific options, given as key/value pairs when creating a transceiver.
+     */
+    using options = std::map<std::string, std::string>;
+
     static std::map<std::string, std::list<std::string>> list_interfaces();
-    static ptr create(const std::string& driver, const std::string& interface);
+    static ptr create(const std::string& driver, const std::string& interface, const options& options = {});
 
     virtual ~transceiver()                          = default;
     virtual bool set_bitrate(unsigned long bitrate) = 0;
@@ -29,6 +29,19 @@ class blocking_queue {
         condition_.notify_one();
     }
 
+    /**
+     * This method pushes every value of the container at once, waking up the
+     * consumer a single time.
+     */
+    template <typename Values>
+    void push_all(Values&& values) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (auto& value : values) {
+            queue_.push(std::move(value));
+        }
+        condition_.notify_one();
+    }
+
     T pop() {
         std::unique_lock<std::mutex> lock(mutex_);
         condition_.wait(lock, [&]() { return !queue_.empty(); });
@@ -0,0 +1,134 @@
+#ifndef INCLUDE_CAN_UTILS_BOUNDED_QUEUE_HPP
+#define INCLUDE_CAN_UTILS_BOUNDED_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace can::utils {
+
+/**
+ * Fixed-capacity lock-free queue, for any number of producers and consumers.
+ *
+ * Each cell carries a sequence number telling whether it is free for the
+ * producer at a given position or holds a value for the consumer at that
+ * position, so producers and consumers only contend on their own position
+ * counter. The capacity is rounded up to a power of two.
+ *
+ * When the queue is full, `try_push()` fails instead of waiting, and when it
+ * is empty, so does `try_pop()`.
+ */
+template <typename T>
+class bounded_queue {
+   public:
+    explicit bounded_queue(size_t capacity)
+        : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), cells_(new cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; i++) {
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~bounded_queue() = default;
+
+    bounded_queue(const bounded_queue& other)            = delete;
+    bounded_queue& operator=(const bounded_queue& other) = delete;
+    bounded_queue(bounded_queue&& other)                 = delete;
+    bounded_queue& operator=(bounded_queue&& other)      = delete;
+
+    /**
+     * This method appends a copy of the value. It returns `false` if the queue
+     * is full.
+     */
+    bool try_push(const T& value) {
+        size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        cell* target    = nullptr;
+
+        while (true) {
+            target              = &cells_[position & mask_];
+            const auto sequence = target->sequence_.load(std::memory_order_acquire);
+            const auto distance = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (distance == 0) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (distance < 0) {
+                /* the cell still holds the value pushed a lap earlier */
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        target->value_ = value;
+        target->sequence_.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * This method removes the oldest value. It returns `false` if the queue is
+     * empty.
+     */
+    bool try_pop(T& value) {
+        size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        cell* source    = nullptr;
+
+        while (true) {
+            source              = &cells_[position & mask_];
+            const auto sequence = source->sequence_.load(std::memory_order_acquire);
+            const auto distance = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (distance == 0) {
+                if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (distance < 0) {
+                /* the cell wasn't written yet */
+                return false;
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = source->value_;
+        source->sequence_.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * This method returns whether the queue was empty at the time of the call.
+     */
+    [[nodiscard]] bool empty() const {
+        const size_t position = dequeue_position_.load(std::memory_order_acquire);
+        const auto sequence   = cells_[position & mask_].sequence_.load(std::memory_order_acquire);
+        return sequence != position + 1;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return mask_ + 1;
+    }
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct cell {
+        std::atomic<size_t> sequence_;
+        T value_;
+    };
+
+    const size_t mask_;
+
+    /* NOLINTNEXTLINE(modernize-avoid-c-arrays): cells are never reallocated */
+    const std::unique_ptr<cell[]> cells_;
+
+    /* both positions get a cache line of their own, so producers and consumers don't share it */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_position_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_position_ = 0;
+};
+
+} /* namespace can::utils */
+
+#endif /* INCLUDE_CAN_UTILS_BOUNDED_QUEUE_HPP */
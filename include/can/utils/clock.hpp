@@ -0,0 +1,114 @@
+#ifndef INCLUDE_CAN_UTILS_CLOCK_HPP
+#define INCLUDE_CAN_UTILS_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace can::utils {
+
+/*
+ * Remaining time under which waiting for a deadline spins instead of
+ * sleeping, as sleeps may overshoot by the scheduler latency.
+ */
+static constexpr std::chrono::microseconds SPIN_THRESHOLD{100};
+
+/*
+ * Interval at which a blocking wait for a frame checks again while there is
+ * nothing to receive, as the filter may change meanwhile.
+ */
+static constexpr std::chrono::milliseconds IDLE_INTERVAL(100);
+
+/**
+ * State of the next frame of a source generating frames on a schedule.
+ */
+enum class next_state {
+    /* the next frame is known, along with the time it's due */
+    DUE,
+    /* nothing can be received for now, like on an idle bus */
+    IDLE,
+    /* nothing will ever be received */
+    OVER,
+};
+
+/**
+ * This function returns the realtime clock in nanoseconds since the epoch,
+ * the time base of frame timestamps.
+ */
+static inline uint64_t get_realtime_ns() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+/**
+ * This function sleeps until shortly before the deadline, then spins until it
+ * is reached. It returns the time at which the deadline was observed.
+ */
+static inline std::chrono::steady_clock::time_point wait_until(std::chrono::steady_clock::time_point deadline) {
+    auto now = std::chrono::steady_clock::now();
+    if (deadline - now > SPIN_THRESHOLD) {
+        std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+    }
+
+    while ((now = std::chrono::steady_clock::now()) < deadline) {
+        /* spin for the last microseconds */
+    }
+
+    return now;
+}
+
+/**
+ * This function waits for the next frame of a scheduled source to be due, at
+ * most `timeout_ms`, or forever if it's negative. The state of the next frame
+ * is given by `next(due)`, called with the mutex held through `lock`, which
+ * is released while sleeping. It returns `false` if no frame is due by then,
+ * or at once if no frame will ever be received and there is no timeout.
+ */
+template <typename Next>
+static inline bool wait_for_due(std::unique_lock<std::mutex>& lock, long timeout_ms, Next next) {
+    using clock = std::chrono::steady_clock;
+
+    std::optional<clock::time_point> deadline;
+    if (timeout_ms >= 0) {
+        deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    auto sleep_until = [&lock](clock::time_point time) {
+        lock.unlock();
+        std::this_thread::sleep_until(time);
+        lock.lock();
+    };
+
+    /* the next frame may change while sleeping, in which case it is waited for instead */
+    while (true) {
+        clock::time_point due;
+        auto state = next(due);
+
+        if (state == next_state::OVER) {
+            if (deadline.has_value()) {
+                sleep_until(deadline.value());
+            }
+
+            return false;
+        }
+
+        if (state == next_state::IDLE) {
+            due = clock::now() + IDLE_INTERVAL;
+        } else if (due <= clock::now()) {
+            return true;
+        }
+
+        if (deadline.has_value() && deadline.value() < due) {
+            sleep_until(deadline.value());
+            return false;
+        }
+
+        sleep_until(due);
+    }
+}
+
+} /* namespace can::utils */
+
+#endif /* INCLUDE_CAN_UTILS_CLOCK_HPP */
@@ -0,0 +1,48 @@
+#ifndef INCLUDE_CAN_UTILS_DLC_HPP
+#define INCLUDE_CAN_UTILS_DLC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace can::utils::dlc {
+
+/*
+ * Payload lengths encoded by each Data Length Code (DLC). Classic CAN frames
+ * only use codes up to 8, CAN FD frames use the whole table.
+ */
+static constexpr std::array<uint8_t, 16> DLC_TO_LENGTH = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+static constexpr uint8_t MAX_DLC = 15;
+
+/**
+ * This function returns the payload length encoded by a DLC.
+ */
+static inline constexpr size_t to_length(uint8_t dlc) {
+    return DLC_TO_LENGTH.at((dlc > MAX_DLC) ? MAX_DLC : dlc);
+}
+
+/**
+ * This function returns the smallest DLC whose payload can hold the
+ * specified length. Lengths above 64 bytes are cropped.
+ */
+static inline constexpr uint8_t from_length(size_t length) {
+    for (uint8_t dlc = 0; dlc < MAX_DLC; dlc++) {
+        if (DLC_TO_LENGTH.at(dlc) >= length) {
+            return dlc;
+        }
+    }
+
+    return MAX_DLC;
+}
+
+/**
+ * This function returns the length, padded to the next valid CAN FD payload length.
+ */
+static inline constexpr size_t pad_length(size_t length) {
+    return to_length(from_length(length));
+}
+
+} /* namespace can::utils::dlc */
+
+#endif /* INCLUDE_CAN_UTILS_DLC_HPP */
@@ -0,0 +1,206 @@
+#ifndef INCLUDE_CAN_UTILS_HEX_HPP
+#define INCLUDE_CAN_UTILS_HEX_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace can::utils::hex {
+
+static constexpr std::array<char, 16> DIGITS = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                                '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+namespace detail {
+
+/*
+ * Constants of the word-wide decoder, repeated in each byte of a 64-bit word.
+ */
+static constexpr uint64_t ONES      = 0x0101010101010101;
+static constexpr uint64_t HIGH_BITS = 0x8080808080808080;
+static constexpr uint64_t LOW_BITS  = 0x0F0F0F0F0F0F0F0F;
+static constexpr uint64_t CASE_BIT  = 0x2020202020202020;
+static constexpr uint64_t EVEN      = 0x00FF00FF00FF00FF;
+static constexpr uint64_t EVEN_HALF = 0x0000FFFF0000FFFF;
+static constexpr uint64_t LOW_HALF  = 0x00000000FFFFFFFF;
+
+static constexpr size_t WORD_DIGITS         = 8;
+static constexpr size_t WORD_BYTES          = WORD_DIGITS / 2;
+static constexpr unsigned int LETTER_OFFSET = 9;
+
+/*
+ * Loads 8 digits into a word, the first digit in the lowest byte.
+ */
+static inline constexpr uint64_t load_word(const char* text) {
+    uint64_t word = 0;
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+        std::memcpy(&word, text, sizeof(word));
+        return word;
+    }
+
+    for (size_t i = 0; i < WORD_DIGITS; i++) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+        word |= static_cast<uint64_t>(static_cast<uint8_t>(text[i])) << (8U * i);
+    }
+
+    return word;
+}
+
+/*
+ * Stores the 4 bytes packed in the low half of a word, the first byte in the lowest byte.
+ */
+static inline constexpr void store_word(uint64_t packed, uint8_t* bytes) {
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+        const auto half = static_cast<uint32_t>(packed);
+        std::memcpy(bytes, &half, sizeof(half));
+        return;
+    }
+
+    for (size_t i = 0; i < WORD_BYTES; i++) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+        bytes[i] = static_cast<uint8_t>(packed >> (8U * i));
+    }
+}
+
+/*
+ * Returns the high bit of each byte of `word` whose value is in [low, high], for bytes below 0x80.
+ */
+static inline constexpr uint64_t in_range(uint64_t word, uint8_t low, uint8_t high) {
+    const uint64_t above_low  = word + ONES * (0x80U - low);
+    const uint64_t above_high = word + ONES * (0x80U - high - 1U);
+    return above_low & ~above_high & HIGH_BITS;
+}
+
+/*
+ * Decodes the 8 digits of a word, loaded with the first digit in the lowest byte, into 4 bytes. It returns false if
+ * any of them isn't a hexadecimal digit.
+ */
+static inline constexpr bool decode_word(uint64_t word, uint8_t* bytes) {
+    if ((word & HIGH_BITS) != 0) {
+        return false;
+    }
+
+    /* letters are folded to lower case, digits already have the case bit */
+    const uint64_t digits  = in_range(word, '0', '9');
+    const uint64_t letters = in_range(word | CASE_BIT, 'a', 'f');
+    if ((digits | letters) != HIGH_BITS) {
+        return false;
+    }
+
+    /* both digits and letters have their value, minus 9 for letters, in their low bits */
+    const uint64_t nibbles = (word & LOW_BITS) + (letters >> 7U) * LETTER_OFFSET;
+
+    /* each pair of digits forms a 16 bit lane holding a byte, the lanes are then packed together */
+    uint64_t packed = ((nibbles & EVEN) << 4U) | ((nibbles >> 8U) & EVEN);
+    packed          = (packed | (packed >> 8U)) & EVEN_HALF;
+    packed          = (packed | (packed >> 16U)) & LOW_HALF;
+
+    store_word(packed, bytes);
+    return true;
+}
+
+} /* namespace detail */
+
+/**
+ * This function returns the value of a hexadecimal digit, in upper or lower
+ * case, or -1 if the character isn't one.
+ */
+static inline constexpr int decode_digit(char digit) {
+    if (digit >= '0' && digit <= '9') {
+        return digit - '0';
+    }
+
+    if (digit >= 'A' && digit <= 'F') {
+        return digit - 'A' + 10;
+    }
+
+    if (digit >= 'a' && digit <= 'f') {
+        return digit - 'a' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ * This function decodes `count` digits into an integer, most significant
+ * digit first. It returns false if any of them isn't a hexadecimal digit.
+ */
+template <typename T>
+static inline constexpr bool decode_integer(const char* text, size_t count, T& value) {
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+        const int digit = decode_digit(text[i]);
+        if (digit < 0) {
+            return false;
+        }
+
+        value = static_cast<T>((value << 4U) | static_cast<T>(digit));
+    }
+
+    return true;
+}
+
+/**
+ * This function decodes `2 * length` digits into `length` bytes. It returns
+ * false if any of them isn't a hexadecimal digit, leaving the bytes partially
+ * written.
+ *
+ * Digits are decoded 8 at a time within a 64-bit word, without a branch per
+ * digit, which is an order of magnitude faster than decoding them one by one
+ * on the long payloads of CAN FD frames.
+ */
+static inline constexpr bool decode(const char* text, size_t length, uint8_t* bytes) {
+    size_t i = 0;
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+    for (; i + detail::WORD_BYTES <= length; i += detail::WORD_BYTES) {
+        if (!detail::decode_word(detail::load_word(text + 2 * i), bytes + i)) {
+            return false;
+        }
+    }
+
+    for (; i < length; i++) {
+        const int high = decode_digit(text[2 * i]);
+        const int low  = decode_digit(text[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+
+        bytes[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+    return true;
+}
+
+/**
+ * This function encodes `length` bytes into `2 * length` upper case digits.
+ */
+static inline constexpr void encode(const uint8_t* bytes, size_t length, char* text) {
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+    for (size_t i = 0; i < length; i++) {
+        text[2 * i]     = DIGITS.at(bytes[i] >> 4U);
+        text[2 * i + 1] = DIGITS.at(bytes[i] & 0x0FU);
+    }
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+}
+
+/**
+ * This function encodes an integer into `count` upper case digits, most
+ * significant digit first.
+ */
+template <typename T>
+static inline constexpr void encode_integer(T value, size_t count, char* text) {
+    for (size_t i = count; i > 0; i--) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): caller bounds */
+        text[i - 1] = DIGITS.at(static_cast<size_t>(value & 0x0FU));
+        value       = static_cast<T>(value >> 4U);
+    }
+}
+
+} /* namespace can::utils::hex */
+
+#endif /* INCLUDE_CAN_UTILS_HEX_HPP */
@@ -0,0 +1,71 @@
+#ifndef INCLUDE_CAN_UTILS_OPTIONS_HPP
+#define INCLUDE_CAN_UTILS_OPTIONS_HPP
+
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace can::utils {
+
+/**
+ * This function parses the integral option `key` of a driver, or returns
+ * `fallback` if the option isn't given. It returns nothing if the option
+ * isn't a valid number for the type.
+ */
+template <typename T>
+static inline std::optional<T> get_integral_option(const std::map<std::string, std::string>& options,
+                                                   const std::string& key, T fallback) {
+    static_assert(std::is_integral_v<T>);
+
+    auto it = options.find(key);
+    if (it == options.end()) {
+        return fallback;
+    }
+
+    const auto& text = it->second;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): string bounds */
+    const char* end = text.data() + text.size();
+
+    T value{};
+    auto [ptr, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+/**
+ * This function parses the floating point option `key` of a driver, or
+ * returns `fallback` if the option isn't given. It returns nothing if the
+ * option isn't a finite number.
+ */
+template <typename T>
+static inline std::optional<T> get_floating_option(const std::map<std::string, std::string>& options,
+                                                   const std::string& key, T fallback) {
+    static_assert(std::is_floating_point_v<T>);
+
+    auto it = options.find(key);
+    if (it == options.end()) {
+        return fallback;
+    }
+
+    const auto& text = it->second;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): string bounds */
+    const char* end = text.data() + text.size();
+
+    T value{};
+    auto [ptr, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc() || ptr != end || !std::isfinite(value)) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+} /* namespace can::utils */
+
+#endif /* INCLUDE_CAN_UTILS_OPTIONS_HPP */
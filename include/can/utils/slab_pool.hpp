@@ -0,0 +1,113 @@
+#ifndef INCLUDE_CAN_UTILS_SLAB_POOL_HPP
+#define INCLUDE_CAN_UTILS_SLAB_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace can::utils {
+
+/**
+ * Fixed-capacity pool of equally sized blocks carved from a single slab.
+ *
+ * Free blocks are kept in a lock-free stack, so any thread may allocate or
+ * release blocks concurrently. The stack head is tagged with a counter to
+ * avoid the ABA problem, and the links are stored outside of the blocks so
+ * a stale read never touches memory handed to a user.
+ *
+ * When the pool is exhausted, `allocate()` returns `nullptr` and the caller
+ * is expected to fall back to the heap.
+ */
+class slab_pool {
+   public:
+    slab_pool(size_t block_size, uint32_t block_count);
+    ~slab_pool() = default;
+
+    slab_pool(const slab_pool& other)            = delete;
+    slab_pool& operator=(const slab_pool& other) = delete;
+    slab_pool(slab_pool&& other)                 = delete;
+    slab_pool& operator=(slab_pool&& other)      = delete;
+
+    /**
+     * This method returns a free block, or `nullptr` if the pool is exhausted.
+     */
+    [[nodiscard]] void* allocate();
+
+    /**
+     * This method returns a block to the pool. It returns `false` if the block
+     * wasn't allocated from this pool.
+     */
+    bool release(void* ptr);
+
+    /**
+     * This method returns whether the block was allocated from this pool.
+     */
+    [[nodiscard]] bool owns(const void* ptr) const;
+
+    /**
+     * This method returns the size, in bytes, of a single block.
+     */
+    [[nodiscard]] size_t get_block_size() const;
+
+    /**
+     * This method returns the number of blocks in the slab.
+     */
+    [[nodiscard]] uint32_t get_block_count() const;
+
+    /**
+     * This method returns the number of allocations served by the pool.
+     */
+    [[nodiscard]] uint64_t get_hits() const;
+
+    /**
+     * This method returns the number of allocations that found the pool exhausted.
+     */
+    [[nodiscard]] uint64_t get_misses() const;
+
+   private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    const size_t block_size_;
+    const uint32_t block_count_;
+
+    /* NOLINTNEXTLINE(modernize-avoid-c-arrays): raw storage */
+    std::unique_ptr<std::byte[]> slab_;
+    /* NOLINTNEXTLINE(modernize-avoid-c-arrays): one link per block */
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+
+    /**
+     * The head of the free stack, packed as the ABA tag (upper 32 bits)
+     * and the index of the first free block (lower 32 bits).
+     */
+    std::atomic<uint64_t> head_;
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+inline bool slab_pool::owns(const void* ptr) const {
+    const auto* byte = static_cast<const std::byte*>(ptr);
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): slab bounds */
+    return (byte >= slab_.get()) && (byte < slab_.get() + block_size_ * block_count_);
+}
+
+inline size_t slab_pool::get_block_size() const {
+    return block_size_;
+}
+
+inline uint32_t slab_pool::get_block_count() const {
+    return block_count_;
+}
+
+inline uint64_t slab_pool::get_hits() const {
+    return hits_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t slab_pool::get_misses() const {
+    return misses_.load(std::memory_order_relaxed);
+}
+
+} /* namespace can::utils */
+
+#endif /* INCLUDE_CAN_UTILS_SLAB_POOL_HPP */
@@ -0,0 +1,161 @@
+#ifndef INCLUDE_CAN_UTILS_WIRE_HPP
+#define INCLUDE_CAN_UTILS_WIRE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "can/frame.hpp"
+#include "can/utils/dlc.hpp"
+
+namespace can::utils::wire {
+
+/*
+ * Bits following the CRC sequence: CRC delimiter, ACK slot and delimiter, end
+ * of frame and intermission.
+ */
+static constexpr size_t TAIL_BITS = 13;
+
+static constexpr size_t IDENTIFIER_BITS    = 11;
+static constexpr size_t DLC_BITS           = 4;
+static constexpr size_t BYTE_BITS          = 8;
+static constexpr size_t STUFF_RUN_LENGTH   = 5;
+static constexpr size_t FD_CRC_SHORT_BYTES = 16;
+
+static constexpr uint16_t CRC15_POLYNOMIAL = 0x4599;
+static constexpr uint16_t CRC15_MASK       = 0x7FFF;
+static constexpr size_t CRC15_BITS         = 15;
+static constexpr size_t CRC17_BITS         = 17;
+static constexpr size_t CRC21_BITS         = 21;
+
+/*
+ * The stuff count field of CAN FD frames, a 3 bit Gray code and its parity.
+ * It is followed by the CRC, both with a fixed stuff bit every 4 bits.
+ */
+static constexpr size_t FD_STUFF_COUNT_BITS     = 4;
+static constexpr size_t FD_FIXED_STUFF_INTERVAL = 4;
+
+static constexpr uint64_t SEC_TO_NSEC = 1000000000;
+
+/**
+ * Length of a frame on the wire, split between the bits sent at the nominal
+ * bitrate and the bits of the data phase of CAN FD frames switching bitrate.
+ */
+struct frame_bits {
+    size_t nominal_;
+    size_t data_;
+};
+
+/**
+ * Writer of the stuffed part of a frame, counting each bit along with the
+ * stuff bits inserted after five consecutive bits of the same level. Classic
+ * frames also feed their bits to the CRC, as stuffing extends to it.
+ */
+class stuffed_writer {
+   public:
+    void write(bool bit, size_t& phase_bits) {
+        phase_bits++;
+        crc_ = next_crc(crc_, bit);
+
+        run_  = (run_ > 0 && bit == last_) ? run_ + 1 : 1;
+        last_ = bit;
+
+        if (run_ == STUFF_RUN_LENGTH) {
+            /* the stuff bit has the opposite level and starts the next run */
+            phase_bits++;
+            last_ = !bit;
+            run_  = 1;
+        }
+    }
+
+    void write(uint32_t value, size_t count, size_t& phase_bits) {
+        for (size_t i = count; i > 0; i--) {
+            write(((value >> (i - 1)) & 1U) != 0, phase_bits);
+        }
+    }
+
+    /**
+     * This method writes the CRC computed so far, stuffed like the rest of the frame.
+     */
+    void write_crc(size_t& phase_bits) {
+        const uint16_t crc = crc_;
+        write(crc, CRC15_BITS, phase_bits);
+    }
+
+   private:
+    uint16_t crc_ = 0;
+    size_t run_   = 0;
+    bool last_    = false;
+
+    static uint16_t next_crc(uint16_t crc, bool bit) {
+        const bool feedback = bit != (((crc >> (CRC15_BITS - 1)) & 1U) != 0);
+        crc                 = (crc << 1U) & CRC15_MASK;
+        return feedback ? (crc ^ CRC15_POLYNOMIAL) : crc;
+    }
+};
+
+/**
+ * This function returns the length of a data frame with a standard identifier on the wire, stuff bits included.
+ * The payload of CAN FD frames is padded with zeros to the next valid length.
+ */
+static inline frame_bits count_bits(uint32_t identifier, size_t length, const uint8_t* bytes, uint8_t flags) {
+    const bool fd  = (flags & frame::FD) != 0;
+    const bool brs = fd && (flags & frame::BRS) != 0;
+
+    frame_bits bits{.nominal_ = 0, .data_ = 0};
+    size_t& data_bits = brs ? bits.data_ : bits.nominal_;
+
+    stuffed_writer writer;
+    const uint8_t dlc = dlc::from_length(length);
+
+    /* arbitration and control fields: SOF, identifier, RTR/RRS, IDE */
+    writer.write(false, bits.nominal_);
+    writer.write(identifier, IDENTIFIER_BITS, bits.nominal_);
+    writer.write(false, bits.nominal_);
+    writer.write(false, bits.nominal_);
+
+    if (fd) {
+        /* FDF, reserved bit and BRS, the bitrate switches at the sample point of BRS */
+        writer.write(true, bits.nominal_);
+        writer.write(false, bits.nominal_);
+        writer.write(brs, bits.nominal_);
+        writer.write((flags & frame::ESI) != 0, data_bits);
+    } else {
+        /* reserved bit */
+        writer.write(false, bits.nominal_);
+    }
+
+    writer.write(dlc, DLC_BITS, data_bits);
+
+    const size_t padded = fd ? dlc::to_length(dlc) : length;
+    for (size_t i = 0; i < padded; i++) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): raw payload */
+        writer.write((i < length) ? bytes[i] : 0, BYTE_BITS, data_bits);
+    }
+
+    if (fd) {
+        /* the stuff count and the CRC have fixed stuff bits, before the stuff count and then every 4 bits */
+        const size_t crc_bits = (padded > FD_CRC_SHORT_BYTES) ? CRC21_BITS : CRC17_BITS;
+        data_bits += FD_STUFF_COUNT_BITS + crc_bits + 1 + (FD_STUFF_COUNT_BITS + crc_bits) / FD_FIXED_STUFF_INTERVAL;
+    } else {
+        writer.write_crc(bits.nominal_);
+    }
+
+    bits.nominal_ += TAIL_BITS;
+    return bits;
+}
+
+/**
+ * This function returns the time a frame occupies the bus in nanoseconds. The data bitrate only applies to CAN FD
+ * frames switching bitrate, and defaults to the nominal bitrate.
+ */
+static inline uint64_t get_duration_ns(const frame_bits& bits, unsigned long bitrate, unsigned long data_bitrate = 0) {
+    if (data_bitrate == 0) {
+        data_bitrate = bitrate;
+    }
+
+    return (bits.nominal_ * SEC_TO_NSEC) / bitrate + (bits.data_ * SEC_TO_NSEC) / data_bitrate;
+}
+
+} /* namespace can::utils::wire */
+
+#endif /* INCLUDE_CAN_UTILS_WIRE_HPP */
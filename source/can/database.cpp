@@ -1,5 +1,7 @@
 #include "can/database.hpp"
 #include <math.h>
+#include <algorithm>
+#include <cmath>
 #include "can/format/dbc/database.hpp"
 #include "can/log.hpp"
 
@@ -13,13 +15,20 @@ quark database::signal::get_quark() const {
     return quark_;
 }
 
-uint64_t database::signal::extract(uint8_t* bytes, size_t length) const {
-    const auto bit_count = get_bit_count();
-    const auto start_bit = get_start_bit();
-    const auto end_bit   = start_bit + bit_count;
+uint64_t database::signal::extract(const uint8_t* bytes, size_t length) const {
+    constexpr unsigned int MAX_BIT_COUNT = 64;
+
+    const unsigned int bit_count = get_bit_count();
+    const unsigned int start_bit = get_start_bit();
+    const unsigned int end_bit   = start_bit + bit_count;
+
+    if (bit_count == 0 || bit_count > MAX_BIT_COUNT) {
+        logger->error("invalid bit count of {} for signal '{}'", bit_count, get_name());
+        return 0;
+    }
 
     const auto byte_start = start_bit / 8U;
-    const auto byte_end   = end_bit / 8U;
+    const auto byte_end   = (end_bit - 1) / 8U;
 
     if (byte_end >= length) {
         logger->error("frame of {} byte{} is too small to decode signal '{}'", length, (length > 1) ? "s" : "",
@@ -29,19 +38,20 @@ uint64_t database::signal::extract(uint8_t* bytes, size_t length) const {
 
     /* TODO: add support for big-endian packed message */
 
-    unsigned int bit_packed = 0;
-    unsigned long value     = 0;
-    for (auto i = byte_start; i < byte_end + 1; i++) {
-        if (i == byte_start) {
-            value |= bytes[i] >> (start_bit - 8 * byte_start);
-            bit_packed += (8 * byte_end - start_bit);
-        } else {
-            value |= bytes[i] << bit_packed;
-            bit_packed += 8;
-        }
+    const unsigned int bit_offset = start_bit - 8U * byte_start;
+
+    uint64_t value          = bytes[byte_start] >> bit_offset;
+    unsigned int bit_packed = 8U - bit_offset;
+    for (auto i = byte_start + 1; i <= byte_end; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << bit_packed;
+        bit_packed += 8U;
+    }
+
+    if (bit_count < MAX_BIT_COUNT) {
+        value &= (uint64_t{1} << bit_count) - 1;
     }
 
-    return value & ((1 << bit_count) - 1);
+    return value;
 }
 
 float database::signal::decode(uint64_t raw_value) const {
@@ -51,6 +61,71 @@ float database::signal::decode(uint64_t raw_value) const {
     return (static_cast<float>(raw_value) * scale) + offset;
 }
 
+void database::signal::insert(uint64_t raw_value, uint8_t* bytes, size_t length) const {
+    constexpr unsigned int MAX_BIT_COUNT = 64;
+
+    const unsigned int bit_count = get_bit_count();
+    const unsigned int start_bit = get_start_bit();
+    const unsigned int end_bit   = start_bit + bit_count;
+
+    if (bit_count == 0 || bit_count > MAX_BIT_COUNT) {
+        logger->error("invalid bit count of {} for signal '{}'", bit_count, get_name());
+        return;
+    }
+
+    if ((end_bit - 1) / 8U >= length) {
+        logger->error("frame of {} byte{} is too small to encode signal '{}'", length, (length > 1) ? "s" : "",
+                      get_name());
+        return;
+    }
+
+    /* big-endian signals are not decoded either, do not write bits the decoder would misread */
+    if (get_byte_order() == endian::BIG) {
+        logger->error("big-endian signal '{}' cannot be encoded", get_name());
+        return;
+    }
+
+    unsigned int bit       = start_bit;
+    unsigned int remaining = bit_count;
+    while (remaining > 0) {
+        const unsigned int shift = bit % 8U;
+        const unsigned int count = std::min(remaining, 8U - shift);
+        const auto mask          = static_cast<uint8_t>(((1U << count) - 1U) << shift);
+
+        bytes[bit / 8U] = (bytes[bit / 8U] & ~mask) | (static_cast<uint8_t>(raw_value << shift) & mask);
+
+        raw_value >>= count;
+        bit += count;
+        remaining -= count;
+    }
+}
+
+uint64_t database::signal::encode(float value) const {
+    constexpr int MAX_BIT_COUNT = 64;
+
+    const double scale = get_scale();
+    if (scale == 0) {
+        return 0;
+    }
+
+    const int bit_count = get_bit_count();
+    const double raw    = std::round((static_cast<double>(value) - get_offset()) / scale);
+
+    if (is_signed()) {
+        const double limit   = std::ldexp(1.0, bit_count - 1);
+        const auto clamped   = static_cast<int64_t>(std::clamp(raw, -limit, std::nextafter(limit, 0.0)));
+        const auto raw_value = static_cast<uint64_t>(clamped);
+        return (bit_count < MAX_BIT_COUNT) ? (raw_value & ((uint64_t{1} << bit_count) - 1)) : raw_value;
+    }
+
+    const double limit = std::ldexp(1.0, bit_count);
+    if (raw >= limit - 1) {
+        return (bit_count < MAX_BIT_COUNT) ? (uint64_t{1} << bit_count) - 1 : UINT64_MAX;
+    }
+
+    return static_cast<uint64_t>(std::max(raw, 0.0));
+}
+
 bool database::signal::is_multiplexer() const {
     auto multiplexing = get_multiplexing();
 
@@ -80,7 +155,7 @@ quark database::message::get_quark() const {
     return quark_;
 }
 
-std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::message::extract(uint8_t* bytes,
+std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::message::extract(const uint8_t* bytes,
                                                                                          size_t length) const {
     if (get_byte_count() < length) {
         logger->warn("frame of {} byte{} is too small to decode message '{}'", length, (length > 1) ? "s" : "",
@@ -130,7 +205,7 @@ std::vector<std::pair<database::signal::const_ptr, uint64_t>> database::message:
     return raw_values;
 }
 
-std::vector<std::pair<database::signal::const_ptr, float>> database::message::decode(uint8_t* bytes,
+std::vector<std::pair<database::signal::const_ptr, float>> database::message::decode(const uint8_t* bytes,
                                                                                      size_t length) const {
     std::vector<std::pair<signal::const_ptr, float>> decoded_values;
 
@@ -143,7 +218,7 @@ std::vector<std::pair<database::signal::const_ptr, float>> database::message::de
 }
 
 std::vector<std::pair<database::signal::const_ptr, std::variant<float, std::string>>> database::message::resolve(
-    uint8_t* bytes, size_t length) const {
+    const uint8_t* bytes, size_t length) const {
     std::vector<std::pair<signal::const_ptr, std::variant<float, std::string>>> resolved_values;
 
     auto raw_values = extract(bytes, length);
@@ -0,0 +1,269 @@
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <set>
+#include <utility>
+
+#include "can/driver/bpf_filter.hpp"
+#include "can/log.hpp"
+
+namespace can::driver {
+
+/*
+ * Offsets of the fields in the frames handed to the program, which share the
+ * layout of `can_frame` and `canfd_frame`.
+ */
+static constexpr uint32_t IDENTIFIER_OFFSET = offsetof(canfd_frame, can_id);
+static constexpr uint32_t LENGTH_OFFSET     = offsetof(canfd_frame, len);
+static constexpr uint32_t DATA_OFFSET       = offsetof(canfd_frame, data);
+
+static constexpr uint32_t ACCEPT = std::numeric_limits<uint32_t>::max();
+static constexpr uint32_t REJECT = 0;
+
+static constexpr uint8_t BITS_PER_BYTE = 8;
+
+struct bpf_filter::node {
+    enum class kind { IDENTIFIER, LENGTH, BYTE, AND, OR, NOT };
+
+    kind kind_;
+    uint32_t value_                    = 0;
+    uint32_t mask_                     = 0;
+    uint8_t index_                     = 0;
+    std::shared_ptr<const node> left_  = nullptr;
+    std::shared_ptr<const node> right_ = nullptr;
+};
+
+/*
+ * Classic BPF only has forward conditional jumps with 8-bit offsets, so the
+ * program is generated with symbolic jump targets that are resolved once
+ * every instruction is emitted. Conditional jumps whose targets turn out to
+ * be too far are generated again through unconditional jumps, which have
+ * 32-bit offsets.
+ */
+class program_builder {
+   public:
+    using label = size_t;
+
+    explicit program_builder(std::set<size_t> long_jumps) : long_jumps_(std::move(long_jumps)) {}
+
+    label create_label() {
+        labels_.push_back(NO_TARGET);
+        return labels_.size() - 1;
+    }
+
+    void bind(label label) {
+        labels_.at(label) = instructions_.size();
+    }
+
+    void emit(uint16_t code, uint32_t k) {
+        instructions_.push_back({BPF_STMT(code, k), NO_TARGET, NO_TARGET, NO_TARGET});
+    }
+
+    void emit_jump(uint16_t code, uint32_t k, label on_true, label on_false);
+
+    void generate(const bpf_filter::node& node, label on_true, label on_false);
+
+    /**
+     * This method resolves the jump targets. It returns the conditional jumps
+     * whose targets are too far, in which case the program is unusable.
+     */
+    std::set<size_t> resolve(std::vector<sock_filter>& program) const;
+
+   private:
+    static constexpr size_t NO_TARGET = std::numeric_limits<size_t>::max();
+
+    struct instruction {
+        sock_filter filter_;
+        label on_true_;
+        label on_false_;
+        size_t jump_;
+    };
+
+    const std::set<size_t> long_jumps_;
+    size_t jump_count_ = 0;
+
+    std::vector<instruction> instructions_;
+    std::vector<size_t> labels_;
+
+    [[nodiscard]] std::optional<size_t> get_offset(size_t position, label label) const;
+};
+
+void program_builder::emit_jump(uint16_t code, uint32_t k, label on_true, label on_false) {
+    const size_t jump = jump_count_++;
+
+    if (!long_jumps_.contains(jump)) {
+        instructions_.push_back({BPF_JUMP(code, k, 0, 0), on_true, on_false, jump});
+        return;
+    }
+
+    instructions_.push_back({BPF_JUMP(code, k, 0, 1), NO_TARGET, NO_TARGET, NO_TARGET});
+    instructions_.push_back({BPF_STMT(BPF_JMP | BPF_JA, 0), on_true, NO_TARGET, NO_TARGET});
+    instructions_.push_back({BPF_STMT(BPF_JMP | BPF_JA, 0), on_false, NO_TARGET, NO_TARGET});
+}
+
+void program_builder::generate(const bpf_filter::node& node, label on_true, label on_false) {
+    using kind = bpf_filter::node::kind;
+
+    switch (node.kind_) {
+        case kind::IDENTIFIER:
+            /* words are loaded in network order while `can_id` is stored in host order */
+            emit(BPF_LD | BPF_W | BPF_ABS, IDENTIFIER_OFFSET);
+            emit(BPF_ALU | BPF_AND | BPF_K, htonl(node.mask_));
+            emit_jump(BPF_JMP | BPF_JEQ | BPF_K, htonl(node.value_ & node.mask_), on_true, on_false);
+            break;
+
+        case kind::LENGTH:
+            emit(BPF_LD | BPF_B | BPF_ABS, LENGTH_OFFSET);
+            emit_jump(BPF_JMP | BPF_JEQ | BPF_K, node.value_, on_true, on_false);
+            break;
+
+        case kind::BYTE: {
+            /* loading past the end of the frame would abort the whole program */
+            label in_bounds = create_label();
+            emit(BPF_LD | BPF_B | BPF_ABS, LENGTH_OFFSET);
+            emit_jump(BPF_JMP | BPF_JGT | BPF_K, node.index_, in_bounds, on_false);
+            bind(in_bounds);
+            emit(BPF_LD | BPF_B | BPF_ABS, DATA_OFFSET + node.index_);
+            emit(BPF_ALU | BPF_AND | BPF_K, node.mask_);
+            emit_jump(BPF_JMP | BPF_JEQ | BPF_K, node.value_ & node.mask_, on_true, on_false);
+            break;
+        }
+
+        case kind::AND: {
+            label right = create_label();
+            generate(*node.left_, right, on_false);
+            bind(right);
+            generate(*node.right_, on_true, on_false);
+            break;
+        }
+
+        case kind::OR: {
+            label right = create_label();
+            generate(*node.left_, on_true, right);
+            bind(right);
+            generate(*node.right_, on_true, on_false);
+            break;
+        }
+
+        case kind::NOT:
+            generate(*node.left_, on_false, on_true);
+            break;
+    }
+}
+
+std::optional<size_t> program_builder::get_offset(size_t position, label label) const {
+    size_t target = labels_.at(label);
+    if (target <= position) {
+        return std::nullopt;
+    }
+
+    return target - position - 1;
+}
+
+std::set<size_t> program_builder::resolve(std::vector<sock_filter>& program) const {
+    constexpr size_t MAX_CONDITIONAL_OFFSET = std::numeric_limits<uint8_t>::max();
+
+    std::set<size_t> far_jumps;
+    program.clear();
+    program.reserve(instructions_.size());
+
+    for (size_t position = 0; position < instructions_.size(); position++) {
+        const auto& instruction = instructions_.at(position);
+        sock_filter filter      = instruction.filter_;
+
+        if (instruction.jump_ != NO_TARGET) {
+            auto on_true  = get_offset(position, instruction.on_true_);
+            auto on_false = get_offset(position, instruction.on_false_);
+            if (on_true.value_or(0) > MAX_CONDITIONAL_OFFSET || on_false.value_or(0) > MAX_CONDITIONAL_OFFSET) {
+                far_jumps.insert(instruction.jump_);
+            }
+
+            filter.jt = static_cast<uint8_t>(on_true.value_or(0));
+            filter.jf = static_cast<uint8_t>(on_false.value_or(0));
+        } else if (instruction.on_true_ != NO_TARGET) {
+            filter.k = static_cast<uint32_t>(get_offset(position, instruction.on_true_).value_or(0));
+        }
+
+        program.push_back(filter);
+    }
+
+    return far_jumps;
+}
+
+/* bpf_filter class */
+
+bpf_filter::bpf_filter(std::shared_ptr<const node> node) : node_(std::move(node)) {}
+
+bpf_filter bpf_filter::identifier(uint32_t identifier, uint32_t mask) {
+    return bpf_filter(
+        std::make_shared<const node>(node{.kind_ = node::kind::IDENTIFIER, .value_ = identifier, .mask_ = mask}));
+}
+
+bpf_filter bpf_filter::length(uint8_t length) {
+    return bpf_filter(std::make_shared<const node>(node{.kind_ = node::kind::LENGTH, .value_ = length}));
+}
+
+bpf_filter bpf_filter::byte(uint8_t index, uint8_t value, uint8_t mask) {
+    return bpf_filter(std::make_shared<const node>(
+        node{.kind_ = node::kind::BYTE, .value_ = value, .mask_ = mask, .index_ = index}));
+}
+
+bpf_filter bpf_filter::bit(uint16_t index, bool value) {
+    const auto byte_index = static_cast<uint8_t>(std::min<uint16_t>(index / BITS_PER_BYTE, UINT8_MAX));
+    const auto mask       = static_cast<uint8_t>(1U << (index % BITS_PER_BYTE));
+    return byte(byte_index, value ? mask : 0, mask);
+}
+
+bpf_filter operator&&(const bpf_filter& lhs, const bpf_filter& rhs) {
+    using node = bpf_filter::node;
+    return bpf_filter(
+        std::make_shared<const node>(node{.kind_ = node::kind::AND, .left_ = lhs.node_, .right_ = rhs.node_}));
+}
+
+bpf_filter operator||(const bpf_filter& lhs, const bpf_filter& rhs) {
+    using node = bpf_filter::node;
+    return bpf_filter(
+        std::make_shared<const node>(node{.kind_ = node::kind::OR, .left_ = lhs.node_, .right_ = rhs.node_}));
+}
+
+bpf_filter operator!(const bpf_filter& operand) {
+    using node = bpf_filter::node;
+    return bpf_filter(std::make_shared<const node>(node{.kind_ = node::kind::NOT, .left_ = operand.node_}));
+}
+
+std::vector<sock_filter> bpf_filter::compile() const {
+    std::vector<sock_filter> program;
+    std::set<size_t> long_jumps;
+
+    /* every pass only turns more jumps into long ones, so this terminates */
+    while (true) {
+        program_builder builder(long_jumps);
+
+        auto accept = builder.create_label();
+        auto reject = builder.create_label();
+
+        builder.generate(*node_, accept, reject);
+        builder.bind(accept);
+        builder.emit(BPF_RET | BPF_K, ACCEPT);
+        builder.bind(reject);
+        builder.emit(BPF_RET | BPF_K, REJECT);
+
+        auto far_jumps = builder.resolve(program);
+        if (far_jumps.empty()) {
+            break;
+        }
+
+        long_jumps.merge(far_jumps);
+    }
+
+    if (program.size() > BPF_MAXINSNS) {
+        logger->error("filter program is too large ({} instructions)", program.size());
+        return {};
+    }
+
+    return program;
+}
+
+} /* namespace can::driver */
@@ -10,6 +10,8 @@
 
 namespace can::driver {
 
+static constexpr uint64_t USEC_TO_NSEC = 1000;
+
 static const std::map<candle_err_t, std::string> ERROR_TO_STRING = {
     {CANDLE_ERR_OK, "CANDLE_ERR_OK"},
     {CANDLE_ERR_CREATE_FILE, "CANDLE_ERR_CREATE_FILE"},
@@ -78,7 +80,7 @@ candle_list_scan_failed:
     return {};
 }
 
-candlelight::ptr candlelight::create(const std::string& device) {
+candlelight::ptr candlelight::create(const std::string& device, const options& /* options */) {
     uint8_t device_id              = 0;
     candle_list_handle handle_list = nullptr;
     candle_handle handle           = nullptr;
@@ -153,17 +155,26 @@ bool candlelight::set_bitrate(unsigned long bitrate) {
 }
 
 bool candlelight::transmit(frame::ptr msg) {
-    if (msg->length_ > MAX_DLC) {
-        logger->error("unsupported message length of '{}'", msg->length_);
+    return transmit(msg->identifier_, {msg->bytes_, msg->length_}, msg->flags_, msg->interface_);
+}
+
+bool candlelight::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags,
+                           uint32_t /* interface */) {
+    if (bytes.size() > MAX_DLC) {
+        logger->error("unsupported message length of '{}'", bytes.size());
+        return false;
+    }
+
+    if ((flags & frame::FD) != 0) {
+        logger->error("CAN FD frames are not supported");
         return false;
     }
 
     candle_frame_t frame{};
-    frame.can_id  = msg->identifier_;
-    frame.can_dlc = msg->length_;
+    frame.can_id  = identifier;
+    frame.can_dlc = bytes.size();
     frame.flags   = 0;
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library function */
-    std::copy(msg->bytes_, msg->bytes_ + msg->length_, frame.data);
+    std::copy(bytes.begin(), bytes.end(), frame.data);
 
     if (!candle_frame_send(handle_, 0, &frame)) {
         logger->error("could not send frame: {}", get_error(handle_));
@@ -187,7 +198,8 @@ frame::ptr candlelight::receive(long timeout_ms) {
         }
     }
 
-    return frame::create(frame.can_id, frame.can_dlc, frame.data, frame.timestamp_us);
+    return frame::create(frame.can_id, frame.can_dlc, frame.data, uint64_t{frame.timestamp_us} * USEC_TO_NSEC,
+                         frame::HW_TIMESTAMP);
 }
 
 } /* namespace can::driver */
\ No newline at end of file
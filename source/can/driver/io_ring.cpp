@@ -0,0 +1,604 @@
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+#include "can/driver/io_ring.hpp"
+#include "can/log.hpp"
+#include "can/utils/options.hpp"
+
+namespace can::driver {
+
+static constexpr uint32_t DEFAULT_BUFFER_COUNT = 256;
+static constexpr uint32_t MAX_BUFFER_COUNT     = 1U << 15U;
+static constexpr uint16_t BUFFER_GROUP         = 0;
+
+/*
+ * The receive queue only ever holds the multishot request, while every
+ * received frame needs a completion.
+ */
+static constexpr uint32_t RECEIVE_ENTRIES = 4;
+
+/*
+ * Receive buffers hold the header written by the kernel, the source address,
+ * the control messages and then the frame. The control messages have room for
+ * the SO_TIMESTAMPING stamps, the largest ones the socket may deliver, and for
+ * the SO_RXQ_OVFL drop counter.
+ */
+static constexpr size_t CONTROL_SIZE = CMSG_SPACE(sizeof(timespec) * 3) + CMSG_SPACE(sizeof(uint32_t));
+static constexpr size_t BUFFER_SIZE =
+    sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_can) + CONTROL_SIZE + sizeof(canfd_frame);
+
+static constexpr long MSEC_TO_NSEC = 1000000;
+static constexpr long SEC_TO_MSEC  = 1000;
+
+/*
+ * Returns the time left before the deadline in milliseconds, or -1 to wait
+ * forever without a deadline.
+ */
+static long get_remaining_ms(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    if (!deadline.has_value()) {
+        return -1;
+    }
+
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline.value() - std::chrono::steady_clock::now());
+    return std::max<long>(remaining.count(), 0);
+}
+
+static int uring_setup(uint32_t entries, io_uring_params* params) {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg): no wrapper in the C library */
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, const void* arg,
+                       size_t size) {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg): no wrapper in the C library */
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, size));
+}
+
+static int uring_register(int fd, uint32_t opcode, const void* arg, uint32_t count) {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg): no wrapper in the C library */
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/*
+ * Queue indices are shared with the kernel, which only reads and writes them
+ * atomically.
+ */
+static std::atomic_ref<uint32_t> get_index(uint32_t* index) {
+    return std::atomic_ref<uint32_t>(*index);
+}
+
+/* io_ring::queue struct */
+
+/*
+ * The submission and completion queues of an io_uring instance, mapped from
+ * the kernel. Only the owner of the queue submits and consumes completions.
+ */
+struct io_ring::queue {
+    int fd_        = -1;
+    void* ring_    = MAP_FAILED;
+    size_t size_   = 0;
+    void* entries_ = MAP_FAILED;
+    size_t count_  = 0;
+
+    uint32_t* sq_head_      = nullptr;
+    uint32_t* sq_tail_      = nullptr;
+    uint32_t* sq_array_     = nullptr;
+    uint32_t sq_mask_       = 0;
+    uint32_t sq_local_tail_ = 0;
+    uint32_t* cq_head_      = nullptr;
+    uint32_t* cq_tail_      = nullptr;
+    io_uring_cqe* cqes_     = nullptr;
+    uint32_t cq_mask_       = 0;
+
+    static std::unique_ptr<queue> create(uint32_t entries, uint32_t completions);
+
+    queue() = default;
+    ~queue();
+
+    queue(const queue& other)            = delete;
+    queue& operator=(const queue& other) = delete;
+    queue(queue&& other)                 = delete;
+    queue& operator=(queue&& other)      = delete;
+
+    /**
+     * This method returns a cleared submission entry, or `nullptr` if the
+     * submission queue is full.
+     */
+    io_uring_sqe* get_sqe();
+
+    /**
+     * This method hands the prepared submission entries over to the kernel,
+     * along with the entries left over by a failed submission.
+     */
+    bool submit();
+
+    /**
+     * This method waits at most `timeout_ms` for a completion. It returns
+     * false if none is available.
+     */
+    bool wait(long timeout_ms);
+
+    /**
+     * This method returns the next completion, or `nullptr` if there is none.
+     */
+    io_uring_cqe* peek();
+
+    /**
+     * This method consumes the completion returned by `peek()`.
+     */
+    void advance();
+};
+
+std::unique_ptr<io_ring::queue> io_ring::queue::create(uint32_t entries, uint32_t completions) {
+    constexpr uint32_t REQUIRED_FEATURES = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG;
+
+    io_uring_params params{};
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = completions;
+
+    auto result = std::make_unique<queue>();
+
+    result->fd_ = uring_setup(entries, &params);
+    if (result->fd_ < 0) {
+        logger->error("could not create io_uring instance: {}", strerror(errno));
+        return nullptr;
+    }
+
+    if ((params.features & REQUIRED_FEATURES) != REQUIRED_FEATURES) {
+        logger->error("io_uring instance lacks required features");
+        return nullptr;
+    }
+
+    /* both queues share a single mapping */
+    result->size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                             params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    result->ring_ = mmap(nullptr, result->size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, result->fd_,
+                         IORING_OFF_SQ_RING);
+    if (result->ring_ == MAP_FAILED) {
+        logger->error("could not map io_uring queues: {}", strerror(errno));
+        return nullptr;
+    }
+
+    result->count_   = params.sq_entries * sizeof(io_uring_sqe);
+    result->entries_ = mmap(nullptr, result->count_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, result->fd_,
+                            IORING_OFF_SQES);
+    if (result->entries_ == MAP_FAILED) {
+        logger->error("could not map io_uring submission entries: {}", strerror(errno));
+        return nullptr;
+    }
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+    auto* ring        = static_cast<uint8_t*>(result->ring_);
+    result->sq_head_  = reinterpret_cast<uint32_t*>(ring + params.sq_off.head);
+    result->sq_tail_  = reinterpret_cast<uint32_t*>(ring + params.sq_off.tail);
+    result->sq_array_ = reinterpret_cast<uint32_t*>(ring + params.sq_off.array);
+    result->sq_mask_  = *reinterpret_cast<uint32_t*>(ring + params.sq_off.ring_mask);
+    result->cq_head_  = reinterpret_cast<uint32_t*>(ring + params.cq_off.head);
+    result->cq_tail_  = reinterpret_cast<uint32_t*>(ring + params.cq_off.tail);
+    result->cqes_     = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+    result->cq_mask_  = *reinterpret_cast<uint32_t*>(ring + params.cq_off.ring_mask);
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+    result->sq_local_tail_ = *result->sq_tail_;
+
+    return result;
+}
+
+io_ring::queue::~queue() {
+    if (entries_ != MAP_FAILED && munmap(entries_, count_) < 0) {
+        logger->error("could not unmap io_uring submission entries: {}", strerror(errno));
+    }
+
+    if (ring_ != MAP_FAILED && munmap(ring_, size_) < 0) {
+        logger->error("could not unmap io_uring queues: {}", strerror(errno));
+    }
+
+    if (fd_ >= 0 && close(fd_) < 0) {
+        logger->error("could not close io_uring instance: {}", strerror(errno));
+    }
+}
+
+io_uring_sqe* io_ring::queue::get_sqe() {
+    const uint32_t head = get_index(sq_head_).load(std::memory_order_acquire);
+    if (sq_local_tail_ - head > sq_mask_) {
+        return nullptr;
+    }
+
+    const uint32_t index = sq_local_tail_ & sq_mask_;
+    sq_local_tail_++;
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): mapped kernel arrays */
+    sq_array_[index]  = index;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(entries_) + index;
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+    *sqe = {};
+    return sqe;
+}
+
+bool io_ring::queue::submit() {
+    get_index(sq_tail_).store(sq_local_tail_, std::memory_order_release);
+
+    /* entries published by a failed submission are only consumed by the next one */
+    uint32_t count = sq_local_tail_ - get_index(sq_head_).load(std::memory_order_acquire);
+
+    while (count > 0) {
+        int submitted = uring_enter(fd_, count, 0, 0, nullptr, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            logger->error("could not submit io_uring requests: {}", strerror(errno));
+            return false;
+        }
+
+        count -= static_cast<uint32_t>(submitted);
+    }
+
+    return true;
+}
+
+bool io_ring::queue::wait(long timeout_ms) {
+    while (peek() == nullptr) {
+        __kernel_timespec ts{.tv_sec = timeout_ms / SEC_TO_MSEC, .tv_nsec = (timeout_ms % SEC_TO_MSEC) * MSEC_TO_NSEC};
+
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<uint64_t>(&ts); /* NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) */
+
+        int result = (timeout_ms < 0)
+                         ? uring_enter(fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0)
+                         : uring_enter(fd_, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno != ETIME) {
+                logger->error("could not wait for io_uring completions: {}", strerror(errno));
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+io_uring_cqe* io_ring::queue::peek() {
+    const uint32_t head = *cq_head_;
+    if (head == get_index(cq_tail_).load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): mapped kernel array */
+    return cqes_ + (head & cq_mask_);
+}
+
+void io_ring::queue::advance() {
+    get_index(cq_head_).store(*cq_head_ + 1, std::memory_order_release);
+}
+
+/* io_ring class */
+
+std::unique_ptr<io_ring> io_ring::create(int socket, const transceiver::options& options) {
+    std::unique_ptr<queue> receive;
+    std::unique_ptr<queue> transmit;
+    std::unique_ptr<io_ring> result;
+    io_uring_buf_reg registration{};
+    void* buffer_ring = MAP_FAILED;
+    size_t size       = 0;
+
+    auto buffer_count = utils::get_integral_option<uint32_t>(options, "uring_buffer_count", DEFAULT_BUFFER_COUNT);
+    if (!buffer_count.has_value() || !std::has_single_bit(buffer_count.value()) ||
+        buffer_count.value() > MAX_BUFFER_COUNT) {
+        logger->error("invalid io_uring options");
+        return nullptr;
+    }
+
+    /* the kernel refuses completion queues smaller than the submission queue */
+    receive  = queue::create(RECEIVE_ENTRIES, std::max(buffer_count.value(), RECEIVE_ENTRIES));
+    transmit = queue::create(TRANSMIT_SLOTS, TRANSMIT_SLOTS);
+    if (receive == nullptr || transmit == nullptr) {
+        goto queue_failed;
+    }
+
+    size        = buffer_count.value() * sizeof(io_uring_buf);
+    buffer_ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ring == MAP_FAILED) {
+        logger->error("could not allocate buffer ring: {}", strerror(errno));
+        goto mmap_failed;
+    }
+
+    registration.ring_addr    = reinterpret_cast<uint64_t>(buffer_ring); /* NOLINT(*-pro-type-reinterpret-cast) */
+    registration.ring_entries = buffer_count.value();
+    registration.bgid         = BUFFER_GROUP;
+    if (uring_register(receive->fd_, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        logger->error("could not register buffer ring: {}", strerror(errno));
+        goto register_failed;
+    }
+
+    /* from here on, the ring releases everything itself */
+    result = std::unique_ptr<io_ring>(
+        new io_ring(socket, std::move(receive), std::move(transmit), buffer_ring, buffer_count.value()));
+    if (!result->arm_receive()) {
+        return nullptr;
+    }
+
+    return result;
+
+register_failed:
+    if (munmap(buffer_ring, size) < 0) {
+        logger->error("could not unmap buffer ring: {}", strerror(errno));
+    }
+mmap_failed:
+queue_failed:
+    return nullptr;
+}
+
+io_ring::io_ring(int socket, std::unique_ptr<queue> receive, std::unique_ptr<queue> transmit, void* buffer_ring,
+                 uint32_t buffer_count)
+    : socket_(socket),
+      receive_(std::move(receive)),
+      transmit_(std::move(transmit)),
+      buffers_(buffer_count * BUFFER_SIZE),
+      buffer_ring_(buffer_ring),
+      buffer_count_(buffer_count),
+      buffer_tail_(0),
+      receive_header_{},
+      armed_(false),
+      slots_{},
+      transmit_pending_(0) {
+    receive_header_.msg_namelen    = sizeof(sockaddr_can);
+    receive_header_.msg_controllen = CONTROL_SIZE;
+
+    for (uint32_t id = 0; id < buffer_count_; id++) {
+        recycle_buffer(static_cast<uint16_t>(id));
+    }
+}
+
+io_ring::~io_ring() {
+    io_uring_buf_reg registration{};
+    registration.bgid = BUFFER_GROUP;
+
+    /* the kernel must stop filling buffers before they are freed */
+    if (uring_register(receive_->fd_, IORING_UNREGISTER_PBUF_RING, &registration, 1) < 0) {
+        logger->error("could not unregister buffer ring: {}", strerror(errno));
+    }
+
+    if (munmap(buffer_ring_, buffer_count_ * sizeof(io_uring_buf)) < 0) {
+        logger->error("could not unmap buffer ring: {}", strerror(errno));
+    }
+}
+
+int io_ring::get_fd() const {
+    return receive_->fd_;
+}
+
+uint8_t* io_ring::get_buffer(uint16_t id) {
+    return &buffers_.at(id * BUFFER_SIZE);
+}
+
+void io_ring::recycle_buffer(uint16_t id) {
+    auto* ring = static_cast<io_uring_buf_ring*>(buffer_ring_);
+
+    /*
+     * The entries are indexed from the start of the ring rather than through
+     * `bufs`, which the kernel header declares in a way that shifts it in C++.
+     */
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+    auto& buffer = static_cast<io_uring_buf*>(buffer_ring_)[buffer_tail_ & (buffer_count_ - 1)];
+    buffer.addr  = reinterpret_cast<uint64_t>(get_buffer(id));
+    buffer.len   = BUFFER_SIZE;
+    buffer.bid   = id;
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+    buffer_tail_++;
+    std::atomic_ref<uint16_t>(ring->tail).store(buffer_tail_, std::memory_order_release);
+}
+
+bool io_ring::arm_receive() {
+    io_uring_sqe* sqe = receive_->get_sqe();
+    if (sqe == nullptr) {
+        logger->error("could not arm receive request: submission queue is full");
+        return false;
+    }
+
+    sqe->opcode    = IORING_OP_RECVMSG;
+    sqe->fd        = socket_;
+    sqe->addr      = reinterpret_cast<uint64_t>(&receive_header_); /* NOLINT(*-pro-type-reinterpret-cast) */
+    sqe->len       = 1;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+
+    armed_ = receive_->submit();
+    return armed_;
+}
+
+std::optional<io_ring::packet> io_ring::peek(long timeout_ms) {
+    while (true) {
+        if (!armed_ && !arm_receive()) {
+            return std::nullopt;
+        }
+
+        if (!receive_->wait(timeout_ms)) {
+            return std::nullopt;
+        }
+
+        io_uring_cqe* cqe = receive_->peek();
+
+        /* the kernel stops the request once every buffer is in use */
+        if ((cqe->flags & IORING_CQE_F_MORE) == 0) {
+            armed_ = false;
+        }
+
+        if (cqe->res < 0 || (cqe->flags & IORING_CQE_F_BUFFER) == 0) {
+            const int error = -cqe->res;
+            receive_->advance();
+
+            if (error == ENOBUFS) {
+                continue;
+            }
+
+            logger->error("could not receive from socket: {}", strerror(error));
+            return std::nullopt;
+        }
+
+        current_ = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+        /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+        uint8_t* buffer   = get_buffer(current_.value());
+        const auto* out   = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+        uint8_t* name     = buffer + sizeof(io_uring_recvmsg_out);
+        uint8_t* control  = name + receive_header_.msg_namelen;
+        const auto* frame = reinterpret_cast<const canfd_frame*>(control + receive_header_.msg_controllen);
+        /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+        if ((out->payloadlen != CAN_MTU && out->payloadlen != CANFD_MTU) || (out->flags & MSG_TRUNC) != 0) {
+            logger->error("invalid length received");
+            pop();
+            continue;
+        }
+
+        packet result{.frame_ = frame, .mtu_ = out->payloadlen, .header_ = {}};
+        result.header_.msg_name       = name;
+        result.header_.msg_namelen    = std::min(out->namelen, receive_header_.msg_namelen);
+        result.header_.msg_control    = control;
+        result.header_.msg_controllen = out->controllen;
+        return result;
+    }
+}
+
+void io_ring::pop() {
+    if (!current_.has_value()) {
+        return;
+    }
+
+    recycle_buffer(current_.value());
+    receive_->advance();
+    current_.reset();
+}
+
+bool io_ring::drain_transmit(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    if (transmit_pending_ > 0 && !transmit_->submit()) {
+        return false;
+    }
+
+    while (transmit_pending_ > 0) {
+        if (!transmit_->wait(get_remaining_ms(deadline))) {
+            return false;
+        }
+
+        transmit_->advance();
+        transmit_pending_--;
+    }
+
+    return true;
+}
+
+size_t io_ring::transmit(std::span<const iovec> frames, long timeout_ms) {
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout_ms >= 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    /* the slots may only be reused once the kernel is done with the writes of an interrupted call */
+    if (!drain_transmit(deadline)) {
+        logger->error("could not complete previous io_uring writes");
+        return 0;
+    }
+
+    size_t sent = 0;
+    while (sent < frames.size()) {
+        size_t count = std::min(frames.size() - sent, TRANSMIT_SLOTS);
+
+        /*
+         * Linked writes are performed in order, and the ones after a failed
+         * write are cancelled. They don't wait for room in the socket buffer,
+         * so a full buffer completes them with EAGAIN instead of parking them.
+         */
+        io_uring_sqe* previous = nullptr;
+        for (size_t i = 0; i < count; i++) {
+            io_uring_sqe* sqe = transmit_->get_sqe();
+            if (sqe == nullptr) {
+                logger->error("could not prepare io_uring write: submission queue is full");
+                if (previous != nullptr) {
+                    previous->flags = 0;
+                }
+
+                count = i;
+                break;
+            }
+
+            const auto& frame = frames[sent + i];
+            const size_t mtu  = std::min(frame.iov_len, sizeof(canfd_frame));
+            std::memcpy(&slots_.at(i), frame.iov_base, mtu);
+
+            sqe->opcode    = IORING_OP_SEND;
+            sqe->fd        = socket_;
+            sqe->addr      = reinterpret_cast<uint64_t>(&slots_.at(i)); /* NOLINT(*-pro-type-reinterpret-cast) */
+            sqe->len       = static_cast<uint32_t>(mtu);
+            sqe->msg_flags = MSG_DONTWAIT;
+            sqe->user_data = i;
+            sqe->flags     = (i + 1 < count) ? IOSQE_IO_LINK : 0;
+            previous       = sqe;
+        }
+
+        if (count == 0) {
+            break;
+        }
+
+        /* every write completes, even when cancelled, so the completions left by a failure are drained later */
+        transmit_pending_ = static_cast<uint32_t>(count);
+        if (!transmit_->submit()) {
+            break;
+        }
+
+        size_t written = count;
+        for (size_t completed = 0; completed < count; completed++) {
+            if (!transmit_->wait(get_remaining_ms(deadline))) {
+                /* linked writes complete in order, the ones consumed so far are known to be written */
+                logger->error("io_uring writes didn't complete in time");
+                return sent + std::min(written, completed);
+            }
+
+            io_uring_cqe* cqe = transmit_->peek();
+            const auto index  = static_cast<size_t>(cqe->user_data);
+            if (cqe->res < 0 || static_cast<size_t>(cqe->res) != frames[sent + index].iov_len) {
+                /* a full socket buffer or transmit queue is left to the caller */
+                if (cqe->res != -ECANCELED && cqe->res != -ENOBUFS && cqe->res != -EAGAIN) {
+                    logger->error("could not write to socket: {}", strerror(cqe->res < 0 ? -cqe->res : EIO));
+                }
+
+                written = std::min(written, index);
+            }
+
+            transmit_->advance();
+            transmit_pending_--;
+        }
+
+        sent += written;
+        if (written < count) {
+            break;
+        }
+    }
+
+    return sent;
+}
+
+bool io_ring::has_pending_writes() {
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+    return transmit_pending_ > 0;
+}
+
+} /* namespace can::driver */
@@ -0,0 +1,309 @@
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "can/driver/packet_ring.hpp"
+#include "can/log.hpp"
+#include "can/utils/crop_cast.hpp"
+#include "can/utils/options.hpp"
+
+namespace can::driver {
+
+static constexpr uint32_t DEFAULT_BLOCK_SIZE  = 1U << 16U;
+static constexpr uint32_t DEFAULT_BLOCK_COUNT = 32;
+static constexpr uint32_t DEFAULT_TIMEOUT_MS  = 10;
+
+/*
+ * Frames are variable-sized in TPACKET_V3 blocks, this slot size only has to
+ * hold the largest one along with its headers.
+ */
+static constexpr uint32_t FRAME_SIZE = 256;
+
+static constexpr uint64_t SEC_TO_NSEC = 1e9;
+
+/*
+ * Block headers are shared with the kernel, which only reads and writes their
+ * status atomically.
+ */
+static std::atomic_ref<uint32_t> get_block_status(uint8_t* block) {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast): mapped kernel structure */
+    return std::atomic_ref<uint32_t>(reinterpret_cast<tpacket_block_desc*>(block)->hdr.bh1.block_status);
+}
+
+std::unique_ptr<packet_ring> packet_ring::create(const std::string& interface, const transceiver::options& options) {
+    tpacket_req3 request{};
+    sockaddr_ll addr{};
+    int version          = TPACKET_V3;
+    int timestamping     = SOF_TIMESTAMPING_RAW_HARDWARE;
+    void* map            = MAP_FAILED;
+    size_t size          = 0;
+    unsigned int ifindex = 0;
+
+    auto block_size  = utils::get_integral_option<uint32_t>(options, "ring_block_size", DEFAULT_BLOCK_SIZE);
+    auto block_count = utils::get_integral_option<uint32_t>(options, "ring_block_count", DEFAULT_BLOCK_COUNT);
+    auto timeout_ms  = utils::get_integral_option<uint32_t>(options, "ring_timeout_ms", DEFAULT_TIMEOUT_MS);
+
+    if (!block_size.has_value() || !block_count.has_value() || !timeout_ms.has_value() || block_count.value() == 0 ||
+        block_size.value() < FRAME_SIZE || block_size.value() % static_cast<uint32_t>(getpagesize()) != 0) {
+        logger->error("invalid ring options for interface '{}'", interface);
+        return nullptr;
+    }
+
+    /* no protocol until bound, so frames of other interfaces are never queued */
+    int sock = socket(AF_PACKET, SOCK_RAW, 0);
+    if (sock < 0) {
+        logger->error("could not create packet socket: {}", strerror(errno));
+        goto socket_failed;
+    }
+
+    if (setsockopt(sock, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        logger->error("could not select TPACKET_V3: {}", strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    if (options.contains("timestamping") && options.at("timestamping") == "hardware") {
+        if (setsockopt(sock, SOL_PACKET, PACKET_TIMESTAMP, &timestamping, sizeof(timestamping)) < 0) {
+            logger->warn("could not enable hardware timestamps on interface '{}': {}", interface, strerror(errno));
+        }
+    }
+
+    request.tp_block_size       = block_size.value();
+    request.tp_block_nr         = block_count.value();
+    request.tp_frame_size       = FRAME_SIZE;
+    request.tp_frame_nr         = block_size.value() / FRAME_SIZE * block_count.value();
+    request.tp_retire_blk_tov   = timeout_ms.value();
+    request.tp_feature_req_word = 0;
+
+    if (setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) < 0) {
+        logger->error("could not create receive ring: {}", strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    size = static_cast<size_t>(block_size.value()) * block_count.value();
+    map  = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+    if (map == MAP_FAILED) {
+        logger->error("could not map receive ring: {}", strerror(errno));
+        goto mmap_failed;
+    }
+
+    ifindex = if_nametoindex(interface.c_str());
+    if (ifindex == 0) {
+        logger->error("could not retrieve the interface '{}': {}", interface, strerror(errno));
+        goto ifindex_failed;
+    }
+
+    addr.sll_family   = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex  = static_cast<int>(ifindex);
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast): library type */
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        logger->error("could not bind packet socket to the interface '{}': {}", interface, strerror(errno));
+        goto bind_failed;
+    }
+
+    return std::unique_ptr<packet_ring>(
+        new packet_ring(sock, static_cast<uint8_t*>(map), block_size.value(), block_count.value(), request.tp_frame_nr));
+
+bind_failed:
+ifindex_failed:
+    if (munmap(map, size) < 0) {
+        logger->error("could not unmap receive ring: {}", strerror(errno));
+    }
+mmap_failed:
+setsockopt_failed:
+    if (close(sock) < 0) {
+        logger->error("could not close packet socket: {}", strerror(errno));
+    }
+socket_failed:
+    return nullptr;
+}
+
+packet_ring::packet_ring(int socket, uint8_t* map, size_t block_size, size_t block_count, size_t frame_count)
+    : socket_(socket),
+      map_(map),
+      block_size_(block_size),
+      block_count_(block_count),
+      block_index_(0),
+      remaining_(0),
+      next_(nullptr),
+      drops_(0),
+      max_sent_(frame_count) {}
+
+packet_ring::~packet_ring() {
+    if (munmap(map_, block_size_ * block_count_) < 0) {
+        logger->error("could not unmap receive ring: {}", strerror(errno));
+    }
+
+    if (close(socket_) < 0) {
+        logger->error("could not close packet socket: {}", strerror(errno));
+    }
+}
+
+uint64_t packet_ring::get_drop_count() {
+    tpacket_stats_v3 stats{};
+    socklen_t length = sizeof(stats);
+    if (getsockopt(socket_, SOL_PACKET, PACKET_STATISTICS, &stats, &length) < 0) {
+        logger->error("could not retrieve ring statistics: {}", strerror(errno));
+        return drops_.load();
+    }
+
+    return drops_.fetch_add(stats.tp_drops) + stats.tp_drops;
+}
+
+uint8_t* packet_ring::get_block(size_t index) const {
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): ring indexing */
+    return map_ + index * block_size_;
+}
+
+bool packet_ring::wait_for_block(long timeout_ms) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout_ms > 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    while (remaining_ == 0) {
+        uint8_t* block = get_block(block_index_);
+
+        while ((get_block_status(block).load(std::memory_order_acquire) & TP_STATUS_USER) == 0) {
+            pollfd pfd = {.fd = socket_, .events = POLLIN | POLLERR, .revents = 0};
+
+            /* interruptions and wake-ups without any block restart the wait, only for the time left */
+            long remaining_ms = timeout_ms;
+            if (deadline.has_value()) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline.value() - std::chrono::steady_clock::now());
+                remaining_ms = std::max<long>(remaining.count(), 0);
+            }
+
+            int count = poll(&pfd, 1, utils::crop_cast<long, int>(remaining_ms));
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                logger->error("could not poll packet socket: {}", strerror(errno));
+                return false;
+            }
+
+            if (count == 0) {
+                return false;
+            }
+        }
+
+        /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+        const auto& header = reinterpret_cast<const tpacket_block_desc*>(block)->hdr.bh1;
+        remaining_         = header.num_pkts;
+        next_              = block + header.offset_to_first_pkt;
+        /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+        if (remaining_ == 0) {
+            release_block();
+        }
+    }
+
+    return true;
+}
+
+void packet_ring::release_block() {
+    get_block_status(get_block(block_index_)).store(TP_STATUS_KERNEL, std::memory_order_release);
+
+    block_index_ = (block_index_ + 1) % block_count_;
+    remaining_   = 0;
+    next_        = nullptr;
+}
+
+std::optional<packet_ring::packet> packet_ring::peek(long timeout_ms) {
+    while (wait_for_block(timeout_ms)) {
+        /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+        const auto* header  = reinterpret_cast<const tpacket3_hdr*>(next_);
+        const auto* address = reinterpret_cast<const sockaddr_ll*>(next_ + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+        const auto* frame   = reinterpret_cast<const canfd_frame*>(next_ + header->tp_mac);
+        /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+        if (header->tp_snaplen != CAN_MTU && header->tp_snaplen != CANFD_MTU) {
+            logger->error("invalid length received");
+            pop();
+            continue;
+        }
+
+        /* frames sent from this host are seen on their way out, only those of the other sockets are received */
+        if (address->sll_pkttype == PACKET_OUTGOING && is_sent(*frame, header->tp_snaplen)) {
+            pop();
+            continue;
+        }
+
+        return packet{
+            .frame_              = frame,
+            .mtu_                = header->tp_snaplen,
+            .timestamp_          = header->tp_sec * SEC_TO_NSEC + header->tp_nsec,
+            .hardware_timestamp_ = (header->tp_status & TP_STATUS_TS_RAW_HARDWARE) != 0,
+            .interface_          = static_cast<uint32_t>(address->sll_ifindex),
+        };
+    }
+
+    return std::nullopt;
+}
+
+void packet_ring::expect_sent(const canfd_frame& frame, size_t mtu) {
+    std::lock_guard<std::mutex> guard(sent_mutex_);
+
+    /* frames the ring dropped are never seen, the oldest ones are forgotten */
+    if (sent_.size() == max_sent_) {
+        sent_.pop_front();
+    }
+
+    sent_.emplace_back(frame, mtu);
+}
+
+void packet_ring::cancel_sent(size_t count) {
+    std::lock_guard<std::mutex> guard(sent_mutex_);
+    sent_.erase(sent_.end() - static_cast<std::ptrdiff_t>(std::min(count, sent_.size())), sent_.end());
+}
+
+bool packet_ring::is_sent(const canfd_frame& frame, size_t mtu) {
+    std::lock_guard<std::mutex> guard(sent_mutex_);
+
+    /* the oldest match is consumed, the frames announced before it are only forgotten once the cap is reached */
+    auto it = std::find_if(sent_.begin(), sent_.end(), [&](const auto& sent) {
+        /* the kernel may set flags on its way, so only the identifier and the payload are compared */
+        const auto& [other, other_mtu] = sent;
+        return other_mtu == mtu && other.can_id == frame.can_id && other.len == frame.len &&
+               std::memcmp(other.data, frame.data, std::min<size_t>(frame.len, CANFD_MAX_DLEN)) == 0;
+    });
+
+    if (it == sent_.end()) {
+        return false;
+    }
+
+    sent_.erase(it);
+    return true;
+}
+
+void packet_ring::pop() {
+    if (remaining_ == 0) {
+        return;
+    }
+
+    remaining_--;
+    if (remaining_ == 0) {
+        release_block();
+        return;
+    }
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+    next_ += reinterpret_cast<const tpacket3_hdr*>(next_)->tp_next_offset;
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+}
+
+} /* namespace can::driver */
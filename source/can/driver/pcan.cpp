@@ -16,6 +16,7 @@
 #include "can/driver/pcan.hpp"
 #include "can/log.hpp"
 #include "can/utils/crop_cast.hpp"
+#include "can/utils/dlc.hpp"
 
 namespace can::driver {
 
@@ -36,6 +37,7 @@ const static std::map<unsigned int, std::string> DEVICE_TO_INTERFACE = {
     {PCAN_USBBUS16, "PCAN_USBBUS16"}};
 
 static constexpr uint64_t MSEC_TO_USEC = 1000;
+static constexpr uint64_t USEC_TO_NSEC = 1000;
 static constexpr uint32_t SHIFT32      = 32;
 static constexpr unsigned int MAX_DLC  = 8;
 
@@ -92,7 +94,7 @@ channel_count_failed:
     return {};
 }
 
-pcan::ptr pcan::create(const std::string& interface) {
+pcan::ptr pcan::create(const std::string& interface, const options& options) {
 #ifdef BUILD_LINUX
     pcan::event_type event = 0;
 #endif /* BUILD_LINUX */
@@ -102,6 +104,7 @@ pcan::ptr pcan::create(const std::string& interface) {
 
     unsigned int device = 0;
     TPCANStatus status  = 0;
+    std::string fd_bitrate;
 
     if (!INTERFACE_TO_DEVICE.contains(interface)) {
         logger->error("invalid specified interface '{}'", interface);
@@ -109,7 +112,12 @@ pcan::ptr pcan::create(const std::string& interface) {
     }
     device = INTERFACE_TO_DEVICE.at(interface);
 
-    status = CAN_Initialize(device, PCAN_BAUD_500K, 0, 0, 0);
+    if (options.contains("fd_bitrate")) {
+        fd_bitrate = options.at("fd_bitrate");
+        status     = CAN_InitializeFD(device, fd_bitrate.data());
+    } else {
+        status = CAN_Initialize(device, PCAN_BAUD_500K, 0, 0, 0);
+    }
     if (status != PCAN_ERROR_OK) {
         logger->error("could not initialize interface '{}': {}", interface, get_error(status));
         goto initialize_failed;
@@ -137,7 +145,7 @@ pcan::ptr pcan::create(const std::string& interface) {
     }
 #endif /* BUILD_WINDOWS */
 
-    return ptr(std::shared_ptr<pcan>(new pcan(device, event)));
+    return ptr(std::shared_ptr<pcan>(new pcan(device, event, !fd_bitrate.empty())));
 
 pcan_receive_event_failed:
 #ifdef BUILD_WINDOWS
@@ -153,7 +161,7 @@ invalid_interface:
     return nullptr;
 }
 
-pcan::pcan(unsigned int device, event_type event) : device_(device), event_(event) {}
+pcan::pcan(unsigned int device, event_type event, bool fd) : device_(device), event_(event), fd_(fd) {}
 
 pcan::~pcan() {
     TPCANStatus status = CAN_Uninitialize(device_);
@@ -185,19 +193,45 @@ bool pcan::set_bitrate(unsigned long bitrate) {
 }
 
 bool pcan::transmit(frame::ptr msg) {
-    if (msg->length_ > MAX_DLC) {
-        logger->error("invalid message length");
-        return false;
-    }
+    return transmit(msg->identifier_, {msg->bytes_, msg->length_}, msg->flags_, msg->interface_);
+}
+
+bool pcan::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t /* interface */) {
+    const size_t length = bytes.size();
+    TPCANStatus status  = PCAN_ERROR_OK;
+
+    if (fd_) {
+        if (length > utils::dlc::to_length(utils::dlc::MAX_DLC)) {
+            logger->error("invalid message length");
+            return false;
+        }
 
-    TPCANMsg frame;
-    frame.ID      = msg->identifier_;
-    frame.LEN     = msg->length_;
-    frame.MSGTYPE = PCAN_MESSAGE_STANDARD;
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library function */
-    std::copy(msg->bytes_, msg->bytes_ + msg->length_, frame.DATA);
+        const bool is_fd = ((flags & frame::FD) != 0) || (length > MAX_DLC);
+
+        TPCANMsgFD message{};
+        message.ID      = identifier;
+        message.DLC     = utils::dlc::from_length(length);
+        message.MSGTYPE = PCAN_MESSAGE_STANDARD;
+        message.MSGTYPE |= is_fd ? PCAN_MESSAGE_FD : 0;
+        message.MSGTYPE |= (is_fd && (flags & frame::BRS) != 0) ? PCAN_MESSAGE_BRS : 0;
+        std::copy(bytes.begin(), bytes.end(), message.DATA);
+
+        status = CAN_WriteFD(device_, &message);
+    } else {
+        if (length > MAX_DLC || (flags & frame::FD) != 0) {
+            logger->error("invalid message length");
+            return false;
+        }
+
+        TPCANMsg message;
+        message.ID      = identifier;
+        message.LEN     = length;
+        message.MSGTYPE = PCAN_MESSAGE_STANDARD;
+        std::copy(bytes.begin(), bytes.end(), message.DATA);
+
+        status = CAN_Write(device_, &message);
+    }
 
-    TPCANStatus status = CAN_Write(device_, &frame);
     if (status != PCAN_ERROR_OK) {
         logger->error("could not write message: {}", get_error(status));
         return false;
@@ -206,30 +240,59 @@ bool pcan::transmit(frame::ptr msg) {
     return true;
 }
 
-frame::ptr pcan::try_receive() {
-    TPCANMsg frame;
+bool pcan::try_receive(fd_frame& msg) {
+    if (fd_) {
+        TPCANMsgFD message;
+        TPCANTimestampFD ts;
+        TPCANStatus status = CAN_ReadFD(device_, &message, &ts);
+        if (status != PCAN_ERROR_OK) {
+            if (status != PCAN_ERROR_QRCVEMPTY) {
+                logger->error("could not read message: {}", get_error(status));
+            }
+
+            return false;
+        }
+
+        msg.identifier_ = message.ID;
+        msg.timestamp_  = ts * USEC_TO_NSEC;
+        msg.interface_  = 0;
+        msg.length_     = utils::dlc::to_length(message.DLC);
+        msg.flags_      = frame::HW_TIMESTAMP;
+        msg.flags_ |= ((message.MSGTYPE & PCAN_MESSAGE_FD) != 0) ? frame::FD : 0;
+        msg.flags_ |= ((message.MSGTYPE & PCAN_MESSAGE_BRS) != 0) ? frame::BRS : 0;
+        msg.flags_ |= ((message.MSGTYPE & PCAN_MESSAGE_ESI) != 0) ? frame::ESI : 0;
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library type */
+        std::copy(message.DATA, message.DATA + msg.length_, msg.bytes_.begin());
+
+        return true;
+    }
+
+    TPCANMsg message;
     TPCANTimestamp ts;
-    TPCANStatus status = CAN_Read(device_, &frame, &ts);
+    TPCANStatus status = CAN_Read(device_, &message, &ts);
     if (status != PCAN_ERROR_OK) {
         if (status != PCAN_ERROR_QRCVEMPTY) {
             logger->error("could not read message: {}", get_error(status));
         }
 
-        return nullptr;
+        return false;
     }
 
     uint64_t timestamp = (static_cast<uint64_t>(ts.millis_overflow) << SHIFT32) + ts.millis;
-    timestamp          = timestamp * MSEC_TO_USEC + ts.micros;
+    timestamp          = (timestamp * MSEC_TO_USEC + ts.micros) * USEC_TO_NSEC;
 
-    return frame::create(frame.ID, frame.LEN, frame.DATA, timestamp);
-}
+    msg.identifier_ = message.ID;
+    msg.timestamp_  = timestamp;
+    msg.interface_  = 0;
+    msg.length_     = std::min<size_t>(message.LEN, MAX_DLC);
+    msg.flags_      = frame::HW_TIMESTAMP;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library type */
+    std::copy(message.DATA, message.DATA + msg.length_, msg.bytes_.begin());
 
-frame::ptr pcan::receive(long timeout_ms) {
-    auto frame = try_receive();
-    if (frame != nullptr) {
-        return frame;
-    }
+    return true;
+}
 
+bool pcan::wait_for_frames(long timeout_ms) {
 #ifdef BUILD_WINDOWS
     ResetEvent(event_);
 #endif /* BUILD_WINDOWS */
@@ -237,7 +300,7 @@ frame::ptr pcan::receive(long timeout_ms) {
 #ifdef BUILD_LINUX
     int count = -1;
     while (count <= 0) {
-        pollfd pfd = {.fd = event_, .events = POLLIN};
+        pollfd pfd = {.fd = event_, .events = POLLIN, .revents = 0};
 
         count = poll(&pfd, 1, utils::crop_cast<long, int>(timeout_ms));
         if (count < 0) {
@@ -246,11 +309,11 @@ frame::ptr pcan::receive(long timeout_ms) {
             }
 
             logger->error("could not poll socket: {}", strerror(errno));
-            return nullptr;
+            return false;
         }
 
         if (count == 0) {
-            return nullptr;
+            return false;
         }
     }
 #endif /* BUILD_LINUX */
@@ -259,11 +322,61 @@ frame::ptr pcan::receive(long timeout_ms) {
     auto timeout = (timeout_ms < 0) ? INFINITE : utils::crop_cast<long, DWORD>(timeout_ms);
     if (WaitForSingleObject(event_, timeout) == WAIT_FAILED) {
         logger->error("failed to wait for event: {}", utils::windows::get_last_error());
-        return nullptr;
+        return false;
     }
 #endif /* BUILD_WINDOWS */
 
-    return try_receive();
+    return true;
+}
+
+frame::ptr pcan::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
+        return nullptr;
+    }
+
+    return msg.to_ptr();
+}
+
+bool pcan::receive_into(fd_frame& msg, long timeout_ms) {
+    return try_receive(msg) || (timeout_ms != 0 && wait_for_frames(timeout_ms) && try_receive(msg));
+}
+
+size_t pcan::receive_batch(frame_batch& batch, long timeout_ms) {
+    fd_frame msg{};
+    size_t appended = 0;
+    bool waited     = false;
+
+    /* only wait for the first frame, then drain the queue of the driver until it is empty or the batch is full */
+    while (!batch.full()) {
+        if (!try_receive(msg)) {
+            if (appended > 0 || waited || timeout_ms == 0 || !wait_for_frames(timeout_ms)) {
+                break;
+            }
+
+            waited = true;
+            continue;
+        }
+
+        if (!batch.push_back(msg.identifier_, msg.length_, msg.bytes_.data(), msg.timestamp_, msg.flags_)) {
+            logger->error("frame of {} bytes doesn't fit in batch", msg.length_);
+            continue;
+        }
+
+        appended++;
+    }
+
+    return appended;
+}
+
+int pcan::get_poll_fd() const {
+#ifdef BUILD_LINUX
+    return event_;
+#endif /* BUILD_LINUX */
+
+#ifdef BUILD_WINDOWS
+    return -1;
+#endif /* BUILD_WINDOWS */
 }
 
 } /* namespace can::driver */
\ No newline at end of file
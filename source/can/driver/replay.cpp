@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+#include "can/driver/replay.hpp"
+#include "can/log.hpp"
+#include "can/utils/clock.hpp"
+#include "can/utils/options.hpp"
+
+namespace can::driver {
+
+static constexpr uint64_t SEC_TO_NSEC    = 1000000000;
+static constexpr size_t NSEC_DIGITS      = 9;
+static constexpr uint64_t DECIMAL_BASE   = 10;
+static constexpr int HEXADECIMAL_BASE    = 16;
+static constexpr size_t MAX_CLASSIC_SIZE = 8;
+
+/* flags of CAN FD frames in the log format */
+static constexpr uint8_t LOG_BRS = 0x01;
+static constexpr uint8_t LOG_ESI = 0x02;
+
+/**
+ * Outcome of parsing a line of a capture.
+ */
+enum class parse_result {
+    FRAME,
+    SKIPPED, /* blank line, comment or remote frame */
+    INVALID,
+};
+
+template <typename T>
+static bool parse_number(std::string_view text, T& value, int base = 10) {
+    static_assert(std::is_integral_v<T>);
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): string bounds */
+    const char* end   = text.data() + text.size();
+    auto [ptr, error] = std::from_chars(text.data(), end, value, base);
+    return error == std::errc() && ptr == end && !text.empty();
+}
+
+/*
+ * Parses a timestamp in seconds with a decimal fraction into nanoseconds, without rounding through a double.
+ */
+static bool parse_timestamp(std::string_view text, uint64_t& timestamp) {
+    auto dot = text.find('.');
+
+    uint64_t seconds  = 0;
+    uint64_t fraction = 0;
+    if (!parse_number(text.substr(0, dot), seconds)) {
+        return false;
+    }
+
+    if (dot != std::string_view::npos) {
+        auto digits = text.substr(dot + 1, NSEC_DIGITS);
+        if (!parse_number(digits, fraction)) {
+            return false;
+        }
+
+        for (size_t i = digits.size(); i < NSEC_DIGITS; i++) {
+            fraction *= DECIMAL_BASE;
+        }
+    }
+
+    timestamp = seconds * SEC_TO_NSEC + fraction;
+    return true;
+}
+
+static bool parse_bytes(std::string_view text, fd_frame& msg) {
+    msg.length_ = 0;
+
+    for (size_t i = 0; i < text.size();) {
+        if (text[i] == '.') {
+            i++;
+            continue;
+        }
+
+        if (msg.length_ == fd_frame::CAPACITY ||
+            !parse_number(text.substr(i, 2), msg.bytes_.at(msg.length_), HEXADECIMAL_BASE)) {
+            return false;
+        }
+
+        msg.length_++;
+        i += 2;
+    }
+
+    return true;
+}
+
+/*
+ * Parses a line such as "(1436509052.249713) can0 123#DEADBEEF", or "... 123##1DEADBEEF" for CAN FD frames, whose
+ * flags follow the second separator.
+ */
+static parse_result parse_line(std::string_view line, fd_frame& msg) {
+    auto begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos || line[begin] == '#') {
+        return parse_result::SKIPPED;
+    }
+
+    line      = line.substr(begin);
+    auto stop = line.find(')');
+    if (line.front() != '(' || stop == std::string_view::npos) {
+        return parse_result::INVALID;
+    }
+
+    msg = {};
+    if (!parse_timestamp(line.substr(1, stop - 1), msg.timestamp_)) {
+        return parse_result::INVALID;
+    }
+
+    /* the interface and then the frame, separated by blanks and maybe followed by other fields */
+    auto interface = line.find_first_not_of(' ', stop + 1);
+    auto separator = line.find(' ', interface);
+    auto position  = line.find_first_not_of(' ', separator);
+    if (interface == std::string_view::npos || position == std::string_view::npos) {
+        return parse_result::INVALID;
+    }
+
+    auto text = line.substr(position);
+    text      = text.substr(0, text.find_first_of(" \t\r"));
+
+    auto hash = text.find('#');
+    if (hash == std::string_view::npos || !parse_number(text.substr(0, hash), msg.identifier_, HEXADECIMAL_BASE)) {
+        return parse_result::INVALID;
+    }
+
+    auto payload = text.substr(hash + 1);
+    if (!payload.empty() && payload.front() == 'R') {
+        return parse_result::SKIPPED;
+    }
+
+    if (!payload.empty() && payload.front() == '#') {
+        uint8_t flags = 0;
+        if (payload.size() < 2 || !parse_number(payload.substr(1, 1), flags, HEXADECIMAL_BASE)) {
+            return parse_result::INVALID;
+        }
+
+        msg.flags_ = frame::FD;
+        msg.flags_ |= ((flags & LOG_BRS) != 0) ? frame::BRS : 0;
+        msg.flags_ |= ((flags & LOG_ESI) != 0) ? frame::ESI : 0;
+        payload = payload.substr(2);
+    }
+
+    if (!parse_bytes(payload, msg) || ((msg.flags_ & frame::FD) == 0 && msg.length_ > MAX_CLASSIC_SIZE)) {
+        return parse_result::INVALID;
+    }
+
+    return parse_result::FRAME;
+}
+
+/*
+ * Parses identifier pairs such as "123:223,124:224".
+ */
+static std::optional<std::map<uint32_t, uint32_t>> parse_remap(std::string_view text) {
+    std::map<uint32_t, uint32_t> remap;
+
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        auto pair  = text.substr(0, comma);
+        auto colon = pair.find(':');
+
+        uint32_t from = 0;
+        uint32_t to   = 0;
+        if (colon == std::string_view::npos || !parse_number(pair.substr(0, colon), from, HEXADECIMAL_BASE) ||
+            !parse_number(pair.substr(colon + 1), to, HEXADECIMAL_BASE)) {
+            return std::nullopt;
+        }
+
+        remap[from] = to;
+        text        = (comma == std::string_view::npos) ? std::string_view{} : text.substr(comma + 1);
+    }
+
+    return remap;
+}
+
+std::list<std::string> replay::list_interfaces() {
+    return {};
+}
+
+transceiver::ptr replay::create(const std::string& interface, const options& options) {
+    auto speed  = utils::get_floating_option<double>(options, "speed", 1);
+    auto repeat = utils::get_integral_option<uint64_t>(options, "repeat", 1);
+    auto remap  = parse_remap(options.contains("remap") ? options.at("remap") : "");
+    if (!speed.has_value() || speed.value() < 0 || !repeat.has_value() || !remap.has_value()) {
+        logger->error("invalid replay options for capture '{}'", interface);
+        return nullptr;
+    }
+
+    std::ifstream file(interface);
+    if (!file.is_open()) {
+        logger->error("could not open capture '{}'", interface);
+        return nullptr;
+    }
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-owning-memory): private constructor */
+    return std::shared_ptr<transceiver>(
+        new replay(interface, std::move(file), speed.value(), repeat.value(), std::move(remap.value())));
+}
+
+replay::replay(std::string path, std::ifstream file, double speed, uint64_t repeat, std::map<uint32_t, uint32_t> remap)
+    : path_(std::move(path)),
+      file_(std::move(file)),
+      speed_(speed),
+      repeat_(repeat),
+      remap_(std::move(remap)),
+      filtered_(false),
+      line_(0),
+      pass_(1),
+      pass_frames_(0),
+      capture_frames_(0),
+      finished_(false),
+      last_timestamp_(0),
+      offset_ns_(0) {}
+
+bool replay::set_bitrate(unsigned long /* bitrate */) {
+    logger->error("can't set the bitrate of capture '{}'", path_);
+    return false;
+}
+
+bool replay::transmit(frame::ptr /* msg */) {
+    logger->error("can't transmit to capture '{}'", path_);
+    return false;
+}
+
+frame::ptr replay::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
+        return nullptr;
+    }
+
+    return msg.to_ptr();
+}
+
+bool replay::receive_into(fd_frame& msg, long timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!wait_for_next(lock, timeout_ms)) {
+        return false;
+    }
+
+    msg = next_.value();
+    next_.reset();
+    return true;
+}
+
+bool replay::set_filter(const std::vector<uint32_t>& identifiers) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    filter_ = identifiers;
+    std::sort(filter_.begin(), filter_.end());
+    filtered_ = true;
+
+    /* the frame read ahead was accepted by the previous filter */
+    if (next_.has_value() && !std::binary_search(filter_.begin(), filter_.end(), next_->identifier_)) {
+        next_.reset();
+    }
+
+    return true;
+}
+
+bool replay::clear_filter() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    filter_.clear();
+    filtered_ = false;
+    return true;
+}
+
+bool replay::finished() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return finished_;
+}
+
+bool replay::read_next() {
+    std::string line;
+
+    /* the filter may reject a whole pass, the frames are then waited for like on an idle bus */
+    bool rewound = false;
+
+    while (!finished_) {
+        if (!std::getline(file_, line)) {
+            /* a pass without any frame would make the next ones loop forever */
+            if (file_.bad() || pass_frames_ == 0 || (repeat_ != 0 && pass_ >= repeat_)) {
+                finished_ = true;
+                break;
+            }
+
+            file_.clear();
+            file_.seekg(0);
+            line_        = 0;
+            pass_frames_ = 0;
+            /* the next pass starts one frame interval after the end of this one, at least a nanosecond */
+            const uint64_t duration = last_timestamp_ - first_timestamp_.value_or(last_timestamp_);
+            const uint64_t interval = (capture_frames_ > 1) ? duration / (capture_frames_ - 1) : 0;
+            offset_ns_ += duration + std::max<uint64_t>(interval, 1);
+            pass_++;
+
+            if (rewound) {
+                return false;
+            }
+
+            rewound = true;
+            continue;
+        }
+
+        line_++;
+
+        fd_frame frame{};
+        auto result = parse_line(line, frame);
+        if (result == parse_result::INVALID && pass_ == 1) {
+            logger->warn("skipping invalid line {} of capture '{}'", line_, path_);
+        }
+
+        if (result != parse_result::FRAME) {
+            continue;
+        }
+
+        if (!first_timestamp_.has_value()) {
+            first_timestamp_ = frame.timestamp_;
+        }
+
+        if (pass_ == 1) {
+            capture_frames_++;
+        }
+        pass_frames_++;
+
+        /* the timestamps of a capture may go back when it was merged from several interfaces */
+        last_timestamp_ = std::max(last_timestamp_, frame.timestamp_);
+        frame.timestamp_ += offset_ns_;
+
+        if (auto it = remap_.find(frame.identifier_); it != remap_.end()) {
+            frame.identifier_ = it->second;
+        }
+
+        if (filtered_ && !std::binary_search(filter_.begin(), filter_.end(), frame.identifier_)) {
+            continue;
+        }
+
+        next_ = frame;
+        return true;
+    }
+
+    return false;
+}
+
+bool replay::wait_for_next(std::unique_lock<std::mutex>& lock, long timeout_ms) {
+    return utils::wait_for_due(lock, timeout_ms, [this](clock::time_point& due) {
+        /* while the filter drops every frame read ahead, nothing is received like on an idle bus */
+        if (!next_.has_value() && !read_next()) {
+            return finished_ ? utils::next_state::OVER : utils::next_state::IDLE;
+        }
+
+        if (speed_ == 0) {
+            due = clock::time_point::min();
+            return utils::next_state::DUE;
+        }
+
+        if (!started_.has_value()) {
+            started_ = clock::now();
+        }
+
+        auto recorded = static_cast<double>(next_->timestamp_ - std::min(next_->timestamp_, first_timestamp_.value()));
+        due           = started_.value() + std::chrono::nanoseconds(static_cast<int64_t>(recorded / speed_));
+        return utils::next_state::DUE;
+    });
+}
+
+} /* namespace can::driver */
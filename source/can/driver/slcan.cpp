@@ -0,0 +1,639 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <regex>
+
+#include "can/driver/slcan.hpp"
+#include "can/log.hpp"
+#include "can/utils/clock.hpp"
+#include "can/utils/crop_cast.hpp"
+#include "can/utils/dlc.hpp"
+#include "can/utils/hex.hpp"
+#include "can/utils/options.hpp"
+
+namespace can::driver {
+
+static constexpr uint64_t MSEC_TO_NSEC         = 1000000;
+static constexpr size_t MAX_CLASSIC_SIZE       = 8;
+static constexpr long DEFAULT_TX_TIMEOUT_MS    = 1000;
+static constexpr unsigned int DEFAULT_BAUDRATE = 115200;
+
+static constexpr size_t STANDARD_IDENTIFIER_DIGITS = 3;
+static constexpr size_t EXTENDED_IDENTIFIER_DIGITS = 8;
+static constexpr uint32_t MAX_STANDARD_IDENTIFIER  = 0x7FF;
+static constexpr uint32_t MAX_EXTENDED_IDENTIFIER  = 0x1FFFFFFF;
+
+/* device timestamps count milliseconds within a minute */
+static constexpr size_t TIMESTAMP_DIGITS = 4;
+static constexpr uint64_t DEVICE_WRAP_MS = 60000;
+static constexpr uint64_t DEVICE_WRAP_NS = DEVICE_WRAP_MS * MSEC_TO_NSEC;
+
+/* replies are terminated by a carriage return, errors are a single bell */
+static constexpr std::string_view TERMINATORS = "\r\n\a";
+
+/* lower case frame types carry standard identifiers, upper case ones extended identifiers */
+static constexpr char CASE_BIT = 0x20;
+
+/*
+ * Bitrates of the "Sn" command.
+ */
+static constexpr std::array<std::pair<unsigned long, char>, 9> BITRATES = {{
+    {10000, '0'},
+    {20000, '1'},
+    {50000, '2'},
+    {100000, '3'},
+    {125000, '4'},
+    {250000, '5'},
+    {500000, '6'},
+    {800000, '7'},
+    {1000000, '8'},
+}};
+
+static constexpr std::array<std::pair<unsigned int, speed_t>, 11> BAUDRATES = {{
+    {9600, B9600},
+    {19200, B19200},
+    {38400, B38400},
+    {57600, B57600},
+    {115200, B115200},
+    {230400, B230400},
+    {460800, B460800},
+    {921600, B921600},
+    {1000000, B1000000},
+    {2000000, B2000000},
+    {3000000, B3000000},
+}};
+
+/**
+ * Outcome of parsing a line read from the tty.
+ */
+enum class parse_result {
+    FRAME,
+    SKIPPED, /* empty line, remote frame or command reply */
+    INVALID,
+};
+
+template <typename T, size_t Size>
+static std::optional<typename T::second_type> find_setting(const std::array<T, Size>& settings,
+                                                           typename T::first_type value) {
+    for (const auto& [key, setting] : settings) {
+        if (key == value) {
+            return setting;
+        }
+    }
+
+    return std::nullopt;
+}
+
+/*
+ * Parses a line such as "t1234DEADBEEF", optionally followed by a device timestamp. The frame type gives the size of
+ * the identifier and whether the length is a CAN FD DLC. A device timestamp is stored as is, in milliseconds, and is
+ * flagged by `HW_TIMESTAMP`.
+ */
+static parse_result parse_line(std::string_view line, fd_frame& msg) {
+    if (line.empty()) {
+        return parse_result::SKIPPED;
+    }
+
+    uint8_t flags = 0;
+    switch (line.front() | CASE_BIT) {
+        case 't':
+            break;
+        case 'd':
+            flags = frame::FD;
+            break;
+        case 'b':
+            flags = frame::FD | frame::BRS;
+            break;
+        default:
+            /* remote frames, transmit acknowledgements and replies to commands */
+            return parse_result::SKIPPED;
+    }
+
+    const bool extended     = (line.front() & CASE_BIT) == 0;
+    const size_t id_digits  = extended ? EXTENDED_IDENTIFIER_DIGITS : STANDARD_IDENTIFIER_DIGITS;
+    const size_t data_start = 1 + id_digits + 1;
+    if (line.size() < data_start) {
+        return parse_result::INVALID;
+    }
+
+    msg = {};
+    if (!utils::hex::decode_integer(&line[1], id_digits, msg.identifier_) ||
+        msg.identifier_ > (extended ? MAX_EXTENDED_IDENTIFIER : MAX_STANDARD_IDENTIFIER)) {
+        return parse_result::INVALID;
+    }
+
+    const int dlc = utils::hex::decode_digit(line[1 + id_digits]);
+    if (dlc < 0 || (flags == 0 && dlc > static_cast<int>(MAX_CLASSIC_SIZE))) {
+        return parse_result::INVALID;
+    }
+
+    msg.length_ = utils::dlc::to_length(static_cast<uint8_t>(dlc));
+    msg.flags_  = flags;
+
+    /* the payload may only be followed by a timestamp */
+    const size_t trailing = line.size() - data_start;
+    if (trailing != 2 * msg.length_ && trailing != 2 * msg.length_ + TIMESTAMP_DIGITS) {
+        return parse_result::INVALID;
+    }
+
+    if (!utils::hex::decode(&line[data_start], msg.length_, msg.bytes_.data())) {
+        return parse_result::INVALID;
+    }
+
+    if (trailing > 2 * msg.length_) {
+        uint16_t value = 0;
+        if (!utils::hex::decode_integer(&line[data_start + 2 * msg.length_], TIMESTAMP_DIGITS, value) ||
+            value >= DEVICE_WRAP_MS) {
+            return parse_result::INVALID;
+        }
+
+        msg.timestamp_ = value;
+        msg.flags_ |= frame::HW_TIMESTAMP;
+    }
+
+    return parse_result::FRAME;
+}
+
+/*
+ * Formats the line of a frame, terminated by a carriage return, and returns its size, or 0 if the frame is invalid.
+ * CAN FD payloads are padded with zeros to the length of their DLC.
+ */
+static size_t format_line(uint32_t identifier, size_t length, const uint8_t* bytes, uint8_t flags, char* line) {
+    if (identifier > MAX_EXTENDED_IDENTIFIER || length > fd_frame::CAPACITY) {
+        logger->error("invalid frame of identifier {:#x} and length {}", identifier, length);
+        return 0;
+    }
+
+    const bool extended = identifier > MAX_STANDARD_IDENTIFIER;
+    const bool is_fd    = ((flags & frame::FD) != 0) || length > MAX_CLASSIC_SIZE;
+    const size_t digits = extended ? EXTENDED_IDENTIFIER_DIGITS : STANDARD_IDENTIFIER_DIGITS;
+    const uint8_t dlc   = utils::dlc::from_length(length);
+    const size_t padded = utils::dlc::to_length(dlc);
+    const char type     = !is_fd ? 't' : ((flags & frame::BRS) != 0) ? 'b' : 'd';
+    const size_t end    = 1 + digits + 1 + 2 * padded;
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): line of the longest frame */
+    line[0] = extended ? static_cast<char>(type & ~CASE_BIT) : type;
+    utils::hex::encode_integer(identifier, digits, line + 1);
+    line[1 + digits] = utils::hex::DIGITS.at(dlc);
+    utils::hex::encode(bytes, length, line + 1 + digits + 1);
+    std::fill(line + 1 + digits + 1 + 2 * length, line + end, '0');
+    line[end] = '\r';
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+    return end + 1;
+}
+
+/*
+ * Commands closing the channel, setting its bitrate if given, and opening it again.
+ */
+static std::string reopen_commands(std::optional<char> bitrate, std::optional<bool> timestamps, bool listen_only) {
+    std::string commands = "C\r";
+    if (bitrate.has_value()) {
+        commands += std::string("S") + bitrate.value() + "\r";
+    }
+
+    if (timestamps.has_value()) {
+        commands += timestamps.value() ? "Z1\r" : "Z0\r";
+    }
+
+    commands += listen_only ? "L\r" : "O\r";
+    return commands;
+}
+
+std::list<std::string> slcan::list_interfaces() {
+    const std::regex interface_regex(".*\\/(tty(ACM|USB)\\d+)");
+    const std::string dev_dir("/dev");
+
+    std::list<std::string> interfaces;
+    for (const auto& it : std::filesystem::directory_iterator(dev_dir)) {
+        std::string path = it.path().string();
+
+        std::smatch matches;
+        if (std::regex_search(path, matches, interface_regex)) {
+            interfaces.push_back(path);
+        }
+    }
+
+    return interfaces;
+}
+
+transceiver::ptr slcan::create(const std::string& interface, const options& options) {
+    termios tty{};
+    std::optional<char> bitrate_code;
+    std::optional<speed_t> speed;
+    timestamp_mode timestamps = timestamp_mode::HOST;
+
+    auto baudrate    = utils::get_integral_option<unsigned int>(options, "baudrate", DEFAULT_BAUDRATE);
+    auto bitrate     = utils::get_integral_option<unsigned long>(options, "bitrate", 0);
+    auto listen_only = utils::get_integral_option<int>(options, "listen_only", 0);
+    auto timeout_ms  = utils::get_integral_option<long>(options, "tx_timeout_ms", DEFAULT_TX_TIMEOUT_MS);
+    if (!baudrate.has_value() || !bitrate.has_value() || !listen_only.has_value() || !timeout_ms.has_value()) {
+        logger->error("invalid slcan options for tty '{}'", interface);
+        return nullptr;
+    }
+
+    speed = find_setting(BAUDRATES, baudrate.value());
+    if (!speed.has_value()) {
+        logger->error("invalid baudrate {} for tty '{}'", baudrate.value(), interface);
+        return nullptr;
+    }
+
+    if (bitrate.value() != 0) {
+        bitrate_code = find_setting(BITRATES, bitrate.value());
+        if (!bitrate_code.has_value()) {
+            logger->error("invalid bitrate {} for tty '{}'", bitrate.value(), interface);
+            return nullptr;
+        }
+    }
+
+    if (options.contains("timestamps")) {
+        const auto& mode = options.at("timestamps");
+        if (mode != "host" && mode != "device") {
+            logger->error("invalid timestamps mode '{}'", mode);
+            return nullptr;
+        }
+
+        timestamps = (mode == "device") ? timestamp_mode::DEVICE : timestamp_mode::HOST;
+    }
+
+    int fd = open(interface.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        logger->error("could not open tty '{}': {}", interface, strerror(errno));
+        goto open_failed;
+    }
+
+    /* raw mode, so carriage returns and bells reach the parser untouched */
+    if (tcgetattr(fd, &tty) < 0) {
+        logger->error("could not retrieve the attributes of tty '{}': {}", interface, strerror(errno));
+        goto tty_failed;
+    }
+
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cc[VMIN]  = 0;
+    tty.c_cc[VTIME] = 0;
+
+    if (cfsetispeed(&tty, speed.value()) < 0 || cfsetospeed(&tty, speed.value()) < 0 ||
+        tcsetattr(fd, TCSANOW, &tty) < 0) {
+        logger->error("could not configure tty '{}': {}", interface, strerror(errno));
+        goto tty_failed;
+    }
+
+    /* whatever the adapter sent before belongs to a previous session */
+    if (tcflush(fd, TCIOFLUSH) < 0) {
+        logger->warn("could not flush tty '{}': {}", interface, strerror(errno));
+    }
+
+    {
+        /* the transceiver closes the tty from now on */
+        const bool listen = listen_only.value() != 0;
+        /* NOLINTNEXTLINE(cppcoreguidelines-owning-memory): private constructor */
+        std::shared_ptr<slcan> created(new slcan(fd, interface, timestamps, listen, timeout_ms.value()));
+
+        std::lock_guard<std::mutex> guard(created->transmit_mutex_);
+        if (!created->write_all(reopen_commands(bitrate_code, timestamps == timestamp_mode::DEVICE,
+                                                created->listen_only_))) {
+            logger->error("could not open the channel of tty '{}'", interface);
+            return nullptr;
+        }
+
+        return std::shared_ptr<transceiver>(std::move(created));
+    }
+
+tty_failed:
+    if (close(fd) < 0) {
+        logger->error("could not close tty '{}': {}", interface, strerror(errno));
+    }
+open_failed:
+    return nullptr;
+}
+
+slcan::slcan(int fd, std::string path, timestamp_mode timestamps, bool listen_only, long transmit_timeout_ms)
+    : fd_(fd),
+      path_(std::move(path)),
+      timestamps_(timestamps),
+      listen_only_(listen_only),
+      transmit_timeout_ms_(transmit_timeout_ms),
+      buffer_{},
+      begin_(0),
+      end_(0),
+      hung_up_(false),
+      filtered_(false),
+      read_time_ns_(0),
+      device_last_ms_(0) {}
+
+slcan::~slcan() {
+    {
+        std::lock_guard<std::mutex> guard(transmit_mutex_);
+        if (!write_all("C\r")) {
+            logger->warn("could not close the channel of tty '{}'", path_);
+        }
+    }
+
+    if (close(fd_) < 0) {
+        logger->error("could not close tty '{}': {}", path_, strerror(errno));
+    }
+}
+
+bool slcan::set_bitrate(unsigned long bitrate) {
+    auto code = find_setting(BITRATES, bitrate);
+    if (!code.has_value()) {
+        logger->error("invalid bitrate specified");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+    return write_all(reopen_commands(code, std::nullopt, listen_only_));
+}
+
+bool slcan::transmit(frame::ptr msg) {
+    return transmit(msg->identifier_, {msg->bytes_, msg->length_}, msg->flags_, msg->interface_);
+}
+
+bool slcan::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t /* interface */) {
+    if (listen_only_) {
+        logger->error("can't transmit to tty '{}' in listen only mode", path_);
+        return false;
+    }
+
+    std::array<char, MAX_LINE_SIZE> line{};
+    const size_t size = format_line(identifier, bytes.size(), bytes.data(), flags, line.data());
+    if (size == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+    return write_all({line.data(), size});
+}
+
+size_t slcan::transmit_batch(const frame_batch_view& batch) {
+    if (listen_only_) {
+        logger->error("can't transmit to tty '{}' in listen only mode", path_);
+        return 0;
+    }
+
+    std::array<char, READ_SIZE> text{};
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+
+    /* lines are gathered into a single write, frames count as sent once their line is written */
+    size_t sent    = 0;
+    size_t pending = 0;
+    size_t size    = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (size + MAX_LINE_SIZE > text.size()) {
+            if (!write_all({text.data(), size})) {
+                return sent;
+            }
+
+            sent += pending;
+            pending = 0;
+            size    = 0;
+        }
+
+        auto entry   = batch[i];
+        auto written = format_line(entry.identifier_, entry.bytes_.size(), entry.bytes_.data(), entry.flags_,
+                                   &text.at(size));
+        if (written == 0) {
+            break;
+        }
+
+        size += written;
+        pending++;
+    }
+
+    if (size > 0 && write_all({text.data(), size})) {
+        sent += pending;
+    }
+
+    return sent;
+}
+
+bool slcan::write_all(std::string_view text) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (transmit_timeout_ms_ >= 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(transmit_timeout_ms_);
+    }
+
+    while (!text.empty()) {
+        ssize_t written = write(fd_, text.data(), text.size());
+        if (written >= 0) {
+            text.remove_prefix(static_cast<size_t>(written));
+            continue;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            logger->error("could not write to tty '{}': {}", path_, strerror(errno));
+            return false;
+        }
+
+        /* the output queue of the tty is full, wait for the adapter to drain it */
+        long timeout_ms = -1;
+        if (deadline.has_value()) {
+            auto remaining = deadline.value() - std::chrono::steady_clock::now();
+            timeout_ms     = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count();
+            if (timeout_ms <= 0) {
+                logger->error("output of tty '{}' stayed full", path_);
+                return false;
+            }
+        }
+
+        pollfd pfd = {.fd = fd_, .events = POLLOUT, .revents = 0};
+        if (poll(&pfd, 1, utils::crop_cast<long, int>(timeout_ms)) < 0 && errno != EINTR) {
+            logger->error("could not poll tty '{}': {}", path_, strerror(errno));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+frame::ptr slcan::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
+        return nullptr;
+    }
+
+    return msg.to_ptr();
+}
+
+bool slcan::receive_into(fd_frame& msg, long timeout_ms) {
+    return next_frame(msg, timeout_ms);
+}
+
+bool slcan::set_filter(const std::vector<uint32_t>& identifiers) {
+    std::vector<uint32_t> filter = identifiers;
+    std::sort(filter.begin(), filter.end());
+
+    std::lock_guard<std::mutex> guard(filter_mutex_);
+    filter_   = std::move(filter);
+    filtered_ = true;
+    return true;
+}
+
+bool slcan::clear_filter() {
+    std::lock_guard<std::mutex> guard(filter_mutex_);
+    filter_.clear();
+    filtered_ = false;
+    return true;
+}
+
+bool slcan::parse_next(fd_frame& msg) {
+    while (begin_ < end_) {
+        const std::string_view pending(&buffer_.at(begin_), end_ - begin_);
+        const auto terminator = pending.find_first_of(TERMINATORS);
+        if (terminator == std::string_view::npos) {
+            return false;
+        }
+
+        const auto line = pending.substr(0, terminator);
+        begin_ += terminator + 1;
+
+        auto result = parse_line(line, msg);
+        if (result == parse_result::INVALID) {
+            logger->warn("skipping invalid line '{}' from tty '{}'", line, path_);
+        }
+
+        if (result != parse_result::FRAME) {
+            continue;
+        }
+
+        /* device timestamps are converted even for filtered frames, so no wrap is missed */
+        if (timestamps_ == timestamp_mode::DEVICE && (msg.flags_ & frame::HW_TIMESTAMP) != 0) {
+            msg.timestamp_ = to_host_time(static_cast<uint16_t>(msg.timestamp_));
+        } else {
+            msg.timestamp_ = read_time_ns_;
+            msg.flags_ &= ~frame::HW_TIMESTAMP;
+        }
+
+        std::lock_guard<std::mutex> guard(filter_mutex_);
+        if (filtered_ && !std::binary_search(filter_.begin(), filter_.end(), msg.identifier_)) {
+            continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool slcan::read_more(long timeout_ms) {
+    /* move the partial line to the front, dropping it if it can't be a line */
+    if (begin_ > 0) {
+        std::copy(buffer_.begin() + static_cast<ptrdiff_t>(begin_), buffer_.begin() + static_cast<ptrdiff_t>(end_),
+                  buffer_.begin());
+        end_ -= begin_;
+        begin_ = 0;
+    }
+
+    if (end_ > MAX_LINE_SIZE) {
+        logger->warn("skipping {} characters without line end from tty '{}'", end_, path_);
+        end_ = 0;
+    }
+
+    /* the adapter is gone, like an idle bus until it is closed, but the wait may still be interrupted by a signal */
+    if (hung_up_) {
+        poll(nullptr, 0, utils::crop_cast<long, int>(timeout_ms));
+        return false;
+    }
+
+    /* non-blocking receptions read the tty straight away, saving a poll() per attempt */
+    bool hang_up = false;
+    if (timeout_ms != 0) {
+        pollfd pfd = {.fd = fd_, .events = POLLIN, .revents = 0};
+
+        int count = poll(&pfd, 1, utils::crop_cast<long, int>(timeout_ms));
+        if (count < 0) {
+            if (errno == EINTR) {
+                return true;
+            }
+
+            logger->error("could not poll tty '{}': {}", path_, strerror(errno));
+            return false;
+        }
+
+        if (count == 0) {
+            return false;
+        }
+
+        hang_up = (pfd.revents & POLLHUP) != 0;
+    }
+
+    /* without any character, the tty returns 0 rather than EAGAIN, as it doesn't wait for any (VMIN and VTIME) */
+    ssize_t length = read(fd_, &buffer_.at(end_), buffer_.size() - end_);
+    if (length == 0 && !hang_up) {
+        return timeout_ms != 0;
+    }
+
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return timeout_ms != 0;
+    }
+
+    if (length <= 0) {
+        if (length == 0) {
+            logger->error("tty '{}' was hung up", path_);
+        } else {
+            logger->error("could not read tty '{}': {}", path_, strerror(errno));
+        }
+
+        hung_up_ = true;
+        return read_more(timeout_ms);
+    }
+
+    end_ += static_cast<size_t>(length);
+    read_time_ns_ = utils::get_realtime_ns();
+    return true;
+}
+
+bool slcan::next_frame(fd_frame& msg, long timeout_ms) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout_ms > 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    while (!parse_next(msg)) {
+        long remaining_ms = timeout_ms;
+        if (deadline.has_value()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline.value() -
+                                                                                   std::chrono::steady_clock::now());
+            remaining_ms   = std::max<long>(remaining.count(), 0);
+        }
+
+        if (!read_more(remaining_ms)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t slcan::to_host_time(uint16_t device_ms) {
+    if (!device_base_ns_.has_value()) {
+        device_base_ns_ = read_time_ns_ - device_ms * MSEC_TO_NSEC;
+    } else if (device_ms < device_last_ms_) {
+        device_base_ns_ = device_base_ns_.value() + DEVICE_WRAP_NS;
+    }
+
+    device_last_ms_ = device_ms;
+
+    /* whole minutes without any frame can't be seen from the timestamps, only from the host clock */
+    uint64_t timestamp = device_base_ns_.value() + device_ms * MSEC_TO_NSEC;
+    if (read_time_ns_ > timestamp + DEVICE_WRAP_NS / 2) {
+        const uint64_t minutes = (read_time_ns_ - timestamp + DEVICE_WRAP_NS / 2) / DEVICE_WRAP_NS;
+        device_base_ns_        = device_base_ns_.value() + minutes * DEVICE_WRAP_NS;
+        timestamp += minutes * DEVICE_WRAP_NS;
+    }
+
+    return timestamp;
+}
+
+} /* namespace can::driver */
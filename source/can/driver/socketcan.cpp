@@ -1,26 +1,270 @@
 #include <linux/can.h>
+#include <linux/can/raw.h>
 #include <linux/if.h>
+#include <linux/net_tstamp.h>
 #include <linux/sockios.h>
 #include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <regex>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "libsocketcan.h"
 
 #include "can/driver/socketcan.hpp"
 #include "can/log.hpp"
 #include "can/utils/crop_cast.hpp"
+#include "can/utils/dlc.hpp"
+#include "can/utils/options.hpp"
 
 namespace can::driver {
 
-static constexpr uint64_t SEC_TO_USEC = 1e6;
+static constexpr uint64_t SEC_TO_NSEC = 1e9;
+
+/*
+ * SO_TIMESTAMPING delivers the software, legacy and raw hardware stamps of a
+ * frame at once.
+ */
+static constexpr size_t TIMESTAMPING_COUNT    = 3;
+static constexpr size_t TIMESTAMPING_SOFTWARE = 0;
+static constexpr size_t TIMESTAMPING_HARDWARE = 2;
+
+using timestamping_stamps = std::array<timespec, TIMESTAMPING_COUNT>;
+
+/*
+ * Maximum number of frames exchanged by a single recvmmsg() or sendmmsg() call.
+ */
+static constexpr size_t MAX_BATCH_SIZE = 64;
+
+static constexpr long DEFAULT_TRANSMIT_TIMEOUT_MS = 1000;
+
+/*
+ * Interval between two attempts to write to an interface whose transmit queue
+ * is full, as the socket can't signal when the interface has room again.
+ */
+static constexpr std::chrono::milliseconds INTERFACE_RETRY_INTERVAL(1);
+
+/*
+ * Room for the control messages of a received frame: its timestamps and the
+ * number of frames dropped by the socket.
+ */
+static constexpr size_t CONTROL_SIZE = CMSG_SPACE(sizeof(timestamping_stamps)) + CMSG_SPACE(sizeof(uint32_t));
+
+/*
+ * Receive buffers of a single frame, with room for its source address and
+ * control messages. The control messages are read in place as `cmsghdr`.
+ */
+struct receive_buffer {
+    canfd_frame frame_;
+    iovec iov_;
+    sockaddr_can address_;
+    alignas(cmsghdr) std::array<char, CONTROL_SIZE> control_;
+
+    void prepare(msghdr& header) {
+        iov_ = {.iov_base = &frame_, .iov_len = sizeof(frame_)};
+
+        header                = {};
+        header.msg_name       = &address_;
+        header.msg_namelen    = sizeof(address_);
+        header.msg_iov        = &iov_;
+        header.msg_iovlen     = 1;
+        header.msg_control    = control_.data();
+        header.msg_controllen = control_.size();
+    }
+};
+
+static uint64_t to_nanoseconds(const timespec& ts) {
+    return ts.tv_sec * SEC_TO_NSEC + ts.tv_nsec;
+}
+
+/*
+ * Returns the timestamp of a received frame in nanoseconds. Hardware stamps
+ * are preferred when the socket receives both, in which case the
+ * `HW_TIMESTAMP` flag is added to the frame flags.
+ */
+static uint64_t get_timestamp(msghdr& header, uint8_t& flags) {
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast): library macros */
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts{};
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return to_nanoseconds(ts);
+        }
+
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            timestamping_stamps stamps{};
+            std::memcpy(stamps.data(), CMSG_DATA(cmsg), sizeof(stamps));
+
+            uint64_t hardware = to_nanoseconds(stamps.at(TIMESTAMPING_HARDWARE));
+            if (hardware != 0) {
+                flags |= frame::HW_TIMESTAMP;
+                return hardware;
+            }
+
+            return to_nanoseconds(stamps.at(TIMESTAMPING_SOFTWARE));
+        }
+    }
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast) */
+
+    logger->warn("received frame without timestamp");
+    return 0;
+}
+
+/*
+ * Returns the total number of frames dropped by the socket, as reported by
+ * SO_RXQ_OVFL along with a received frame, or nothing if no frame was dropped
+ * yet.
+ */
+static std::optional<uint32_t> get_drop_count(msghdr& header) {
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast): library macros */
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+            uint32_t count = 0;
+            std::memcpy(&count, CMSG_DATA(cmsg), sizeof(count));
+            return count;
+        }
+    }
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast) */
+
+    return std::nullopt;
+}
+
+/*
+ * Returns the index of the interface a frame was received from, or 0 if the
+ * source address is missing.
+ */
+static uint32_t get_interface(const msghdr& header) {
+    if (header.msg_name == nullptr || header.msg_namelen < sizeof(sockaddr_can)) {
+        return 0;
+    }
+
+    sockaddr_can address{};
+    std::memcpy(&address, header.msg_name, sizeof(address));
+    return static_cast<uint32_t>(address.can_ifindex);
+}
+
+static std::optional<socketcan::transmit_policy> parse_transmit_policy(const std::string& policy) {
+    if (policy == "block") {
+        return socketcan::transmit_policy::BLOCK;
+    }
+
+    if (policy == "drop-oldest") {
+        return socketcan::transmit_policy::DROP_OLDEST;
+    }
+
+    if (policy == "fail-fast") {
+        return socketcan::transmit_policy::FAIL_FAST;
+    }
+
+    return std::nullopt;
+}
+
+static uint8_t to_canfd_flags(uint8_t flags) {
+    uint8_t canfd_flags = 0;
+#ifdef CANFD_FDF
+    canfd_flags |= CANFD_FDF;
+#endif /* CANFD_FDF */
+    canfd_flags |= ((flags & frame::BRS) != 0) ? CANFD_BRS : 0;
+    canfd_flags |= ((flags & frame::ESI) != 0) ? CANFD_ESI : 0;
+    return canfd_flags;
+}
+
+static uint8_t from_canfd_flags(uint8_t canfd_flags) {
+    uint8_t flags = frame::FD;
+    flags |= ((canfd_flags & CANFD_BRS) != 0) ? frame::BRS : 0;
+    flags |= ((canfd_flags & CANFD_ESI) != 0) ? frame::ESI : 0;
+    return flags;
+}
+
+/*
+ * This function fills a kernel frame and returns the number of bytes to
+ * write, or 0 if the frame is invalid.
+ */
+static size_t to_canfd_frame(canfd_frame& frame, uint32_t identifier, size_t length, const uint8_t* bytes,
+                             uint8_t flags) {
+    const bool is_fd = ((flags & frame::FD) != 0) || (length > CAN_MAX_DLEN);
+
+    if (CANFD_MAX_DLEN < length) {
+        logger->error("invalid message length");
+        return 0;
+    }
+
+    /* classic and FD frames share the same layout up to the payload */
+    frame        = {};
+    frame.can_id = identifier;
+    frame.len    = is_fd ? utils::dlc::pad_length(length) : length;
+    frame.flags  = is_fd ? to_canfd_flags(flags) : 0;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library function */
+    std::copy(bytes, bytes + length, frame.data);
+
+    return is_fd ? CANFD_MTU : CAN_MTU;
+}
+
+/*
+ * This function fills an inline frame from a received kernel frame.
+ */
+static void from_canfd_frame(fd_frame& msg, const canfd_frame& frame, uint64_t timestamp, uint8_t flags,
+                             uint32_t interface) {
+    msg.identifier_ = frame.can_id & CAN_SFF_MASK;
+    msg.timestamp_  = timestamp;
+    msg.length_     = std::min<size_t>(frame.len, CANFD_MAX_DLEN);
+    msg.flags_      = flags;
+    msg.interface_  = interface;
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library type */
+    std::copy(frame.data, frame.data + msg.length_, msg.bytes_.begin());
+}
+
+/*
+ * Returns the flags of a frame received from a packet ring.
+ */
+static uint8_t get_flags(const packet_ring::packet& packet) {
+    uint8_t flags = (packet.mtu_ == CANFD_MTU) ? from_canfd_flags(packet.frame_->flags) : 0;
+    return flags | (packet.hardware_timestamp_ ? frame::HW_TIMESTAMP : 0);
+}
+
+/*
+ * Enables SO_TIMESTAMPING on the socket in the specified mode, either
+ * "software" or "hardware". Software stamps are still requested in hardware
+ * mode, for frames the device doesn't stamp.
+ */
+static bool enable_timestamping(int sock, const std::string& interface, const std::string& mode) {
+    unsigned int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+    if (mode == "hardware") {
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+        /* most CAN devices stamp every frame already, so failing here isn't fatal */
+        ifreq ifr{};
+        hwtstamp_config config{.flags = 0, .tx_type = HWTSTAMP_TX_OFF, .rx_filter = HWTSTAMP_FILTER_ALL};
+        strncpy(ifr.ifr_name, interface.c_str(), IFNAMSIZ - 1);
+        ifr.ifr_data = reinterpret_cast<char*>(&config); /* NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) */
+        if (ioctl(sock, SIOCSHWTSTAMP, &ifr) < 0) {
+            logger->warn("could not configure hardware timestamps on interface '{}': {}", interface, strerror(errno));
+        }
+    } else if (mode != "software") {
+        logger->error("invalid timestamping mode '{}'", mode);
+        return false;
+    }
+
+    if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        logger->error("could not enable {} timestamps on interface '{}': {}", mode, interface, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
 
 std::list<std::string> socketcan::list_interfaces() {
     const std::regex interface_regex(".*\\/(v?can\\d+)");
@@ -39,9 +283,52 @@ std::list<std::string> socketcan::list_interfaces() {
     return interfaces;
 }
 
-socketcan::ptr socketcan::create(const std::string& interface) {
+socketcan::ptr socketcan::create(const std::string& interface, const options& options) {
     ifreq ifr{};
     sockaddr_can addr{};
+    int enable_fd_frames = 1;
+    int enable_timestamp = 1;
+    int enable_overflow  = 1;
+    std::string timestamping;
+    std::string backend = "raw";
+    std::unique_ptr<packet_ring> ring;
+    std::unique_ptr<io_ring> uring;
+    const bool any_interface = (interface == ANY_INTERFACE);
+
+    auto rcvbuf       = utils::get_integral_option<int>(options, "rcvbuf", 0);
+    auto rcvbuf_force = utils::get_integral_option<int>(options, "rcvbuf_force", 0);
+    auto busy_poll_us = utils::get_integral_option<int>(options, "busy_poll_us", 0);
+    if (!rcvbuf.has_value() || !rcvbuf_force.has_value() || !busy_poll_us.has_value()) {
+        logger->error("invalid receive options for interface '{}'", interface);
+        return nullptr;
+    }
+
+    auto sndbuf     = utils::get_integral_option<int>(options, "sndbuf", 0);
+    auto queue_size = utils::get_integral_option<size_t>(options, "tx_queue_size", 0);
+    auto timeout_ms = utils::get_integral_option<long>(options, "tx_timeout_ms", DEFAULT_TRANSMIT_TIMEOUT_MS);
+    auto policy     = parse_transmit_policy(options.contains("tx_policy") ? options.at("tx_policy") : "block");
+    if (!sndbuf.has_value() || !queue_size.has_value() || !timeout_ms.has_value() || !policy.has_value()) {
+        logger->error("invalid transmit options for interface '{}'", interface);
+        return nullptr;
+    }
+
+    if (options.contains("timestamping")) {
+        timestamping = options.at("timestamping");
+    }
+
+    if (options.contains("backend")) {
+        backend = options.at("backend");
+    }
+
+    if (backend != "raw" && backend != "mmap" && backend != "io_uring") {
+        logger->error("invalid backend '{}'", backend);
+        return nullptr;
+    }
+
+    if (any_interface && backend != "raw") {
+        logger->error("backend '{}' can't be used with every interface", backend);
+        return nullptr;
+    }
 
     int sock = socket(PF_CAN, SOCK_RAW, CAN_RAW);
     if (sock < 0) {
@@ -49,11 +336,55 @@ socketcan::ptr socketcan::create(const std::string& interface) {
         goto socket_failed;
     }
 
-    /* retrieve the interface index */
-    strncpy(ifr.ifr_name, interface.c_str(), interface.size() + 1);
-    if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
-        logger->error("could not retrieve the interface '{}': {}", interface, strerror(errno));
-        goto ioctl_failed;
+    /* receive and transmit CAN FD frames along classic frames */
+    if (setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable_fd_frames, sizeof(enable_fd_frames)) < 0) {
+        logger->warn("could not enable CAN FD frames on interface '{}': {}", interface, strerror(errno));
+    }
+
+    /* report the frames the kernel drops when the receive buffer is full */
+    if (setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &enable_overflow, sizeof(enable_overflow)) < 0) {
+        logger->warn("could not enable drop reports on interface '{}': {}", interface, strerror(errno));
+    }
+
+    if (rcvbuf.value() > 0 && setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf.value(), sizeof(rcvbuf.value())) < 0) {
+        logger->error("could not set receive buffer size on interface '{}': {}", interface, strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    if (rcvbuf_force.value() > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf_force.value(), sizeof(rcvbuf_force.value())) < 0) {
+        logger->error("could not force receive buffer size on interface '{}': {}", interface, strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    /* busy polling only helps devices whose driver uses NAPI, so it isn't fatal */
+    if (busy_poll_us.value() > 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us.value(), sizeof(busy_poll_us.value())) < 0) {
+        logger->warn("could not enable busy polling on interface '{}': {}", interface, strerror(errno));
+    }
+
+    if (sndbuf.value() > 0 && setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf.value(), sizeof(sndbuf.value())) < 0) {
+        logger->error("could not set send buffer size on interface '{}': {}", interface, strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    /* receive the timestamp of each frame along with it */
+    if (!timestamping.empty()) {
+        if (!enable_timestamping(sock, interface, timestamping)) {
+            goto setsockopt_failed;
+        }
+    } else if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &enable_timestamp, sizeof(enable_timestamp)) < 0) {
+        logger->error("could not enable timestamps on interface '{}': {}", interface, strerror(errno));
+        goto setsockopt_failed;
+    }
+
+    /* retrieve the interface index, sockets bound to index 0 use every interface */
+    if (!any_interface) {
+        strncpy(ifr.ifr_name, interface.c_str(), interface.size() + 1);
+        if (ioctl(sock, SIOCGIFINDEX, &ifr) < 0) {
+            logger->error("could not retrieve the interface '{}': {}", interface, strerror(errno));
+            goto ioctl_failed;
+        }
     }
 
     /* bind socket to interface */
@@ -66,10 +397,35 @@ socketcan::ptr socketcan::create(const std::string& interface) {
         goto bind_failed;
     }
 
-    return ptr(std::shared_ptr<socketcan>(new socketcan(sock, interface)));
+    if (backend == "mmap") {
+        ring = packet_ring::create(interface, options);
+        if (ring == nullptr) {
+            goto ring_failed;
+        }
+
+        /* frames are only received from the ring, the CAN socket would just queue them up */
+        if (setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0) < 0) {
+            logger->error("could not disable reception on interface '{}': {}", interface, strerror(errno));
+            goto ring_failed;
+        }
+    }
 
+    if (backend == "io_uring") {
+        uring = io_ring::create(sock, options);
+        if (uring == nullptr) {
+            goto uring_failed;
+        }
+    }
+
+    return ptr(std::shared_ptr<socketcan>(new socketcan(
+        sock, interface, std::move(ring), std::move(uring),
+        {.policy_ = policy.value(), .queue_size_ = queue_size.value(), .timeout_ms_ = timeout_ms.value()})));
+
+uring_failed:
+ring_failed:
 bind_failed:
 ioctl_failed:
+setsockopt_failed:
     if (close(sock) < 0) {
         logger->error("could not close socket of interface '{}': {}", interface, strerror(errno));
     }
@@ -77,7 +433,18 @@ socket_failed:
     return nullptr;
 }
 
-socketcan::socketcan(int socket, std::string interface) : socket_(socket), interface_(std::move(interface)) {}
+socketcan::socketcan(int socket, std::string interface, std::unique_ptr<packet_ring> ring,
+                     std::unique_ptr<io_ring> uring, transmit_settings transmit_settings)
+    : socket_(socket),
+      interface_(std::move(interface)),
+      any_interface_(interface_ == ANY_INTERFACE),
+      ring_(std::move(ring)),
+      uring_(std::move(uring)),
+      transmit_settings_(transmit_settings),
+      transmit_statistics_{},
+      interface_full_(false),
+      received_frames_(0),
+      dropped_frames_(0) {}
 
 socketcan::~socketcan() {
     if (close(socket_) < 0) {
@@ -88,6 +455,11 @@ socketcan::~socketcan() {
 bool socketcan::set_bitrate(unsigned long bitrate) {
     constexpr auto MAX_BITRATE = static_cast<unsigned long>(std::numeric_limits<uint32_t>::max());
 
+    if (any_interface_) {
+        logger->error("could not set bitrate of every interface at once");
+        return false;
+    }
+
     if (bitrate > MAX_BITRATE) {
         logger->error("invalid bitrate specified");
         return false;
@@ -102,38 +474,299 @@ bool socketcan::set_bitrate(unsigned long bitrate) {
 }
 
 bool socketcan::transmit(frame::ptr msg) {
-    if (CAN_MAX_DLEN < msg->length_) {
-        logger->error("invalid message length");
+    return transmit(msg->identifier_, {msg->bytes_, msg->length_}, msg->flags_, msg->interface_);
+}
+
+size_t socketcan::transmit_batch(const frame_batch_view& batch) {
+    std::array<pending_frame, MAX_BATCH_SIZE> frames;
+    std::array<iovec, MAX_BATCH_SIZE> iovs{};
+    std::array<mmsghdr, MAX_BATCH_SIZE> headers{};
+    std::array<sockaddr_can, MAX_BATCH_SIZE> addresses{};
+
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+
+    size_t sent = 0;
+    while (sent < batch.size()) {
+        /* prepare the next chunk, stopping before any invalid frame */
+        size_t count = 0;
+        while (count < MAX_BATCH_SIZE && sent + count < batch.size()) {
+            auto entry = batch[sent + count];
+            if (any_interface_ && entry.interface_ == 0) {
+                logger->error("no interface specified to transmit frame");
+                break;
+            }
+
+            auto& frame = frames.at(count);
+            frame.mtu_  = to_canfd_frame(frame.frame_, entry.identifier_, entry.bytes_.size(), entry.bytes_.data(),
+                                         entry.flags_);
+            frame.interface_ = entry.interface_;
+            if (frame.mtu_ == 0) {
+                break;
+            }
+
+            iovs.at(count)                       = {.iov_base = &frame.frame_, .iov_len = frame.mtu_};
+            headers.at(count).msg_hdr            = {};
+            headers.at(count).msg_hdr.msg_iov    = &iovs.at(count);
+            headers.at(count).msg_hdr.msg_iovlen = 1;
+
+            if (any_interface_) {
+                addresses.at(count).can_family        = AF_CAN;
+                addresses.at(count).can_ifindex       = static_cast<int>(entry.interface_);
+                headers.at(count).msg_hdr.msg_name    = &addresses.at(count);
+                headers.at(count).msg_hdr.msg_namelen = sizeof(sockaddr_can);
+            }
+
+            count++;
+        }
+
+        if (count == 0) {
+            break;
+        }
+
+        /* frames held in user space go first, the chunk follows them one by one */
+        size_t written = 0;
+        if (drain_queue()) {
+            if (uring_ != nullptr) {
+                written = uring_->transmit({iovs.data(), count}, transmit_settings_.timeout_ms_);
+            } else {
+                /* the ring must know the frames before they can be seen */
+                for (size_t i = 0; ring_ != nullptr && i < count; i++) {
+                    ring_->expect_sent(frames.at(i).frame_, frames.at(i).mtu_);
+                }
+
+                /*
+                 * The kernel stops at the first frame it can't queue. The
+                 * frames before it are sent, and the error is reported by the
+                 * next call.
+                 */
+                int result = sendmmsg(socket_, headers.data(), count, MSG_DONTWAIT);
+                if (ring_ != nullptr) {
+                    ring_->cancel_sent(count - static_cast<size_t>(std::max(result, 0)));
+                }
+
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+                        logger->error("could not write to socket: {}", strerror(errno));
+                        break;
+                    }
+
+                    interface_full_ = (errno == ENOBUFS);
+                }
+
+                written = static_cast<size_t>(std::max(result, 0));
+            }
+        }
+
+        sent += written;
+        if (written < count) {
+            /* frames whose io_uring writes are still in flight can't be sent again without duplicating them */
+            if (uring_ != nullptr && uring_->has_pending_writes()) {
+                break;
+            }
+
+            /* the interface refused the next frame, which goes through the transmit policy */
+            if (!send_frame(frames.at(written))) {
+                break;
+            }
+
+            sent++;
+        }
+    }
+
+    return sent;
+}
+
+bool socketcan::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t interface) {
+    pending_frame frame{};
+    frame.mtu_       = to_canfd_frame(frame.frame_, identifier, bytes.size(), bytes.data(), flags);
+    frame.interface_ = interface;
+    if (frame.mtu_ == 0) {
         return false;
     }
 
-    can_frame frame{};
-    frame.can_id  = msg->identifier_;
-    frame.can_dlc = msg->length_;
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): library function */
-    std::copy(msg->bytes_, msg->bytes_ + msg->length_, frame.data);
+    if (any_interface_ && interface == 0) {
+        logger->error("no interface specified to transmit frame");
+        return false;
+    }
 
-    ssize_t length = write(socket_, &frame, sizeof(frame));
-    if (length < 0) {
-        logger->error("could not write to socket: {}", strerror(errno));
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+    return send_frame(frame);
+}
+
+socketcan::write_result socketcan::write_frame(const pending_frame& frame) {
+    sockaddr_can address{};
+    address.can_family  = AF_CAN;
+    address.can_ifindex = static_cast<int>(frame.interface_);
+
+    /* the ring must know the frame before it can be seen */
+    if (ring_ != nullptr) {
+        ring_->expect_sent(frame.frame_, frame.mtu_);
+    }
+
+    auto result = write_result::WRITTEN;
+    while (true) {
+        /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast): library type */
+        ssize_t written = sendto(socket_, &frame.frame_, frame.mtu_, MSG_DONTWAIT,
+                                 any_interface_ ? (struct sockaddr*)&address : nullptr,
+                                 any_interface_ ? sizeof(address) : 0);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                interface_full_ = (errno == ENOBUFS);
+                result          = write_result::FULL;
+            } else {
+                logger->error("could not write to socket: {}", strerror(errno));
+                result = write_result::FAILED;
+            }
+        } else if (static_cast<size_t>(written) < frame.mtu_) {
+            logger->error("invalid length written");
+            result = write_result::FAILED;
+        }
+
+        break;
+    }
+
+    if (ring_ != nullptr && result != write_result::WRITTEN) {
+        ring_->cancel_sent(1);
+    }
+
+    return result;
+}
+
+bool socketcan::send_frame(const pending_frame& frame) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (transmit_settings_.timeout_ms_ >= 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(transmit_settings_.timeout_ms_);
+    }
+
+    while (true) {
+        if (drain_queue()) {
+            auto result = write_frame(frame);
+            if (result != write_result::FULL) {
+                return result == write_result::WRITTEN;
+            }
+        }
+
+        if (transmit_queue_.size() < transmit_settings_.queue_size_) {
+            transmit_queue_.push_back(frame);
+            transmit_statistics_.queued_++;
+            transmit_statistics_.max_queue_depth_ = std::max(transmit_statistics_.max_queue_depth_,
+                                                             transmit_queue_.size());
+            return true;
+        }
+
+        switch (transmit_settings_.policy_) {
+            case transmit_policy::DROP_OLDEST:
+                transmit_statistics_.dropped_++;
+                if (transmit_queue_.empty()) {
+                    return false;
+                }
+
+                transmit_queue_.pop_front();
+                transmit_queue_.push_back(frame);
+                transmit_statistics_.queued_++;
+                return true;
+
+            case transmit_policy::FAIL_FAST:
+                transmit_statistics_.rejected_++;
+                return false;
+
+            case transmit_policy::BLOCK:
+                if (!wait_for_room(deadline)) {
+                    transmit_statistics_.rejected_++;
+                    logger->error("transmit queue of interface '{}' stayed full", interface_);
+                    return false;
+                }
+                break;
+        }
+    }
+}
+
+bool socketcan::drain_queue() {
+    while (!transmit_queue_.empty()) {
+        auto result = write_frame(transmit_queue_.front());
+        if (result == write_result::FULL) {
+            return false;
+        }
+
+        if (result == write_result::FAILED) {
+            transmit_statistics_.dropped_++;
+        }
+
+        transmit_queue_.pop_front();
+    }
+
+    return true;
+}
+
+bool socketcan::wait_for_room(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+
+    const auto now = steady_clock::now();
+    if (deadline.has_value() && now >= deadline.value()) {
         return false;
     }
 
-    if (static_cast<size_t>(length) < sizeof(frame)) {
-        logger->error("invalid length written");
+    /* the socket only signals room in its own buffer, not in the queue of the interface */
+    if (interface_full_) {
+        auto interval = INTERFACE_RETRY_INTERVAL;
+        if (deadline.has_value()) {
+            interval = std::min(interval, duration_cast<milliseconds>(deadline.value() - now));
+        }
+
+        std::this_thread::sleep_for(interval);
+        return true;
+    }
+
+    long timeout_ms = -1;
+    if (deadline.has_value()) {
+        timeout_ms = static_cast<long>(duration_cast<milliseconds>(deadline.value() - now).count());
+    }
+
+    pollfd pfd = {.fd = socket_, .events = POLLOUT, .revents = 0};
+    if (poll(&pfd, 1, utils::crop_cast<long, int>(timeout_ms)) < 0 && errno != EINTR) {
+        logger->error("could not poll socket: {}", strerror(errno));
         return false;
     }
 
     return true;
 }
 
-frame::ptr socketcan::receive(long timeout_ms) {
-    /*
-     * We need to lock between poll() and ioctl() since the
-     * returned timestamp is for the last received message.
-     */
-    const std::lock_guard<std::mutex> lock(receive_mutex_);
+bool socketcan::flush(long timeout_ms) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout_ms >= 0) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+
+    while (!drain_queue()) {
+        if (!wait_for_room(deadline)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+socketcan::transmit_statistics socketcan::get_transmit_statistics() {
+    std::lock_guard<std::mutex> guard(transmit_mutex_);
+
+    auto statistics         = transmit_statistics_;
+    statistics.queue_depth_ = transmit_queue_.size();
+    return statistics;
+}
 
+bool socketcan::wait_for_frames(long timeout_ms) {
     int count = -1;
     while (count <= 0) {
         pollfd pfd = {.fd = socket_, .events = POLLIN};
@@ -145,34 +778,321 @@ frame::ptr socketcan::receive(long timeout_ms) {
             }
 
             logger->error("could not poll socket: {}", strerror(errno));
-            return nullptr;
+            return false;
         }
 
         if (count == 0) {
-            return nullptr;
+            return false;
         }
     }
 
-    can_frame frame{};
-    ssize_t length = read(socket_, &frame, sizeof(frame));
-    if (length < 0) {
-        logger->error("could not read socket: {}", strerror(errno));
+    return true;
+}
+
+frame::ptr socketcan::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
         return nullptr;
     }
 
-    if (static_cast<size_t>(length) < sizeof(frame)) {
+    return msg.to_ptr();
+}
+
+bool socketcan::receive_into(fd_frame& msg, long timeout_ms) {
+    if (ring_ != nullptr) {
+        return receive_from_ring(msg, timeout_ms);
+    }
+
+    if (uring_ != nullptr) {
+        return receive_from_uring(msg, timeout_ms);
+    }
+
+    /* non-blocking receptions read the socket straight away, saving a poll() per attempt */
+    if (timeout_ms != 0 && !wait_for_frames(timeout_ms)) {
+        return false;
+    }
+
+    msghdr header{};
+    receive_buffer buffer{};
+    buffer.prepare(header);
+
+    ssize_t length = recvmsg(socket_, &header, MSG_DONTWAIT);
+    if (length < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            logger->error("could not read socket: {}", strerror(errno));
+        }
+
+        return false;
+    }
+
+    if (length != CAN_MTU && length != CANFD_MTU) {
         logger->error("invalid length received");
-        return nullptr;
+        return false;
     }
 
-    timeval tv{};
-    if (ioctl(socket_, SIOCGSTAMP, &tv) < 0) {
-        logger->error("could not read message timestamp: {}", strerror(errno));
-        return nullptr;
+    count_received(header);
+
+    const auto& frame  = buffer.frame_;
+    uint8_t flags      = (length == CANFD_MTU) ? from_canfd_flags(frame.flags) : 0;
+    uint64_t timestamp = get_timestamp(header, flags);
+
+    from_canfd_frame(msg, frame, timestamp, flags, get_interface(header));
+    return true;
+}
+
+size_t socketcan::receive_batch(frame_batch& batch, long timeout_ms) {
+    if (ring_ != nullptr) {
+        return receive_batch_from_ring(batch, timeout_ms);
+    }
+
+    if (uring_ != nullptr) {
+        return receive_batch_from_uring(batch, timeout_ms);
+    }
+
+    const size_t count = std::min(batch.capacity() - batch.size(), MAX_BATCH_SIZE);
+    if (count == 0) {
+        return 0;
     }
-    uint64_t timestamp = tv.tv_sec * SEC_TO_USEC + tv.tv_usec;
 
-    return frame::create(frame.can_id & CAN_SFF_MASK, frame.can_dlc, frame.data, timestamp);
+    if (timeout_ms != 0 && !wait_for_frames(timeout_ms)) {
+        return 0;
+    }
+
+    std::array<receive_buffer, MAX_BATCH_SIZE> buffers;
+    std::array<mmsghdr, MAX_BATCH_SIZE> headers{};
+    for (size_t i = 0; i < count; i++) {
+        buffers.at(i).prepare(headers.at(i).msg_hdr);
+    }
+
+    int received = recvmmsg(socket_, headers.data(), count, MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            logger->error("could not read socket: {}", strerror(errno));
+        }
+
+        return 0;
+    }
+
+    size_t appended = 0;
+    for (size_t i = 0; i < static_cast<size_t>(received); i++) {
+        const auto length = headers.at(i).msg_len;
+        if (length != CAN_MTU && length != CANFD_MTU) {
+            logger->error("invalid length received");
+            continue;
+        }
+
+        count_received(headers.at(i).msg_hdr);
+
+        const auto& frame  = buffers.at(i).frame_;
+        uint8_t flags      = (length == CANFD_MTU) ? from_canfd_flags(frame.flags) : 0;
+        uint64_t timestamp = get_timestamp(headers.at(i).msg_hdr, flags);
+
+        if (!batch.push_back(frame.can_id & CAN_SFF_MASK, frame.len, frame.data, timestamp, flags,
+                             get_interface(headers.at(i).msg_hdr))) {
+            logger->error("frame of {} bytes doesn't fit in batch", frame.len);
+            continue;
+        }
+
+        appended++;
+    }
+
+    return appended;
+}
+
+void socketcan::count_received(msghdr& header) {
+    received_frames_.fetch_add(1, std::memory_order_relaxed);
+
+    auto drops = get_drop_count(header);
+    if (drops.has_value()) {
+        dropped_frames_.store(drops.value(), std::memory_order_relaxed);
+    }
+}
+
+socketcan::receive_statistics socketcan::get_receive_statistics() const {
+    receive_statistics statistics{};
+    statistics.received_ = received_frames_.load(std::memory_order_relaxed);
+    statistics.dropped_  = dropped_frames_.load(std::memory_order_relaxed);
+    if (ring_ != nullptr) {
+        statistics.dropped_ = ring_->get_drop_count();
+    }
+
+    int size              = 0;
+    socklen_t size_length = sizeof(size);
+    if (getsockopt(get_receive_socket(), SOL_SOCKET, SO_RCVBUF, &size, &size_length) < 0) {
+        logger->error("could not retrieve receive buffer size of interface '{}': {}", interface_, strerror(errno));
+    }
+
+    statistics.buffer_size_ = static_cast<size_t>(std::max(size, 0));
+    return statistics;
+}
+
+int socketcan::get_receive_socket() const {
+    return (ring_ != nullptr) ? ring_->get_socket() : socket_;
+}
+
+int socketcan::get_poll_fd() const {
+    return (uring_ != nullptr) ? uring_->get_fd() : get_receive_socket();
+}
+
+bool socketcan::receive_from_ring(fd_frame& msg, long timeout_ms) {
+    auto packet = ring_->peek(timeout_ms);
+    if (!packet.has_value()) {
+        return false;
+    }
+
+    received_frames_.fetch_add(1, std::memory_order_relaxed);
+
+    from_canfd_frame(msg, *packet->frame_, packet->timestamp_, get_flags(packet.value()), packet->interface_);
+    ring_->pop();
+
+    return true;
+}
+
+size_t socketcan::receive_batch_from_ring(frame_batch& batch, long timeout_ms) {
+    size_t appended = 0;
+
+    /* only wait for the first frame, then drain whatever the kernel already handed over */
+    while (!batch.full()) {
+        auto packet = ring_->peek(appended == 0 ? timeout_ms : 0);
+        if (!packet.has_value()) {
+            break;
+        }
+
+        const auto* frame = packet->frame_;
+        received_frames_.fetch_add(1, std::memory_order_relaxed);
+
+        if (batch.push_back(frame->can_id & CAN_SFF_MASK, frame->len, frame->data, packet->timestamp_,
+                            get_flags(packet.value()), packet->interface_)) {
+            appended++;
+        } else {
+            logger->error("frame of {} bytes doesn't fit in batch", frame->len);
+        }
+
+        ring_->pop();
+    }
+
+    return appended;
+}
+
+bool socketcan::receive_from_uring(fd_frame& msg, long timeout_ms) {
+    auto packet = uring_->peek(timeout_ms);
+    if (!packet.has_value()) {
+        return false;
+    }
+
+    count_received(packet->header_);
+
+    const auto* frame  = packet->frame_;
+    uint8_t flags      = (packet->mtu_ == CANFD_MTU) ? from_canfd_flags(frame->flags) : 0;
+    uint64_t timestamp = get_timestamp(packet->header_, flags);
+
+    from_canfd_frame(msg, *frame, timestamp, flags, get_interface(packet->header_));
+    uring_->pop();
+
+    return true;
+}
+
+size_t socketcan::receive_batch_from_uring(frame_batch& batch, long timeout_ms) {
+    size_t appended = 0;
+
+    /* only wait for the first frame, then drain the completions already posted */
+    while (!batch.full()) {
+        auto packet = uring_->peek(appended == 0 ? timeout_ms : 0);
+        if (!packet.has_value()) {
+            break;
+        }
+
+        count_received(packet->header_);
+
+        const auto* frame  = packet->frame_;
+        uint8_t flags      = (packet->mtu_ == CANFD_MTU) ? from_canfd_flags(frame->flags) : 0;
+        uint64_t timestamp = get_timestamp(packet->header_, flags);
+
+        if (batch.push_back(frame->can_id & CAN_SFF_MASK, frame->len, frame->data, timestamp, flags,
+                            get_interface(packet->header_))) {
+            appended++;
+        } else {
+            logger->error("frame of {} bytes doesn't fit in batch", frame->len);
+        }
+
+        uring_->pop();
+    }
+
+    return appended;
+}
+
+bool socketcan::set_filter(const std::vector<uint32_t>& identifiers) {
+    if (ring_ != nullptr) {
+        /* identifier filters only apply to the CAN socket, which doesn't receive in this mode */
+        return false;
+    }
+
+    if (identifiers.size() > CAN_RAW_FILTER_MAX) {
+        logger->warn("too many identifiers to filter ({}), receiving every frame", identifiers.size());
+        return clear_filter();
+    }
+
+    /*
+     * Only the standard identifier bits are compared, as they are the only ones
+     * reported in received frames.
+     */
+    std::vector<can_filter> filters;
+    filters.reserve(identifiers.size());
+    for (auto identifier : identifiers) {
+        filters.push_back({.can_id = identifier & CAN_SFF_MASK, .can_mask = CAN_SFF_MASK});
+    }
+
+    const auto size = static_cast<socklen_t>(filters.size() * sizeof(can_filter));
+    if (setsockopt(socket_, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(), size) < 0) {
+        logger->error("could not set filter: {}", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool socketcan::clear_filter() {
+    if (ring_ != nullptr) {
+        return false;
+    }
+
+    const can_filter filter = {.can_id = 0, .can_mask = 0};
+
+    if (setsockopt(socket_, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) < 0) {
+        logger->error("could not clear filter: {}", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool socketcan::attach_filter(const bpf_filter& filter) {
+    auto program = filter.compile();
+    if (program.empty()) {
+        logger->error("could not compile filter");
+        return false;
+    }
+
+    const sock_fprog fprog = {.len = static_cast<unsigned short>(program.size()), .filter = program.data()};
+
+    if (setsockopt(get_receive_socket(), SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0) {
+        logger->error("could not attach filter: {}", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool socketcan::detach_filter() {
+    const int unused = 0;
+
+    if (setsockopt(get_receive_socket(), SOL_SOCKET, SO_DETACH_FILTER, &unused, sizeof(unused)) < 0 &&
+        errno != ENOENT) {
+        logger->error("could not detach filter: {}", strerror(errno));
+        return false;
+    }
+
+    return true;
 }
 
-} /* namespace can::driver */
\ No newline at end of file
+} /* namespace can::driver */
@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+#include "can/driver/synthetic.hpp"
+#include "can/format/dbc/object.hpp"
+#include "can/log.hpp"
+#include "can/utils/clock.hpp"
+#include "can/utils/options.hpp"
+
+namespace can::driver {
+
+static constexpr uint64_t MSEC_TO_NSEC        = 1000000;
+static constexpr size_t MAX_CLASSIC_SIZE      = 8;
+static constexpr const char* GENERATOR_KEY    = "generator";
+static constexpr const char* GENERATOR_PREFIX = "generator.";
+
+/*
+ * Returns the cycle time of a message from its DBC attribute, or the fallback cycle time.
+ */
+static uint64_t get_cycle_time_ns(const database::message& message, uint64_t fallback_ms) {
+    const auto* object = dynamic_cast<const format::dbc::object*>(&message);
+    if (object != nullptr) {
+        const auto& attributes = object->get_integer_attributes();
+        auto it                = attributes.find(synthetic::CYCLE_TIME_ATTRIBUTE);
+        if (it != attributes.end() && it->second > 0) {
+            return static_cast<uint64_t>(it->second) * MSEC_TO_NSEC;
+        }
+    }
+
+    return fallback_ms * MSEC_TO_NSEC;
+}
+
+/*
+ * Returns the range of the values of a signal, from its minimum and maximum if set, or from its raw value.
+ */
+static std::pair<double, double> get_range(const database::signal& signal) {
+    auto min = signal.get_min();
+    auto max = signal.get_max();
+    if (min.has_value() && max.has_value() && min.value() < max.value()) {
+        return {min.value(), max.value()};
+    }
+
+    const int bit_count  = signal.get_bit_count();
+    const double raw_min = signal.is_signed() ? -std::ldexp(1.0, bit_count - 1) : 0.0;
+    const double raw_max = signal.is_signed() ? std::ldexp(1.0, bit_count - 1) - 1 : std::ldexp(1.0, bit_count) - 1;
+
+    const double first  = raw_min * signal.get_scale() + signal.get_offset();
+    const double second = raw_max * signal.get_scale() + signal.get_offset();
+    return {std::min(first, second), std::max(first, second)};
+}
+
+/*
+ * Parses a generator such as "constant:12.5", "ramp", "ramp:0.1" or "random".
+ */
+static std::optional<std::pair<std::string, std::optional<double>>> parse_generator(const std::string& text) {
+    auto colon = text.find(':');
+    auto name  = text.substr(0, colon);
+    if (colon == std::string::npos) {
+        return std::pair{name, std::optional<double>{}};
+    }
+
+    auto argument = std::string_view(text).substr(colon + 1);
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): string bounds */
+    const char* end = argument.data() + argument.size();
+
+    double value      = 0;
+    auto [ptr, error] = std::from_chars(argument.data(), end, value);
+    if (error != std::errc() || ptr != end || !std::isfinite(value)) {
+        return std::nullopt;
+    }
+
+    return std::pair{name, std::optional<double>{value}};
+}
+
+std::list<std::string> synthetic::list_interfaces() {
+    return {};
+}
+
+transceiver::ptr synthetic::create(const std::string& interface, const options& options) {
+    auto database = database::create(interface);
+    if (database == nullptr) {
+        logger->error("could not load database '{}'", interface);
+        return nullptr;
+    }
+
+    return create(database::const_ptr(database), options);
+}
+
+transceiver::ptr synthetic::create(database::const_ptr database, const options& options) {
+    if (database == nullptr) {
+        logger->error("no database to generate traffic from");
+        return nullptr;
+    }
+
+    auto speed         = utils::get_floating_option<double>(options, "speed", 1);
+    auto cycle_time_ms = utils::get_integral_option<uint64_t>(options, "cycle_time_ms", 0);
+    auto seed          = utils::get_integral_option<uint64_t>(options, "seed", 0);
+    if (!speed.has_value() || speed.value() < 0 || !cycle_time_ms.has_value() || !seed.has_value()) {
+        logger->error("invalid synthetic options");
+        return nullptr;
+    }
+
+    /* generators of single signals must name an existing signal */
+    for (const auto& [key, value] : options) {
+        if (!key.starts_with(GENERATOR_PREFIX)) {
+            continue;
+        }
+
+        auto name    = key.substr(std::string_view(GENERATOR_PREFIX).size());
+        auto dot     = name.find('.');
+        auto message = (dot != std::string::npos) ? database->get_message(name.substr(0, dot)) : nullptr;
+        if (message == nullptr || message->get_signal(name.substr(dot + 1)) == nullptr) {
+            logger->error("no signal for generator '{}'", key);
+            return nullptr;
+        }
+    }
+
+    const std::string fallback = options.contains(GENERATOR_KEY) ? options.at(GENERATOR_KEY) : "random";
+
+    std::vector<schedule> schedules;
+    for (const auto& message : database->get_messages()) {
+        const auto cycle_time_ns = get_cycle_time_ns(*message, cycle_time_ms.value());
+        if (cycle_time_ns == 0) {
+            continue;
+        }
+
+        auto signals = message->get_signals();
+        std::stable_partition(signals.begin(), signals.end(),
+                              [](const auto& signal) { return signal->is_multiplexer(); });
+
+        schedule entry{.message_ = message, .cycle_time_ns_ = cycle_time_ns, .enabled_ = true, .generators_ = {}};
+        for (const auto& signal : signals) {
+            if (signal->get_byte_order() == database::signal::endian::BIG) {
+                logger->error("skipping big-endian signal '{}' of message '{}'", signal->get_name(),
+                              message->get_name());
+                continue;
+            }
+
+            auto key  = GENERATOR_PREFIX + message->get_name() + "." + signal->get_name();
+            auto text = options.contains(key) ? options.at(key) : fallback;
+
+            auto parsed = parse_generator(text);
+            if (!parsed.has_value()) {
+                logger->error("invalid generator '{}' for signal '{}'", text, signal->get_name());
+                return nullptr;
+            }
+
+            auto [name, argument] = parsed.value();
+            auto [min, max]       = get_range(*signal);
+
+            generator source{.signal_ = signal,
+                             .kind_   = generator::kind::RANDOM,
+                             .min_    = min,
+                             .max_    = max,
+                             .step_   = 0,
+                             .value_  = min};
+            if (name == "constant") {
+                source.kind_  = generator::kind::CONSTANT;
+                source.value_ = argument.value_or(min);
+            } else if (name == "ramp") {
+                source.kind_ = generator::kind::RAMP;
+                source.step_ = argument.value_or(std::fabs(signal->get_scale()));
+            } else if (name != "random" || argument.has_value()) {
+                logger->error("invalid generator '{}' for signal '{}'", text, signal->get_name());
+                return nullptr;
+            }
+
+            if (source.kind_ == generator::kind::RAMP && !(source.step_ > 0)) {
+                logger->error("invalid ramp step {} for signal '{}'", source.step_, signal->get_name());
+                return nullptr;
+            }
+
+            entry.generators_.push_back(source);
+        }
+
+        schedules.push_back(std::move(entry));
+    }
+
+    if (schedules.empty()) {
+        logger->warn("no message of the database has a cycle time");
+    }
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-owning-memory): private constructor */
+    return std::shared_ptr<transceiver>(new synthetic(std::move(database), speed.value(), std::move(schedules),
+                                                      seed.value()));
+}
+
+synthetic::synthetic(database::const_ptr database, double speed, std::vector<schedule> schedules, uint64_t seed)
+    : database_(std::move(database)),
+      speed_(speed),
+      schedules_(std::move(schedules)),
+      enabled_count_(schedules_.size()),
+      random_(seed),
+      epoch_ns_(0) {
+    for (size_t i = 0; i < schedules_.size(); i++) {
+        queue_.emplace(0, schedules_[i].message_->get_identifier(), i);
+    }
+}
+
+bool synthetic::set_bitrate(unsigned long /* bitrate */) {
+    logger->error("can't set the bitrate of a synthetic transceiver");
+    return false;
+}
+
+bool synthetic::transmit(frame::ptr /* msg */) {
+    logger->error("can't transmit to a synthetic transceiver");
+    return false;
+}
+
+frame::ptr synthetic::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
+        return nullptr;
+    }
+
+    return msg.to_ptr();
+}
+
+bool synthetic::receive_into(fd_frame& msg, long timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!wait_for_next(lock, timeout_ms)) {
+        return false;
+    }
+
+    generate(msg);
+    return true;
+}
+
+bool synthetic::set_filter(const std::vector<uint32_t>& identifiers) {
+    std::vector<uint32_t> filter = identifiers;
+    std::sort(filter.begin(), filter.end());
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    enabled_count_ = 0;
+    for (auto& schedule : schedules_) {
+        schedule.enabled_ = std::binary_search(filter.begin(), filter.end(), schedule.message_->get_identifier());
+        enabled_count_ += schedule.enabled_ ? 1 : 0;
+    }
+
+    return true;
+}
+
+bool synthetic::clear_filter() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto& schedule : schedules_) {
+        schedule.enabled_ = true;
+    }
+
+    enabled_count_ = schedules_.size();
+    return true;
+}
+
+bool synthetic::wait_for_next(std::unique_lock<std::mutex>& lock, long timeout_ms) {
+    return utils::wait_for_due(lock, timeout_ms, [this](clock::time_point& due) {
+        /* filtered messages keep their cycle without being generated */
+        while (enabled_count_ > 0 && !schedules_[std::get<2>(queue_.top())].enabled_) {
+            auto [scheduled, identifier, index] = queue_.top();
+            queue_.pop();
+            queue_.emplace(scheduled + schedules_[index].cycle_time_ns_, identifier, index);
+        }
+
+        if (enabled_count_ == 0) {
+            return utils::next_state::IDLE;
+        }
+
+        if (!started_.has_value()) {
+            started_  = clock::now();
+            epoch_ns_ = utils::get_realtime_ns();
+        }
+
+        if (speed_ == 0) {
+            due = clock::time_point::min();
+            return utils::next_state::DUE;
+        }
+
+        auto scheduled = static_cast<double>(std::get<0>(queue_.top()));
+        due            = started_.value() + std::chrono::nanoseconds(static_cast<int64_t>(scheduled / speed_));
+        return utils::next_state::DUE;
+    });
+}
+
+void synthetic::generate(fd_frame& msg) {
+    auto [due, identifier, index] = queue_.top();
+    queue_.pop();
+
+    auto& schedule = schedules_[index];
+    queue_.emplace(due + schedule.cycle_time_ns_, identifier, index);
+
+    msg             = {};
+    msg.identifier_ = identifier;
+    msg.timestamp_  = epoch_ns_ + due;
+    msg.length_     = std::min<size_t>(schedule.message_->get_byte_count(), fd_frame::CAPACITY);
+    msg.flags_      = (msg.length_ > MAX_CLASSIC_SIZE) ? frame::FD : 0;
+
+    std::optional<uint64_t> multiplexer;
+    for (auto& source : schedule.generators_) {
+        /* signals multiplexed by another value are absent from the frame */
+        auto multiplexed = source.signal_->get_multiplexed_value();
+        if (multiplexed.has_value() && multiplexer.has_value() && multiplexer.value() != multiplexed.value()) {
+            continue;
+        }
+
+        auto raw_value = source.signal_->encode(static_cast<float>(next_value(source)));
+        source.signal_->insert(raw_value, msg.bytes_.data(), msg.length_);
+
+        if (source.signal_->is_multiplexer()) {
+            multiplexer = raw_value;
+        }
+    }
+}
+
+double synthetic::next_value(generator& source) {
+    switch (source.kind_) {
+        case generator::kind::CONSTANT:
+            return source.value_;
+
+        case generator::kind::RAMP: {
+            const double value = source.value_;
+            source.value_   = (value + source.step_ > source.max_) ? source.min_ : value + source.step_;
+            return value;
+        }
+
+        case generator::kind::RANDOM:
+            return std::uniform_real_distribution<double>(source.min_, source.max_)(random_);
+    }
+
+    return source.value_;
+}
+
+} /* namespace can::driver */
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <shared_mutex>
+
+#include "can/driver/virtual_can.hpp"
+#include "can/log.hpp"
+#include "can/utils/clock.hpp"
+#include "can/utils/options.hpp"
+#include "can/utils/wire.hpp"
+
+namespace can::driver {
+
+using clock = std::chrono::steady_clock;
+
+struct virtual_can::bus {
+    const std::string name_;
+    const bool virtual_time_;
+    std::atomic<unsigned long> bitrate_;
+    std::atomic<unsigned long> data_bitrate_;
+
+    /**
+     * Mutex used to protect the transceivers of the bus and their filters,
+     * held shared while frames are delivered.
+     */
+    std::shared_mutex mutex_;
+    std::vector<virtual_can*> transceivers_;
+
+    /**
+     * Mutex used to protect the bus time in virtual time, or the time at
+     * which the bus becomes idle otherwise.
+     */
+    std::mutex clock_mutex_;
+    uint64_t time_ns_;
+    clock::time_point idle_;
+
+    /**
+     * Buses by interface name, only kept alive by their transceivers.
+     */
+    static inline std::mutex registry_mutex_;
+    static inline std::map<std::string, std::weak_ptr<bus>> registry_;
+
+    bus(std::string name, bool virtual_time, unsigned long bitrate, unsigned long data_bitrate)
+        : name_(std::move(name)),
+          virtual_time_(virtual_time),
+          bitrate_(bitrate),
+          data_bitrate_(data_bitrate),
+          time_ns_(0),
+          idle_() {}
+
+    bus(const bus& other)            = delete;
+    bus& operator=(const bus& other) = delete;
+    bus(bus&& other)                 = delete;
+    bus& operator=(bus&& other)      = delete;
+
+    ~bus() {
+        std::lock_guard<std::mutex> guard(registry_mutex_);
+
+        /* the interface may already name a new bus, created once this one expired */
+        auto it = registry_.find(name_);
+        if (it != registry_.end() && it->second.expired()) {
+            registry_.erase(it);
+        }
+    }
+};
+
+std::list<std::string> virtual_can::list_interfaces() {
+    std::lock_guard<std::mutex> guard(bus::registry_mutex_);
+
+    std::list<std::string> interfaces;
+    for (const auto& [name, bus] : bus::registry_) {
+        if (!bus.expired()) {
+            interfaces.push_back(name);
+        }
+    }
+
+    return interfaces;
+}
+
+transceiver::ptr virtual_can::create(const std::string& interface, const options& options) {
+    auto loopback     = utils::get_integral_option<int>(options, "loopback", 0);
+    auto queue_size   = utils::get_integral_option<size_t>(options, "queue_size", DEFAULT_QUEUE_SIZE);
+    auto bitrate      = utils::get_integral_option<unsigned long>(options, "bitrate", 0);
+    auto data_bitrate = utils::get_integral_option<unsigned long>(options, "data_bitrate", 0);
+    auto virtual_time = utils::get_integral_option<int>(options, "virtual_time", 0);
+    if (!loopback.has_value() || !queue_size.has_value() || queue_size.value() == 0 || !bitrate.has_value() ||
+        !data_bitrate.has_value() || !virtual_time.has_value()) {
+        logger->error("invalid options for virtual interface '{}'", interface);
+        return nullptr;
+    }
+
+    std::shared_ptr<bus> shared_bus;
+    {
+        std::lock_guard<std::mutex> guard(bus::registry_mutex_);
+
+        auto it = bus::registry_.find(interface);
+        if (it != bus::registry_.end()) {
+            shared_bus = it->second.lock();
+        }
+
+        if (shared_bus == nullptr) {
+            if (virtual_time.value() != 0 && bitrate.value() == 0) {
+                logger->error("virtual time requires a bitrate on virtual interface '{}'", interface);
+                return nullptr;
+            }
+
+            shared_bus = std::make_shared<bus>(interface, virtual_time.value() != 0, bitrate.value(),
+                                               (data_bitrate.value() == 0) ? bitrate.value() : data_bitrate.value());
+            bus::registry_[interface] = shared_bus;
+        } else if (shared_bus->virtual_time_ != (virtual_time.value() != 0)) {
+            logger->error("virtual interface '{}' already exists with another time mode", interface);
+            return nullptr;
+        }
+    }
+
+    /* NOLINTNEXTLINE(cppcoreguidelines-owning-memory): private constructor */
+    std::shared_ptr<virtual_can> created(new virtual_can(shared_bus, loopback.value() != 0, queue_size.value()));
+
+    std::unique_lock<std::shared_mutex> lock(shared_bus->mutex_);
+    shared_bus->transceivers_.push_back(created.get());
+
+    return std::shared_ptr<transceiver>(std::move(created));
+}
+
+virtual_can::virtual_can(std::shared_ptr<bus> bus, bool loopback, size_t queue_size)
+    : bus_(std::move(bus)),
+      loopback_(loopback),
+      queue_(queue_size),
+      overruns_(0),
+      filtered_(false),
+      waiting_(false) {}
+
+virtual_can::~virtual_can() {
+    std::unique_lock<std::shared_mutex> lock(bus_->mutex_);
+    std::erase(bus_->transceivers_, this);
+}
+
+bool virtual_can::set_bitrate(unsigned long bitrate) {
+    if (bitrate == 0) {
+        logger->error("invalid bitrate {}", bitrate);
+        return false;
+    }
+
+    bus_->bitrate_.store(bitrate);
+    bus_->data_bitrate_.store(bitrate);
+    return true;
+}
+
+bool virtual_can::transmit(frame::ptr msg) {
+    return transmit(msg->identifier_, {msg->bytes_, msg->length_}, msg->flags_, msg->interface_);
+}
+
+bool virtual_can::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t interface) {
+    if (bytes.size() > fd_frame::CAPACITY) {
+        logger->error("frame of {} bytes can't be transmitted", bytes.size());
+        return false;
+    }
+
+    fd_frame copy{};
+    copy.identifier_ = identifier;
+    copy.length_     = bytes.size();
+    copy.flags_      = flags;
+    copy.interface_  = interface;
+    std::copy(bytes.begin(), bytes.end(), copy.bytes_.begin());
+
+    send(copy);
+    return true;
+}
+
+size_t virtual_can::transmit_batch(const frame_batch_view& batch) {
+    if (bus_->bitrate_.load() != 0) {
+        return transmitter::transmit_batch(batch);
+    }
+
+    const uint64_t timestamp = utils::get_realtime_ns();
+    size_t sent              = 0;
+
+    std::shared_lock<std::shared_mutex> lock(bus_->mutex_);
+
+    for (auto entry : batch) {
+        if (entry.bytes_.size() > fd_frame::CAPACITY) {
+            logger->error("frame of {} bytes can't be transmitted", entry.bytes_.size());
+            break;
+        }
+
+        fd_frame msg{};
+        msg.identifier_ = entry.identifier_;
+        msg.timestamp_  = timestamp;
+        msg.length_     = entry.bytes_.size();
+        msg.flags_      = static_cast<uint8_t>(entry.flags_ & ~frame::HW_TIMESTAMP);
+        std::copy(entry.bytes_.begin(), entry.bytes_.end(), msg.bytes_.begin());
+
+        deliver(msg);
+        sent++;
+    }
+
+    return sent;
+}
+
+frame::ptr virtual_can::receive(long timeout_ms) {
+    fd_frame msg{};
+    if (!receive_into(msg, timeout_ms)) {
+        return nullptr;
+    }
+
+    return msg.to_ptr();
+}
+
+bool virtual_can::receive_into(fd_frame& msg, long timeout_ms) {
+    return queue_.try_pop(msg) || (timeout_ms != 0 && wait_for_frames(timeout_ms) && queue_.try_pop(msg));
+}
+
+bool virtual_can::set_filter(const std::vector<uint32_t>& identifiers) {
+    std::vector<uint32_t> filter = identifiers;
+    std::sort(filter.begin(), filter.end());
+
+    std::unique_lock<std::shared_mutex> lock(bus_->mutex_);
+    filter_   = std::move(filter);
+    filtered_ = true;
+    return true;
+}
+
+bool virtual_can::clear_filter() {
+    std::unique_lock<std::shared_mutex> lock(bus_->mutex_);
+    filter_.clear();
+    filtered_ = false;
+    return true;
+}
+
+uint64_t virtual_can::get_overrun_count() const {
+    return overruns_.load();
+}
+
+void virtual_can::send(fd_frame& msg) {
+    msg.interface_ = 0;
+
+    const unsigned long bitrate = bus_->bitrate_.load();
+    if (bitrate == 0) {
+        msg.timestamp_ = utils::get_realtime_ns();
+        msg.flags_ &= ~frame::HW_TIMESTAMP;
+
+        std::shared_lock<std::shared_mutex> lock(bus_->mutex_);
+        deliver(msg);
+        return;
+    }
+
+    const auto bits     = utils::wire::count_bits(msg.identifier_, msg.length_, msg.bytes_.data(), msg.flags_);
+    const auto duration = utils::wire::get_duration_ns(bits, bitrate, bus_->data_bitrate_.load());
+
+    if (bus_->virtual_time_) {
+        /* the clock stays locked until the frame is delivered, so receivers see the bus time increasing */
+        std::lock_guard<std::mutex> guard(bus_->clock_mutex_);
+        bus_->time_ns_ += duration;
+
+        msg.timestamp_ = bus_->time_ns_;
+        msg.flags_ |= frame::HW_TIMESTAMP;
+
+        std::shared_lock<std::shared_mutex> lock(bus_->mutex_);
+        deliver(msg);
+        return;
+    }
+
+    /* the frame starts once the frames transmitted before it are sent */
+    clock::time_point sent;
+    {
+        std::lock_guard<std::mutex> guard(bus_->clock_mutex_);
+        sent        = std::max(clock::now(), bus_->idle_) + std::chrono::nanoseconds(duration);
+        bus_->idle_ = sent;
+    }
+
+    utils::wait_until(sent);
+
+    msg.timestamp_ = utils::get_realtime_ns();
+    msg.flags_ &= ~frame::HW_TIMESTAMP;
+
+    std::shared_lock<std::shared_mutex> lock(bus_->mutex_);
+    deliver(msg);
+}
+
+void virtual_can::deliver(const fd_frame& msg) {
+    for (auto* transceiver : bus_->transceivers_) {
+        if (transceiver != this || loopback_) {
+            transceiver->push(msg);
+        }
+    }
+}
+
+void virtual_can::push(const fd_frame& msg) {
+    if (filtered_ && !std::binary_search(filter_.begin(), filter_.end(), msg.identifier_)) {
+        return;
+    }
+
+    if (!queue_.try_push(msg)) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    /* pairs with the fence of wait_for_frames(), either the receiver sees the frame or it is seen waiting */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> guard(wait_mutex_);
+        wait_condition_.notify_one();
+    }
+}
+
+bool virtual_can::wait_for_frames(long timeout_ms) {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto available = [this]() { return !queue_.empty(); };
+
+    bool ready = true;
+    if (timeout_ms < 0) {
+        wait_condition_.wait(lock, available);
+    } else {
+        ready = wait_condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), available);
+    }
+
+    waiting_.store(false, std::memory_order_relaxed);
+    return ready;
+}
+
+} /* namespace can::driver */
@@ -2,7 +2,7 @@
 
 namespace can::format::dbc::ast {
 
-signal::signal(std::string name, unsigned char start_bit, unsigned char bit_count, endian byte_order, bool is_signed,
+signal::signal(std::string name, unsigned short start_bit, unsigned char bit_count, endian byte_order, bool is_signed,
                float scale, float offset, float min, float max, std::string unit, std::vector<std::string> nodes,
                std::variant<bool, unsigned short> multiplexing)
     : name_(std::move(name)),
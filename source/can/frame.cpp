@@ -1,18 +1,90 @@
 #include <algorithm>
+#include <array>
+#include <new>
 
 #include "can/frame.hpp"
+#include "can/utils/array_delete.hpp"
+#include "can/utils/slab_pool.hpp"
 
 namespace can {
 
-frame::ptr frame::create(uint32_t identifier, size_t length, uint8_t* bytes, uint64_t timestamp) {
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast): required for flexible array member */
-    auto* ptr        = (frame*)(new uint8_t[sizeof(frame) + length]);
+/*
+ * Payload lengths served by the frame pools, one for classic frames and one
+ * for CAN FD frames. Larger frames are always allocated from the heap.
+ */
+static constexpr std::array<size_t, 2> POOL_MAX_LENGTHS = {8, 64};
+static constexpr uint32_t POOL_BLOCK_COUNT               = 4096;
+
+/*
+ * The pools are intentionally leaked so frames released by other static
+ * objects or detached threads during exit never reach a destroyed pool.
+ */
+static std::array<utils::slab_pool*, POOL_MAX_LENGTHS.size()>& get_pools() {
+    static std::array<utils::slab_pool*, POOL_MAX_LENGTHS.size()> pools = []() {
+        std::array<utils::slab_pool*, POOL_MAX_LENGTHS.size()> pools{};
+        for (size_t i = 0; i < POOL_MAX_LENGTHS.size(); i++) {
+            /* NOLINTNEXTLINE(cppcoreguidelines-owning-memory): never freed */
+            pools.at(i) = new utils::slab_pool(sizeof(frame) + POOL_MAX_LENGTHS.at(i), POOL_BLOCK_COUNT);
+        }
+        return pools;
+    }();
+
+    return pools;
+}
+
+static void* allocate_frame(size_t length) {
+    auto& pools = get_pools();
+    for (size_t i = 0; i < POOL_MAX_LENGTHS.size(); i++) {
+        if (length <= POOL_MAX_LENGTHS.at(i)) {
+            void* block = pools.at(i)->allocate();
+            if (block != nullptr) {
+                return block;
+            }
+
+            break;
+        }
+    }
+
+    return new uint8_t[sizeof(frame) + length];
+}
+
+void frame::deleter::operator()(frame* ptr) const {
+    for (auto* pool : get_pools()) {
+        if (pool->release(ptr)) {
+            return;
+        }
+    }
+
+    utils::array_delete<uint8_t>()(ptr);
+}
+
+frame::ptr frame::create(uint32_t identifier, size_t length, const uint8_t* bytes, uint64_t timestamp,
+                         uint8_t flags, uint32_t interface) {
+    auto* ptr        = new (allocate_frame(length)) frame;
     ptr->timestamp_  = timestamp;
     ptr->identifier_ = identifier;
     ptr->length_     = length;
+    ptr->flags_      = flags;
+    ptr->interface_  = interface;
     /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): much simpler */
     std::copy(bytes, bytes + length, ptr->bytes_);
     return frame::ptr(ptr);
 }
 
-} /* namespace can */
\ No newline at end of file
+std::vector<frame::pool_statistics> frame::get_pool_statistics() {
+    std::vector<pool_statistics> statistics;
+
+    auto& pools = get_pools();
+    for (size_t i = 0; i < POOL_MAX_LENGTHS.size(); i++) {
+        statistics.push_back({
+            .max_length_ = POOL_MAX_LENGTHS.at(i),
+            .capacity_   = pools.at(i)->get_block_count(),
+            .hits_       = pools.at(i)->get_hits(),
+            .misses_     = pools.at(i)->get_misses(),
+        });
+    }
+
+    return statistics;
+}
+
+} /* namespace can */
@@ -0,0 +1,160 @@
+#include <algorithm>
+
+#include "can/frame_batch.hpp"
+
+namespace can {
+
+/*
+ * Columns are laid out by decreasing alignment in the single allocation:
+ * timestamps, identifiers, interfaces, lengths, flags and then the payload
+ * block.
+ */
+
+static size_t get_identifiers_offset(size_t capacity) {
+    return capacity * sizeof(uint64_t);
+}
+
+static size_t get_interfaces_offset(size_t capacity) {
+    return get_identifiers_offset(capacity) + capacity * sizeof(uint32_t);
+}
+
+static size_t get_lengths_offset(size_t capacity) {
+    return get_interfaces_offset(capacity) + capacity * sizeof(uint32_t);
+}
+
+static size_t get_flags_offset(size_t capacity) {
+    return get_lengths_offset(capacity) + capacity * sizeof(uint8_t);
+}
+
+static size_t get_bytes_offset(size_t capacity) {
+    return get_flags_offset(capacity) + capacity * sizeof(uint8_t);
+}
+
+/* frame_batch_view::entry class */
+
+frame::ptr frame_batch_view::entry::to_ptr() const {
+    return frame::create(identifier_, bytes_.size(), bytes_.data(), timestamp_, flags_, interface_);
+}
+
+/* frame_batch_view class */
+
+frame_batch_view::frame_batch_view(const uint32_t* identifiers, const uint64_t* timestamps, const uint8_t* lengths,
+                                   const uint8_t* flags, const uint32_t* interfaces, const uint8_t* bytes, size_t size,
+                                   size_t stride)
+    : identifiers_(identifiers),
+      timestamps_(timestamps),
+      lengths_(lengths),
+      flags_(flags),
+      interfaces_(interfaces),
+      bytes_(bytes),
+      size_(size),
+      stride_(stride) {}
+
+frame_batch_view frame_batch_view::slice(size_t begin, size_t end) const {
+    end   = std::min(end, size_);
+    begin = std::min(begin, end);
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): column offsets */
+    return {identifiers_ + begin, timestamps_ + begin, lengths_ + begin, flags_ + begin, interfaces_ + begin,
+            bytes_ + begin * stride_, end - begin, stride_};
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+}
+
+size_t frame_batch_view::find(uint32_t identifier, size_t from) const {
+    auto identifiers = get_identifiers();
+    if (from >= identifiers.size()) {
+        return size_;
+    }
+
+    auto it = std::find(identifiers.begin() + static_cast<std::ptrdiff_t>(from), identifiers.end(), identifier);
+    return static_cast<size_t>(it - identifiers.begin());
+}
+
+size_t frame_batch_view::lower_bound(uint64_t timestamp) const {
+    auto timestamps = get_timestamps();
+    auto it         = std::lower_bound(timestamps.begin(), timestamps.end(), timestamp);
+    return static_cast<size_t>(it - timestamps.begin());
+}
+
+/* frame_batch class */
+
+frame_batch::frame_batch(size_t capacity, size_t stride)
+    : frame_batch_view(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0, stride),
+      capacity_(capacity),
+      /* NOLINTNEXTLINE(modernize-avoid-c-arrays): single allocation for every column */
+      storage_(std::make_unique<std::byte[]>(get_bytes_offset(capacity) + capacity * stride)) {
+    /* NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast): columns of the single allocation */
+    columns_.timestamps_  = reinterpret_cast<uint64_t*>(storage_.get());
+    columns_.identifiers_ = reinterpret_cast<uint32_t*>(&storage_[get_identifiers_offset(capacity)]);
+    columns_.interfaces_  = reinterpret_cast<uint32_t*>(&storage_[get_interfaces_offset(capacity)]);
+    columns_.lengths_     = reinterpret_cast<uint8_t*>(&storage_[get_lengths_offset(capacity)]);
+    columns_.flags_       = reinterpret_cast<uint8_t*>(&storage_[get_flags_offset(capacity)]);
+    columns_.bytes_       = reinterpret_cast<uint8_t*>(&storage_[get_bytes_offset(capacity)]);
+    /* NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast) */
+
+    timestamps_  = columns_.timestamps_;
+    identifiers_ = columns_.identifiers_;
+    interfaces_  = columns_.interfaces_;
+    lengths_     = columns_.lengths_;
+    flags_       = columns_.flags_;
+    bytes_       = columns_.bytes_;
+}
+
+/* the columns are owned by the storage, a moved-from batch must not keep them */
+
+frame_batch::frame_batch(frame_batch&& other) noexcept
+    : frame_batch_view(other),
+      capacity_(other.capacity_),
+      columns_(other.columns_),
+      storage_(std::move(other.storage_)) {
+    other.release();
+}
+
+frame_batch& frame_batch::operator=(frame_batch&& other) noexcept {
+    if (this != &other) {
+        frame_batch_view::operator=(other);
+        capacity_ = other.capacity_;
+        columns_  = other.columns_;
+        storage_  = std::move(other.storage_);
+        other.release();
+    }
+
+    return *this;
+}
+
+void frame_batch::release() {
+    identifiers_ = nullptr;
+    timestamps_  = nullptr;
+    lengths_     = nullptr;
+    flags_       = nullptr;
+    interfaces_  = nullptr;
+    bytes_       = nullptr;
+    size_        = 0;
+    capacity_    = 0;
+    columns_     = {};
+}
+
+bool frame_batch::push_back(uint32_t identifier, size_t length, const uint8_t* bytes, uint64_t timestamp,
+                            uint8_t flags, uint32_t interface) {
+    if (full() || length > stride_ || length > UINT8_MAX) {
+        return false;
+    }
+
+    /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): owned columns */
+    columns_.identifiers_[size_] = identifier;
+    columns_.timestamps_[size_]  = timestamp;
+    columns_.lengths_[size_]     = static_cast<uint8_t>(length);
+    columns_.flags_[size_]       = flags;
+    columns_.interfaces_[size_]  = interface;
+    std::copy(bytes, bytes + length, columns_.bytes_ + size_ * stride_);
+    /* NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+
+    size_++;
+    return true;
+}
+
+bool frame_batch::push_back(const frame& frame) {
+    return push_back(frame.identifier_, frame.length_, frame.bytes_, frame.timestamp_, frame.flags_, frame.interface_);
+}
+
+} /* namespace can */
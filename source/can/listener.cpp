@@ -1,4 +1,15 @@
+#ifdef BUILD_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif /* BUILD_LINUX */
+
+#include <array>
+#include <cstring>
+#include <set>
 #include <tuple>
+#include <vector>
 
 #include "can/listener.hpp"
 #include "can/log.hpp"
@@ -6,27 +17,92 @@
 
 namespace can {
 
+/*
+ * Maximum number of frames received by a producer thread per wakeup.
+ */
+static constexpr size_t PRODUCER_BATCH_SIZE = 64;
+
+/*
+ * Maximum number of ready transceivers handled by a reactor thread per wakeup.
+ */
+static constexpr size_t REACTOR_MAX_EVENTS = 16;
+
+static void apply_filter(transceiver& transceiver, const std::optional<std::vector<uint32_t>>& filter) {
+    if (filter.has_value()) {
+        transceiver.set_filter(filter.value());
+    } else {
+        transceiver.clear_filter();
+    }
+}
+
 /* listener class */
 
-listener::listener() : consumer_thread_(&listener::consumer_thread_function, this) {}
+listener::listener() : listener(0) {}
+
+listener::listener(unsigned int io_threads) : consumer_thread_(&listener::consumer_thread_function, this) {
+#ifdef BUILD_LINUX
+    for (unsigned int i = 0; i < io_threads; i++) {
+        int epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll < 0) {
+            logger->error("could not create epoll set: {}", strerror(errno));
+            break;
+        }
+
+        auto& reactor    = reactors_.emplace_back(std::make_unique<listener::reactor>(epoll));
+        reactor->thread_ = std::make_unique<listener_thread>(&listener::reactor_thread_function, this, reactor.get());
+    }
+#endif /* BUILD_LINUX */
+
+#ifdef BUILD_WINDOWS
+    if (io_threads > 0) {
+        logger->warn("reactor mode is only available under Linux, using producer threads");
+    }
+#endif /* BUILD_WINDOWS */
+}
 
 listener::~listener() {
     shutdown();
 }
 
 quark listener::start(utils::unique_owner_ptr<transceiver> transceiver) {
+    std::lock_guard<std::mutex> filter_guard(filter_mutex_);
+    apply_filter(*transceiver, get_filter());
+
     std::lock_guard<std::mutex> guard(transceiver_mutex_);
 
     auto quark = utils::quark::get_next();
+    if (attach_to_reactor(quark, transceiver)) {
+        return quark;
+    }
+
     producer_threads_.emplace(std::piecewise_construct, std::forward_as_tuple(quark),
                               std::forward_as_tuple(&listener::producer_thread_function, this, std::move(transceiver)));
 
     return quark;
 }
 
+quark listener::start_busy_poll(utils::unique_owner_ptr<transceiver> transceiver, std::optional<unsigned int> cpu) {
+    std::lock_guard<std::mutex> filter_guard(filter_mutex_);
+    apply_filter(*transceiver, get_filter());
+
+    std::lock_guard<std::mutex> guard(transceiver_mutex_);
+
+    auto quark = utils::quark::get_next();
+    producer_threads_.emplace(
+        std::piecewise_construct, std::forward_as_tuple(quark),
+        std::forward_as_tuple(&listener::busy_poll_thread_function, this, std::move(transceiver), cpu));
+
+    return quark;
+}
+
 void listener::shutdown(quark transceiver) {
     std::lock_guard<std::mutex> guard(transceiver_mutex_);
 
+    if (detach_from_reactor(transceiver)) {
+        logger->info("shutting down transceiver [quark={}]", transceiver);
+        return;
+    }
+
     if (!producer_threads_.contains(transceiver)) {
         return;
     }
@@ -48,6 +124,10 @@ void listener::shutdown() {
         producer_thread.running_ = false;
     }
 
+    for (auto& reactor : reactors_) {
+        reactor->thread_->running_ = false;
+    }
+
     consumer_thread_.running_ = false;
 
     for (auto& [quark, producer_thread] : producer_threads_) {
@@ -56,6 +136,14 @@ void listener::shutdown() {
         }
     }
 
+    for (auto& reactor : reactors_) {
+        if (reactor->thread_->thread_.joinable()) {
+            reactor->thread_->thread_.join();
+        }
+    }
+
+    reactors_.clear();
+
     if (consumer_thread_.thread_.joinable()) {
         consumer_thread_.thread_.join();
     }
@@ -64,36 +152,264 @@ void listener::shutdown() {
 }
 
 listener::subscriber_guard::ptr listener::subscribe(callback callback, std::optional<unsigned int> identifier) {
-    std::unique_lock guard(subscriber_mutex_);
-
     auto quark = utils::quark::get_next();
-    subscribers_.emplace(std::piecewise_construct, std::forward_as_tuple(quark),
-                         std::forward_as_tuple(callback, identifier));
+
+    {
+        std::unique_lock guard(subscriber_mutex_);
+        subscribers_.emplace(std::piecewise_construct, std::forward_as_tuple(quark),
+                             std::forward_as_tuple(callback, identifier));
+    }
+
+    update_filters();
 
     return std::make_unique<subscriber_guard>(shared_from_this(), quark);
 }
 
+void listener::restrict_to(const database& database) {
+    {
+        std::unique_lock guard(subscriber_mutex_);
+        restriction_.emplace();
+        for (const auto& message : database.get_messages()) {
+            restriction_->insert(message->get_identifier());
+        }
+    }
+
+    update_filters();
+}
+
+void listener::unrestrict() {
+    {
+        std::unique_lock guard(subscriber_mutex_);
+        restriction_.reset();
+    }
+
+    update_filters();
+}
+
 void listener::unsubscribe(quark quark) {
-    std::unique_lock guard(subscriber_mutex_);
+    {
+        std::unique_lock guard(subscriber_mutex_);
+
+        if (subscribers_.contains(quark)) {
+            subscribers_.erase(quark);
+        }
+    }
+
+    update_filters();
+}
 
-    if (subscribers_.contains(quark)) {
-        subscribers_.erase(quark);
+std::optional<std::vector<uint32_t>> listener::get_filter() {
+    std::shared_lock guard(subscriber_mutex_);
+
+    std::set<uint32_t> identifiers;
+    for (const auto& [_, subscriber] : subscribers_) {
+        if (subscriber.identifier_.has_value()) {
+            identifiers.insert(subscriber.identifier_.value());
+        } else if (restriction_.has_value()) {
+            identifiers.insert(restriction_->begin(), restriction_->end());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    return std::vector<uint32_t>(identifiers.begin(), identifiers.end());
+}
+
+void listener::update_filters() {
+    std::lock_guard<std::mutex> filter_guard(filter_mutex_);
+    auto filter = get_filter();
+
+    if (filter.has_value()) {
+        logger->debug("filtering {} identifiers", filter->size());
+    } else {
+        logger->debug("receiving every frame");
+    }
+
+    std::lock_guard<std::mutex> guard(transceiver_mutex_);
+    for (auto& [_, producer_thread] : producer_threads_) {
+        apply_filter(*producer_thread.transceiver_, filter);
+    }
+
+    for (auto& reactor : reactors_) {
+        std::lock_guard<std::mutex> reactor_guard(reactor->mutex_);
+        for (auto& [_, transceiver] : reactor->transceivers_) {
+            apply_filter(*transceiver, filter);
+        }
     }
 }
 
 void listener::producer_thread_function(listener_thread* thread, utils::unique_owner_ptr<transceiver> transceiver) {
     logger->info("producer thread started");
 
+    frame_batch batch(PRODUCER_BATCH_SIZE, frame_batch::FD_STRIDE);
+    std::vector<frame::ptr> frames;
+    frames.reserve(PRODUCER_BATCH_SIZE);
+
     while (thread->running_) {
-        auto frame = transceiver->receive(1000);
-        if (frame != nullptr) {
-            frames_.push(std::move(frame));
+        batch.clear();
+        if (transceiver->receive_batch(batch, 1000) == 0) {
+            continue;
+        }
+
+        frames.clear();
+        for (auto entry : batch) {
+            frames.push_back(entry.to_ptr());
         }
+
+        frames_.push_all(frames);
     }
 
     logger->info("producer thread finished");
 }
 
+void listener::busy_poll_thread_function(listener_thread* thread, utils::unique_owner_ptr<transceiver> transceiver,
+                                         std::optional<unsigned int> cpu) {
+    logger->info("busy-poll thread started");
+
+#ifdef BUILD_LINUX
+    if (cpu.has_value()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu.value(), &set);
+
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result != 0) {
+            logger->warn("could not pin busy-poll thread to CPU {}: {}", cpu.value(), strerror(result));
+        }
+    }
+#endif /* BUILD_LINUX */
+
+#ifdef BUILD_WINDOWS
+    if (cpu.has_value()) {
+        logger->warn("CPU pinning is only available under Linux");
+    }
+#endif /* BUILD_WINDOWS */
+
+    frame_batch batch(PRODUCER_BATCH_SIZE, frame_batch::FD_STRIDE);
+
+    /* never sleep in the transceiver, and skip the consumer queue along with its wakeup */
+    while (thread->running_) {
+        batch.clear();
+        if (transceiver->receive_batch(batch, 0) == 0) {
+            continue;
+        }
+
+        for (auto entry : batch) {
+            dispatch_frame(entry.to_ptr());
+        }
+    }
+
+    logger->info("busy-poll thread finished");
+}
+
+void listener::reactor_thread_function(listener_thread* thread, reactor* reactor) {
+    logger->info("reactor thread started");
+
+#ifdef BUILD_LINUX
+    frame_batch batch(PRODUCER_BATCH_SIZE, frame_batch::FD_STRIDE);
+    std::vector<frame::ptr> frames;
+    frames.reserve(PRODUCER_BATCH_SIZE * REACTOR_MAX_EVENTS);
+
+    std::array<epoll_event, REACTOR_MAX_EVENTS> events{};
+
+    while (thread->running_) {
+        int count = epoll_wait(reactor->epoll_, events.data(), static_cast<int>(events.size()), 1000);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            logger->error("could not wait for transceivers: {}", strerror(errno));
+            break;
+        }
+
+        frames.clear();
+
+        {
+            std::lock_guard<std::mutex> guard(reactor->mutex_);
+
+            /* drain a single batch per ready transceiver, so a busy bus can't starve the others */
+            for (size_t i = 0; i < static_cast<size_t>(count); i++) {
+                auto it = reactor->transceivers_.find(events.at(i).data.u64);
+                if (it == reactor->transceivers_.end()) {
+                    continue;
+                }
+
+                batch.clear();
+                it->second->receive_batch(batch, 0);
+                for (auto entry : batch) {
+                    frames.push_back(entry.to_ptr());
+                }
+            }
+        }
+
+        if (!frames.empty()) {
+            frames_.push_all(frames);
+        }
+    }
+#endif /* BUILD_LINUX */
+
+    logger->info("reactor thread finished");
+}
+
+bool listener::attach_to_reactor(quark quark, utils::unique_owner_ptr<transceiver>& transceiver) {
+#ifdef BUILD_LINUX
+    const int fd = transceiver->get_poll_fd();
+    if (reactors_.empty() || fd < 0) {
+        return false;
+    }
+
+    reactor* target = nullptr;
+    size_t load     = 0;
+    for (auto& reactor : reactors_) {
+        std::lock_guard<std::mutex> guard(reactor->mutex_);
+        if (target == nullptr || reactor->transceivers_.size() < load) {
+            target = reactor.get();
+            load   = reactor->transceivers_.size();
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(target->mutex_);
+
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.u64 = quark;
+    if (epoll_ctl(target->epoll_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        logger->error("could not register transceiver in reactor, using a producer thread: {}", strerror(errno));
+        return false;
+    }
+
+    target->transceivers_.emplace(quark, std::move(transceiver));
+    return true;
+#endif /* BUILD_LINUX */
+
+#ifdef BUILD_WINDOWS
+    return false;
+#endif /* BUILD_WINDOWS */
+}
+
+bool listener::detach_from_reactor(quark quark) {
+#ifdef BUILD_LINUX
+    for (auto& reactor : reactors_) {
+        std::lock_guard<std::mutex> guard(reactor->mutex_);
+
+        auto it = reactor->transceivers_.find(quark);
+        if (it == reactor->transceivers_.end()) {
+            continue;
+        }
+
+        if (epoll_ctl(reactor->epoll_, EPOLL_CTL_DEL, it->second->get_poll_fd(), nullptr) < 0) {
+            logger->error("could not unregister transceiver from reactor: {}", strerror(errno));
+        }
+
+        reactor->transceivers_.erase(it);
+        return true;
+    }
+#endif /* BUILD_LINUX */
+
+    return false;
+}
+
 void listener::consumer_thread_function(listener_thread* thread) {
     logger->info("consumer thread started {}");
 
@@ -113,13 +429,27 @@ void listener::consumer_thread_function(listener_thread* thread) {
 void listener::dispatch_frame(const frame::ptr& frame) {
     std::shared_lock guard(subscriber_mutex_);
 
+    const bool restricted = restriction_.has_value() && !restriction_->contains(frame->identifier_);
+
     for (const auto& [_, subscriber] : subscribers_) {
-        if (frame->identifier_ == subscriber.identifier_.value_or(frame->identifier_)) {
+        if (subscriber.identifier_.has_value() ? (frame->identifier_ == subscriber.identifier_.value()) : !restricted) {
             subscriber.callback_(frame);
         }
     }
 }
 
+/* listener::reactor class */
+
+listener::reactor::reactor(int epoll) : epoll_(epoll) {}
+
+listener::reactor::~reactor() {
+#ifdef BUILD_LINUX
+    if (close(epoll_) < 0) {
+        logger->error("could not close epoll set: {}", strerror(errno));
+    }
+#endif /* BUILD_LINUX */
+}
+
 /* listener::raw_subscriber class */
 
 listener::subscriber::subscriber(callback callback, std::optional<unsigned int> identifier)
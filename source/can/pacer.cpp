@@ -0,0 +1,117 @@
+#include <algorithm>
+
+#include "can/log.hpp"
+#include "can/pacer.hpp"
+#include "can/utils/clock.hpp"
+#include "can/utils/wire.hpp"
+
+namespace can {
+
+static constexpr double MAX_LOAD = 100;
+
+std::shared_ptr<pacer> pacer::create(std::shared_ptr<transmitter> transmitter, unsigned long bitrate, double load,
+                                     unsigned long data_bitrate, std::chrono::nanoseconds burst) {
+    if (bitrate == 0) {
+        logger->error("invalid bitrate {}", bitrate);
+        return nullptr;
+    }
+
+    if (!(load > 0 && load <= MAX_LOAD)) {
+        logger->error("invalid bus load {}%", load);
+        return nullptr;
+    }
+
+    return std::shared_ptr<pacer>(
+        new pacer(std::move(transmitter), bitrate, load, (data_bitrate == 0) ? bitrate : data_bitrate, burst));
+}
+
+pacer::pacer(std::shared_ptr<transmitter> transmitter, unsigned long bitrate, double load, unsigned long data_bitrate,
+             std::chrono::nanoseconds burst)
+    : transmitter_(std::move(transmitter)),
+      bitrate_(bitrate),
+      data_bitrate_(data_bitrate),
+      load_(load / MAX_LOAD),
+      capacity_ns_(static_cast<double>(burst.count())),
+      tokens_ns_(capacity_ns_),
+      refilled_(clock::now()),
+      statistics_{} {}
+
+bool pacer::transmit(frame::ptr msg) {
+    const auto bits = utils::wire::count_bits(msg->identifier_, msg->length_, msg->bytes_, msg->flags_);
+    const auto time = utils::wire::get_duration_ns(bits, bitrate_, data_bitrate_);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    acquire(time);
+    bool transmitted = transmitter_->transmit(std::move(msg));
+    account(transmitted, bits.nominal_ + bits.data_, time);
+
+    return transmitted;
+}
+
+bool pacer::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t interface) {
+    const auto bits = utils::wire::count_bits(identifier, bytes.size(), bytes.data(), flags);
+    const auto time = utils::wire::get_duration_ns(bits, bitrate_, data_bitrate_);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    acquire(time);
+    bool transmitted = transmitter_->transmit(identifier, bytes, flags, interface);
+    account(transmitted, bits.nominal_ + bits.data_, time);
+
+    return transmitted;
+}
+
+pacer::statistics pacer::get_statistics() {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto statistics = statistics_;
+    if (started_.has_value()) {
+        auto elapsed           = clock::now() - started_.value();
+        statistics.elapsed_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+
+    if (statistics.elapsed_ns_ > 0) {
+        statistics.load_ = MAX_LOAD * static_cast<double>(statistics.bus_time_ns_) / statistics.elapsed_ns_;
+    }
+
+    return statistics;
+}
+
+void pacer::acquire(uint64_t bus_time_ns) {
+    auto now = clock::now();
+    if (!started_.has_value()) {
+        started_ = now;
+    }
+
+    refill(now);
+
+    /* the bucket may go into debt by a single frame, the next one then waits for it to be paid back */
+    if (tokens_ns_ < 0) {
+        auto wait = std::chrono::nanoseconds(static_cast<int64_t>(-tokens_ns_ / load_));
+        now       = utils::wait_until(now + wait);
+        refill(now);
+    }
+
+    tokens_ns_ -= static_cast<double>(bus_time_ns);
+}
+
+void pacer::refill(clock::time_point now) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - refilled_).count();
+    tokens_ns_   = std::min(capacity_ns_, tokens_ns_ + static_cast<double>(elapsed) * load_);
+    refilled_    = now;
+}
+
+void pacer::account(bool transmitted, uint64_t bits, uint64_t bus_time_ns) {
+    if (!transmitted) {
+        /* the frame never reached the bus, its refund can't overflow the bucket */
+        tokens_ns_ = std::min(capacity_ns_, tokens_ns_ + static_cast<double>(bus_time_ns));
+        return;
+    }
+
+    statistics_.frames_++;
+    statistics_.bits_ += bits;
+    statistics_.bus_time_ns_ += bus_time_ns;
+}
+
+} /* namespace can */
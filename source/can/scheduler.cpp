@@ -0,0 +1,108 @@
+#include "can/scheduler.hpp"
+#include "can/log.hpp"
+
+namespace can {
+
+scheduler::scheduler(std::shared_ptr<transmitter> transmitter, size_t capacity)
+    : transmitter_(std::move(transmitter)),
+      capacity_(capacity),
+      sequence_(0),
+      dispatching_(false),
+      running_(true),
+      statistics_{},
+      thread_(&scheduler::dispatch_thread_function, this) {}
+
+scheduler::~scheduler() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        running_ = false;
+    }
+
+    condition_.notify_all();
+    thread_.join();
+}
+
+bool scheduler::transmit(frame::ptr msg) {
+    return enqueue(std::move(msg), std::nullopt);
+}
+
+bool scheduler::transmit(frame::ptr msg, clock::time_point deadline) {
+    return enqueue(std::move(msg), deadline);
+}
+
+bool scheduler::enqueue(frame::ptr msg, std::optional<clock::time_point> deadline) {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        if (pending_.size() >= capacity_) {
+            statistics_.rejected_++;
+            logger->error("transmit scheduler is full ({} frames)", capacity_);
+            return false;
+        }
+
+        const auto identifier = msg->identifier_;
+        pending_.emplace(key(identifier, sequence_++), pending_frame{std::move(msg), deadline});
+    }
+
+    condition_.notify_all();
+    return true;
+}
+
+bool scheduler::flush(long timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto flushed = [&]() { return pending_.empty() && !dispatching_; };
+    if (timeout_ms < 0) {
+        condition_.wait(lock, flushed);
+        return true;
+    }
+
+    return condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), flushed);
+}
+
+scheduler::statistics scheduler::get_statistics() {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto statistics     = statistics_;
+    statistics.pending_ = pending_.size();
+    return statistics;
+}
+
+void scheduler::dispatch_thread_function() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        condition_.wait(lock, [&]() { return !pending_.empty() || !running_; });
+        if (!running_) {
+            break;
+        }
+
+        /* the lowest identifier wins, as it would on the bus */
+        auto node     = pending_.extract(pending_.begin());
+        auto& pending = node.mapped();
+
+        if (pending.deadline_.has_value() && clock::now() > pending.deadline_.value()) {
+            statistics_.expired_++;
+            condition_.notify_all();
+            continue;
+        }
+
+        /* the wrapped transmitter may block, frames keep being queued meanwhile */
+        dispatching_ = true;
+        lock.unlock();
+
+        bool transmitted = transmitter_->transmit(std::move(pending.frame_));
+
+        lock.lock();
+        dispatching_ = false;
+        if (transmitted) {
+            statistics_.transmitted_++;
+        } else {
+            statistics_.failed_++;
+        }
+
+        condition_.notify_all();
+    }
+}
+
+} /* namespace can */
@@ -9,12 +9,105 @@
 #include "can/driver/pcan.hpp"
 #endif /* ENABLE_DRIVER_PCAN */
 
+#ifdef ENABLE_DRIVER_REPLAY
+#include "can/driver/replay.hpp"
+#endif /* ENABLE_DRIVER_REPLAY */
+
+#ifdef ENABLE_DRIVER_SLCAN
+#include "can/driver/slcan.hpp"
+#endif /* ENABLE_DRIVER_SLCAN */
+
 #ifdef ENABLE_DRIVER_SOCKETCAN
 #include "can/driver/socketcan.hpp"
 #endif /* ENABLE_DRIVER_SOCKETCAN */
 
+#ifdef ENABLE_DRIVER_SYNTHETIC
+#include "can/driver/synthetic.hpp"
+#endif /* ENABLE_DRIVER_SYNTHETIC */
+
+#ifdef ENABLE_DRIVER_VIRTUAL
+#include "can/driver/virtual_can.hpp"
+#endif /* ENABLE_DRIVER_VIRTUAL */
+
 namespace can {
 
+/* transmitter class */
+
+bool transmitter::transmit(uint32_t identifier, std::span<const uint8_t> bytes, uint8_t flags, uint32_t interface) {
+    return transmit(frame::create(identifier, bytes.size(), bytes.data(), 0, flags, interface));
+}
+
+bool transmitter::transmit(const fd_frame& msg) {
+    return transmit(msg.identifier_, {msg.bytes_.data(), msg.length_}, msg.flags_, msg.interface_);
+}
+
+bool transmitter::transmit(const classic_frame& msg) {
+    return transmit(msg.identifier_, {msg.bytes_.data(), msg.length_}, msg.flags_, msg.interface_);
+}
+
+size_t transmitter::transmit_batch(const frame_batch_view& batch) {
+    size_t sent = 0;
+    for (auto entry : batch) {
+        if (!transmit(entry.identifier_, entry.bytes_, entry.flags_, entry.interface_)) {
+            break;
+        }
+
+        sent++;
+    }
+
+    return sent;
+}
+
+/* receiver class */
+
+bool receiver::receive_into(fd_frame& msg, long timeout_ms) {
+    auto frame = receive(timeout_ms);
+    if (frame == nullptr) {
+        return false;
+    }
+
+    auto copy = fd_frame::from(*frame);
+    if (!copy.has_value()) {
+        logger->error("frame of {} bytes doesn't fit in an inline frame", frame->length_);
+        return false;
+    }
+
+    msg = copy.value();
+    return true;
+}
+
+size_t receiver::receive_batch(frame_batch& batch, long timeout_ms) {
+    fd_frame msg{};
+    size_t appended = 0;
+    bool waited     = false;
+
+    /* only wait for the first frame, then take the frames already available */
+    while (!batch.full() && receive_into(msg, waited ? 0 : timeout_ms)) {
+        waited = true;
+        if (!batch.push_back(msg.identifier_, msg.length_, msg.bytes_.data(), msg.timestamp_, msg.flags_,
+                             msg.interface_)) {
+            logger->error("frame of {} bytes doesn't fit in batch", msg.length_);
+            continue;
+        }
+
+        appended++;
+    }
+
+    return appended;
+}
+
+bool receiver::set_filter(const std::vector<uint32_t>& /* identifiers */) {
+    return false;
+}
+
+bool receiver::clear_filter() {
+    return false;
+}
+
+int receiver::get_poll_fd() const {
+    return -1;
+}
+
 /* transceiver::ptr class */
 
 transceiver::ptr::ptr(std::nullptr_t /* ptr */) : transceiver_(nullptr), transmitter_(nullptr) {}
@@ -50,32 +143,72 @@ std::map<std::string, std::list<std::string>> transceiver::list_interfaces() {
     interfaces["pcan"] = driver::pcan::list_interfaces();
 #endif /* ENABLE_DRIVER_PCAN */
 
+#ifdef ENABLE_DRIVER_REPLAY
+    interfaces["replay"] = driver::replay::list_interfaces();
+#endif /* ENABLE_DRIVER_REPLAY */
+
+#ifdef ENABLE_DRIVER_SLCAN
+    interfaces["slcan"] = driver::slcan::list_interfaces();
+#endif /* ENABLE_DRIVER_SLCAN */
+
 #ifdef ENABLE_DRIVER_SOCKETCAN
     interfaces["socketcan"] = driver::socketcan::list_interfaces();
 #endif /* ENABLE_DRIVER_SOCKETCAN */
 
+#ifdef ENABLE_DRIVER_SYNTHETIC
+    interfaces["synthetic"] = driver::synthetic::list_interfaces();
+#endif /* ENABLE_DRIVER_SYNTHETIC */
+
+#ifdef ENABLE_DRIVER_VIRTUAL
+    interfaces["virtual"] = driver::virtual_can::list_interfaces();
+#endif /* ENABLE_DRIVER_VIRTUAL */
+
     return interfaces;
 }
 
-transceiver::ptr transceiver::create(const std::string& driver, const std::string& interface) {
+transceiver::ptr transceiver::create(const std::string& driver, const std::string& interface, const options& options) {
 #ifdef ENABLE_DRIVER_CANDLELIGHT
     if (driver == "candlelight") {
-        return driver::candlelight::create(interface);
+        return driver::candlelight::create(interface, options);
     }
 #endif /* ENABLE_DRIVER_CANDLELIGHT */
 
 #ifdef ENABLE_DRIVER_PCAN
     if (driver == "pcan") {
-        return driver::pcan::create(interface);
+        return driver::pcan::create(interface, options);
     }
 #endif /* ENABLE_DRIVER_PCAN */
 
+#ifdef ENABLE_DRIVER_REPLAY
+    if (driver == "replay") {
+        return driver::replay::create(interface, options);
+    }
+#endif /* ENABLE_DRIVER_REPLAY */
+
+#ifdef ENABLE_DRIVER_SLCAN
+    if (driver == "slcan") {
+        return driver::slcan::create(interface, options);
+    }
+#endif /* ENABLE_DRIVER_SLCAN */
+
 #ifdef ENABLE_DRIVER_SOCKETCAN
     if (driver == "socketcan") {
-        return driver::socketcan::create(interface);
+        return driver::socketcan::create(interface, options);
     }
 #endif /* ENABLE_DRIVER_SOCKETCAN */
 
+#ifdef ENABLE_DRIVER_SYNTHETIC
+    if (driver == "synthetic") {
+        return driver::synthetic::create(interface, options);
+    }
+#endif /* ENABLE_DRIVER_SYNTHETIC */
+
+#ifdef ENABLE_DRIVER_VIRTUAL
+    if (driver == "virtual") {
+        return driver::virtual_can::create(interface, options);
+    }
+#endif /* ENABLE_DRIVER_VIRTUAL */
+
     logger->error("invalid driver specified '{}'", driver);
     return nullptr;
 }
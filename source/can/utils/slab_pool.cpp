@@ -0,0 +1,78 @@
+#include "can/utils/slab_pool.hpp"
+
+namespace can::utils {
+
+static constexpr uint32_t SHIFT32 = 32;
+
+static inline uint64_t pack(uint32_t tag, uint32_t index) {
+    return (static_cast<uint64_t>(tag) << SHIFT32) | index;
+}
+
+static inline uint32_t unpack_tag(uint64_t head) {
+    return static_cast<uint32_t>(head >> SHIFT32);
+}
+
+static inline uint32_t unpack_index(uint64_t head) {
+    return static_cast<uint32_t>(head);
+}
+
+static inline size_t align_block_size(size_t block_size) {
+    constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+    return (block_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+slab_pool::slab_pool(size_t block_size, uint32_t block_count)
+    : block_size_(align_block_size(block_size)),
+      block_count_(block_count),
+      /* NOLINTNEXTLINE(modernize-avoid-c-arrays): raw storage */
+      slab_(std::make_unique<std::byte[]>(block_size_ * block_count)),
+      /* NOLINTNEXTLINE(modernize-avoid-c-arrays): one link per block */
+      next_(std::make_unique<std::atomic<uint32_t>[]>(block_count)),
+      head_(pack(0, (block_count > 0) ? 0 : NIL)),
+      hits_(0),
+      misses_(0) {
+    for (uint32_t i = 0; i < block_count; i++) {
+        next_[i].store((i + 1 < block_count) ? i + 1 : NIL, std::memory_order_relaxed);
+    }
+}
+
+void* slab_pool::allocate() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t index = unpack_index(head);
+        if (index == NIL) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        /*
+         * The link may be stale if another thread popped this block in the
+         * meantime, but the tag will then make the exchange below fail.
+         */
+        uint32_t next = next_[index].load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, pack(unpack_tag(head) + 1, next), std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic): slab indexing */
+            return slab_.get() + static_cast<size_t>(index) * block_size_;
+        }
+    }
+}
+
+bool slab_pool::release(void* ptr) {
+    if (!owns(ptr)) {
+        return false;
+    }
+
+    auto index = static_cast<uint32_t>((static_cast<std::byte*>(ptr) - slab_.get()) / block_size_);
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    do {
+        next_[index].store(unpack_index(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, pack(unpack_tag(head) + 1, index), std::memory_order_release,
+                                          std::memory_order_relaxed));
+
+    return true;
+}
+
+} /* namespace can::utils */
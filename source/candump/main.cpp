@@ -76,35 +76,35 @@ static void parse(int argc, const char* argv[]) {
 } /* namespace arg */
 
 template <>
-struct fmt::formatter<can::frame::ptr> {
+struct fmt::formatter<can::fd_frame> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext& ctx) {
         return ctx.begin();
     }
 
     template <typename FormatContext>
-    auto format(const can::frame::ptr& frame, FormatContext& ctx) {
-        auto out = fmt::format(" ({:10.6f})  ", frame->timestamp_ / 1e6);
-        out += fmt::format("{:08X}   ", frame->identifier_);
-        out += fmt::format("[{:d}]  ", frame->length_);
-        for (auto i = 0U; i < frame->length_; i++) {
-            out += fmt::format("{:02X} ", frame->bytes_[i]);
+    auto format(const can::fd_frame& frame, FormatContext& ctx) {
+        auto out = fmt::format(" ({:10.6f})  ", frame.timestamp_ / 1e9);
+        out += fmt::format("{:08X}   ", frame.identifier_);
+        out += fmt::format("[{:d}]  ", frame.length_);
+        for (auto i = 0U; i < frame.length_; i++) {
+            out += fmt::format("{:02X} ", frame.bytes_.at(i));
         }
         return fmt::format_to(ctx.out(), out);
     }
 };
 
-static bool print_message(can::database::database::ptr database, can::frame::ptr& frame) {
+static bool print_message(can::database::database::ptr database, const can::fd_frame& frame) {
     if (database == nullptr) {
         return false;
     }
 
-    auto message = database->get_message(frame->identifier_);
+    auto message = database->get_message(frame.identifier_);
     if (message == nullptr) {
         return false;
     }
 
-    auto values = message->decode(frame->bytes_, frame->length_);
+    auto values = message->decode(frame.bytes_.data(), frame.length_);
     if (values.empty()) {
         fmt::print("{}()\n", message->get_name());
     } else {
@@ -136,9 +136,9 @@ int main(int argc, const char* argv[]) {
     }
     auto transceiver = transceiver_ptr.get_unique_transceiver();
 
+    can::fd_frame frame{};
     while (true) {
-        auto frame = transceiver->receive();
-        if (frame == nullptr) {
+        if (!transceiver->receive_into(frame)) {
             continue;
         }
 
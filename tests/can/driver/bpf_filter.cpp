@@ -0,0 +1,177 @@
+#include <arpa/inet.h>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+
+#include "can/driver/bpf_filter.hpp"
+
+using can::driver::bpf_filter;
+
+/*
+ * Minimal interpreter for the instructions emitted by the filter, following
+ * the kernel semantics (loads are big endian and abort past the frame end).
+ */
+static bool run(const std::vector<sock_filter>& program, uint32_t identifier, std::initializer_list<uint8_t> bytes) {
+    canfd_frame frame{};
+    frame.can_id = identifier;
+    frame.len    = bytes.size();
+    std::copy(bytes.begin(), bytes.end(), frame.data);
+
+    const size_t size = (bytes.size() > CAN_MAX_DLEN) ? CANFD_MTU : CAN_MTU;
+    uint8_t packet[CANFD_MTU];
+    std::memcpy(packet, &frame, sizeof(frame));
+
+    uint32_t accumulator = 0;
+    for (size_t pc = 0; pc < program.size(); pc++) {
+        const auto& instruction = program.at(pc);
+
+        switch (instruction.code) {
+            case BPF_LD | BPF_W | BPF_ABS:
+                if (instruction.k + sizeof(uint32_t) > size) {
+                    return false;
+                }
+                std::memcpy(&accumulator, &packet[instruction.k], sizeof(uint32_t));
+                accumulator = ntohl(accumulator);
+                break;
+
+            case BPF_LD | BPF_B | BPF_ABS:
+                if (instruction.k >= size) {
+                    return false;
+                }
+                accumulator = packet[instruction.k];
+                break;
+
+            case BPF_ALU | BPF_AND | BPF_K:
+                accumulator &= instruction.k;
+                break;
+
+            case BPF_JMP | BPF_JA:
+                pc += instruction.k;
+                break;
+
+            case BPF_JMP | BPF_JEQ | BPF_K:
+                pc += (accumulator == instruction.k) ? instruction.jt : instruction.jf;
+                break;
+
+            case BPF_JMP | BPF_JGT | BPF_K:
+                pc += (accumulator > instruction.k) ? instruction.jt : instruction.jf;
+                break;
+
+            case BPF_RET | BPF_K:
+                return instruction.k != 0;
+
+            default:
+                assert(false);
+        }
+    }
+
+    assert(false);
+    return false;
+}
+
+static void test_identifier() {
+    auto program = bpf_filter::identifier(0x123).compile();
+    assert(!program.empty());
+
+    assert(run(program, 0x123, {}));
+    assert(!run(program, 0x124, {}));
+    assert(!run(program, 0x023, {}));
+
+    program = bpf_filter::identifier(0x120, 0x7F0).compile();
+    assert(run(program, 0x120, {}));
+    assert(run(program, 0x12F, {}));
+    assert(!run(program, 0x130, {}));
+}
+
+static void test_length() {
+    auto program = bpf_filter::length(8).compile();
+    assert(run(program, 0x1, {1, 2, 3, 4, 5, 6, 7, 8}));
+    assert(!run(program, 0x1, {1, 2, 3}));
+}
+
+static void test_bytes() {
+    auto program = (bpf_filter::byte(1, 0x04) || bpf_filter::byte(1, 0x07)).compile();
+    assert(run(program, 0x1, {0xFF, 0x04}));
+    assert(run(program, 0x1, {0xFF, 0x07, 0xFF}));
+    assert(!run(program, 0x1, {0xFF, 0x05}));
+    assert(!run(program, 0x1, {0x04}));
+    assert(!run(program, 0x1, {}));
+
+    program = bpf_filter::byte(0, 0xA0, 0xF0).compile();
+    assert(run(program, 0x1, {0xA5}));
+    assert(!run(program, 0x1, {0xB5}));
+
+    /* bytes past a classic frame are only loaded from FD frames */
+    program = (bpf_filter::byte(20, 0x42) || bpf_filter::identifier(0x1)).compile();
+    assert(run(program, 0x1, {0x00}));
+    assert(!run(program, 0x2, {0x00}));
+
+    assert(run(program, 0x2, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x42, 0, 0, 0}));
+}
+
+static void test_bits() {
+    auto program = (bpf_filter::bit(9) && !bpf_filter::bit(10)).compile();
+    assert(run(program, 0x1, {0x00, 0x02}));
+    assert(!run(program, 0x1, {0x00, 0x06}));
+    assert(!run(program, 0x1, {0x02, 0x00}));
+
+    program = bpf_filter::bit(3, false).compile();
+    assert(run(program, 0x1, {0xF7}));
+    assert(!run(program, 0x1, {0x08}));
+}
+
+static void test_multiplexed() {
+    /* keep message 0x200 only when its multiplexer byte selects page 1 or 3 */
+    auto filter  = bpf_filter::identifier(0x200) && (bpf_filter::byte(0, 1) || bpf_filter::byte(0, 3));
+    auto program = (filter || bpf_filter::identifier(0x300)).compile();
+
+    assert(run(program, 0x200, {1, 0xAA}));
+    assert(run(program, 0x200, {3, 0xAA}));
+    assert(!run(program, 0x200, {2, 0xAA}));
+    assert(run(program, 0x300, {2, 0xAA}));
+    assert(!run(program, 0x400, {1, 0xAA}));
+}
+
+static void test_long_program() {
+    /* the rejecting jumps of the first terms can't reach the end of the program directly */
+    auto filter = bpf_filter::byte(0, 0);
+    for (uint8_t i = 1; i < 64; i++) {
+        filter = filter && bpf_filter::byte(i, i);
+    }
+
+    auto program = filter.compile();
+    assert(!program.empty());
+
+    assert(run(program, 0x1, {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                              22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+                              44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63}));
+    assert(!run(program, 0x1, {1, 1, 2, 3, 4, 5, 6, 7}));
+    assert(!run(program, 0x1, {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+                               22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+                               44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 0}));
+}
+
+static void test_too_large() {
+    auto filter = bpf_filter::identifier(0);
+    for (uint32_t i = 1; i < BPF_MAXINSNS; i++) {
+        filter = filter || bpf_filter::identifier(i);
+    }
+
+    assert(filter.compile().empty());
+}
+
+int main() {
+    test_identifier();
+    test_length();
+    test_bytes();
+    test_bits();
+    test_multiplexed();
+    test_long_program();
+    test_too_large();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
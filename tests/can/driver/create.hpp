@@ -0,0 +1,33 @@
+#ifndef TESTS_CAN_DRIVER_CREATE_HPP
+#define TESTS_CAN_DRIVER_CREATE_HPP
+
+#include <cassert>
+#include <string>
+
+#include "can/transceiver.hpp"
+
+/*
+ * Helpers creating the transceivers under test, which must succeed.
+ */
+namespace test_driver {
+
+/**
+ * This function returns the transceiver held by the result of a driver.
+ */
+static inline can::utils::unique_owner_ptr<can::transceiver> unwrap(can::transceiver::ptr result) {
+    assert(result != nullptr);
+    return result.get_unique_transceiver();
+}
+
+/**
+ * This function creates a transceiver of the registered driver.
+ */
+static inline can::utils::unique_owner_ptr<can::transceiver> create(const std::string& driver,
+                                                                    const std::string& interface,
+                                                                    const can::transceiver::options& options = {}) {
+    return unwrap(can::transceiver::create(driver, interface, options));
+}
+
+} /* namespace test_driver */
+
+#endif /* TESTS_CAN_DRIVER_CREATE_HPP */
@@ -0,0 +1,240 @@
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include "fake_pcanbasic.hpp"
+
+namespace fake_pcanbasic {
+
+static constexpr std::array<TPCANHandle, 16> CHANNELS = {
+    PCAN_USBBUS1,  PCAN_USBBUS2,  PCAN_USBBUS3,  PCAN_USBBUS4,  PCAN_USBBUS5,  PCAN_USBBUS6,
+    PCAN_USBBUS7,  PCAN_USBBUS8,  PCAN_USBBUS9,  PCAN_USBBUS10, PCAN_USBBUS11, PCAN_USBBUS12,
+    PCAN_USBBUS13, PCAN_USBBUS14, PCAN_USBBUS15, PCAN_USBBUS16};
+
+static constexpr uint64_t MSEC_TO_USEC = 1000;
+static constexpr uint32_t SHIFT32      = 32;
+static constexpr BYTE MAX_DLC          = 8;
+
+struct channel_state {
+    int event_;
+    bool fd_;
+    std::deque<std::pair<TPCANMsgFD, TPCANTimestampFD>> received_;
+    std::vector<TPCANMsgFD> transmitted_;
+    size_t read_count_;
+};
+
+/*
+ * Mutex used to protect the channels, as the driver and the test run on
+ * different threads.
+ */
+static std::mutex mutex;
+static std::map<TPCANHandle, channel_state> channels;
+
+static TPCANStatus initialize(TPCANHandle handle, bool fd) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (channels.contains(handle) || std::find(CHANNELS.begin(), CHANNELS.end(), handle) == CHANNELS.end()) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+
+    int event = eventfd(0, EFD_NONBLOCK);
+    if (event < 0) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+
+    channels.emplace(handle,
+                     channel_state{.event_ = event, .fd_ = fd, .received_ = {}, .transmitted_ = {}, .read_count_ = 0});
+    return PCAN_ERROR_OK;
+}
+
+/*
+ * Pops the next received frame of a channel, clearing its event once the queue is empty. Channels opened in FD mode
+ * can only be read as such. The mutex must be held.
+ */
+static TPCANStatus pop(TPCANHandle handle, bool fd, TPCANMsgFD& frame, TPCANTimestampFD& timestamp) {
+    if (!channels.contains(handle) || channels.at(handle).fd_ != fd) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+
+    auto& channel = channels.at(handle);
+    channel.read_count_++;
+
+    if (channel.received_.empty()) {
+        return PCAN_ERROR_QRCVEMPTY;
+    }
+
+    std::tie(frame, timestamp) = channel.received_.front();
+    channel.received_.pop_front();
+
+    if (channel.received_.empty()) {
+        uint64_t value = 0;
+        if (read(channel.event_, &value, sizeof(value)) < 0) {
+            perror("could not clear receive event");
+        }
+    }
+
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus push(TPCANHandle handle, const TPCANMsgFD& frame) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (!channels.contains(handle)) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+
+    channels.at(handle).transmitted_.push_back(frame);
+    return PCAN_ERROR_OK;
+}
+
+void inject(TPCANHandle handle, const TPCANMsgFD& frame, TPCANTimestampFD timestamp) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    auto& channel = channels.at(handle);
+    if (channel.received_.empty()) {
+        uint64_t value = 1;
+        if (write(channel.event_, &value, sizeof(value)) < 0) {
+            perror("could not signal receive event");
+        }
+    }
+
+    channel.received_.emplace_back(frame, timestamp);
+}
+
+std::vector<TPCANMsgFD> take_transmitted(TPCANHandle handle) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return std::exchange(channels.at(handle).transmitted_, {});
+}
+
+size_t get_read_count(TPCANHandle handle) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return channels.at(handle).read_count_;
+}
+
+} /* namespace fake_pcanbasic */
+
+using namespace fake_pcanbasic;
+
+extern "C" {
+
+TPCANStatus CAN_Initialize(TPCANHandle channel, TPCANBaudrate /* btr0btr1 */, TPCANType /* type */,
+                           DWORD /* port */, WORD /* interrupt */) {
+    return initialize(channel, false);
+}
+
+TPCANStatus CAN_InitializeFD(TPCANHandle channel, TPCANBitrateFD /* bitrate */) {
+    return initialize(channel, true);
+}
+
+TPCANStatus CAN_Uninitialize(TPCANHandle channel) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (!channels.contains(channel)) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+
+    close(channels.at(channel).event_);
+    channels.erase(channel);
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_Read(TPCANHandle channel, TPCANMsg* message, TPCANTimestamp* timestamp) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    TPCANMsgFD frame{};
+    TPCANTimestampFD micros = 0;
+    TPCANStatus status      = pop(channel, false, frame, micros);
+    if (status != PCAN_ERROR_OK) {
+        return status;
+    }
+
+    message->ID      = frame.ID;
+    message->MSGTYPE = frame.MSGTYPE;
+    message->LEN     = std::min(frame.DLC, MAX_DLC);
+    std::memcpy(message->DATA, frame.DATA, message->LEN);
+
+    if (timestamp != nullptr) {
+        const uint64_t millis      = micros / MSEC_TO_USEC;
+        timestamp->millis          = static_cast<DWORD>(millis);
+        timestamp->millis_overflow = static_cast<WORD>(millis >> SHIFT32);
+        timestamp->micros          = static_cast<WORD>(micros % MSEC_TO_USEC);
+    }
+
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_ReadFD(TPCANHandle channel, TPCANMsgFD* message, TPCANTimestampFD* timestamp) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    TPCANTimestampFD micros = 0;
+    TPCANStatus status      = pop(channel, true, *message, micros);
+    if (status == PCAN_ERROR_OK && timestamp != nullptr) {
+        *timestamp = micros;
+    }
+
+    return status;
+}
+
+TPCANStatus CAN_Write(TPCANHandle channel, TPCANMsg* message) {
+    TPCANMsgFD frame{};
+    frame.ID      = message->ID;
+    frame.MSGTYPE = message->MSGTYPE;
+    frame.DLC     = message->LEN;
+    std::memcpy(frame.DATA, message->DATA, std::min(message->LEN, MAX_DLC));
+
+    return push(channel, frame);
+}
+
+TPCANStatus CAN_WriteFD(TPCANHandle channel, TPCANMsgFD* message) {
+    return push(channel, *message);
+}
+
+TPCANStatus CAN_GetValue(TPCANHandle channel, TPCANParameter parameter, void* buffer, DWORD length) {
+    if (parameter == PCAN_ATTACHED_CHANNELS_COUNT && length >= sizeof(DWORD)) {
+        const DWORD count = CHANNELS.size();
+        std::memcpy(buffer, &count, sizeof(count));
+        return PCAN_ERROR_OK;
+    }
+
+    if (parameter == PCAN_ATTACHED_CHANNELS && length >= CHANNELS.size() * sizeof(TPCANChannelInformation)) {
+        auto* info = static_cast<TPCANChannelInformation*>(buffer);
+        for (size_t i = 0; i < CHANNELS.size(); i++) {
+            info[i]                   = {};
+            info[i].channel_handle    = CHANNELS.at(i);
+            info[i].channel_condition = PCAN_CHANNEL_AVAILABLE;
+        }
+
+        return PCAN_ERROR_OK;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (parameter == PCAN_RECEIVE_EVENT && channels.contains(channel) && length >= sizeof(int)) {
+        std::memcpy(buffer, &channels.at(channel).event_, sizeof(int));
+        return PCAN_ERROR_OK;
+    }
+
+    return PCAN_ERROR_ILLOPERATION;
+}
+
+TPCANStatus CAN_SetValue(TPCANHandle channel, TPCANParameter /* parameter */, void* /* buffer */,
+                         DWORD /* length */) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return channels.contains(channel) ? PCAN_ERROR_OK : PCAN_ERROR_ILLOPERATION;
+}
+
+TPCANStatus CAN_GetErrorText(TPCANStatus error, WORD /* language */, char* buffer) {
+    /* the caller provides 256 bytes */
+    snprintf(buffer, 256, "fake PCAN-Basic error 0x%x", static_cast<unsigned int>(error));
+    return PCAN_ERROR_OK;
+}
+
+} /* extern "C" */
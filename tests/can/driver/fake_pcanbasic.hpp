@@ -0,0 +1,36 @@
+#ifndef TESTS_CAN_DRIVER_FAKE_PCANBASIC_HPP
+#define TESTS_CAN_DRIVER_FAKE_PCANBASIC_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "PCANBasic.h"
+
+/*
+ * In-process stand-in for the PCAN-Basic library, so the pcan driver can be
+ * tested without PEAK hardware. Every USB channel is attached and available.
+ * Frames injected into a channel are returned by `CAN_Read()`/`CAN_ReadFD()`,
+ * frames written to it are recorded, and its receive event is a level
+ * triggered eventfd, readable while frames are queued.
+ */
+namespace fake_pcanbasic {
+
+/**
+ * This function queues a frame to be received from the channel.
+ */
+void inject(TPCANHandle channel, const TPCANMsgFD& frame, TPCANTimestampFD timestamp);
+
+/**
+ * This function returns and clears the frames written to the channel.
+ */
+std::vector<TPCANMsgFD> take_transmitted(TPCANHandle channel);
+
+/**
+ * This function returns the number of read calls made on the channel,
+ * including the calls that found the queue empty.
+ */
+size_t get_read_count(TPCANHandle channel);
+
+} /* namespace fake_pcanbasic */
+
+#endif /* TESTS_CAN_DRIVER_FAKE_PCANBASIC_HPP */
@@ -0,0 +1,166 @@
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <span>
+
+#include "fake_pcanbasic.hpp"
+
+#include "can/driver/pcan.hpp"
+
+static TPCANMsgFD make_frame(uint32_t identifier, uint8_t length) {
+    TPCANMsgFD frame{};
+    frame.ID      = identifier;
+    frame.MSGTYPE = PCAN_MESSAGE_STANDARD;
+    frame.DLC     = length;
+    for (uint8_t i = 0; i < length; i++) {
+        frame.DATA[i] = static_cast<uint8_t>(identifier + i);
+    }
+
+    return frame;
+}
+
+static void test_interfaces() {
+    auto interfaces = can::driver::pcan::list_interfaces();
+    assert(interfaces.size() == 16);
+    assert(interfaces.front() == "PCAN_USBBUS1");
+
+    assert(can::driver::pcan::create("PCAN_USBBUS42") == nullptr);
+}
+
+static void test_receive() {
+    auto result = can::driver::pcan::create("PCAN_USBBUS1");
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    assert(transceiver != nullptr);
+
+    assert(transceiver->receive(0) == nullptr);
+    assert(transceiver->receive(10) == nullptr);
+
+    fake_pcanbasic::inject(PCAN_USBBUS1, make_frame(0x123, 4), 1001001);
+
+    auto frame = transceiver->receive(1000);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x123);
+    assert(frame->length_ == 4);
+    assert(frame->bytes_[3] == static_cast<uint8_t>(0x123 + 3));
+    assert(frame->timestamp_ == 1001001000);
+    assert(frame->flags_ == can::frame::HW_TIMESTAMP);
+}
+
+static void test_receive_batch() {
+    auto result = can::driver::pcan::create("PCAN_USBBUS2");
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    assert(transceiver != nullptr);
+
+    constexpr size_t FRAME_COUNT = 100;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        fake_pcanbasic::inject(PCAN_USBBUS2, make_frame(i, 8), i);
+    }
+
+    /* a single wakeup drains the queue until the batch is full */
+    can::frame_batch batch(64);
+    assert(transceiver->receive_batch(batch, 1000) == 64);
+    assert(batch[63].identifier_ == 63);
+    assert(batch[63].bytes_[7] == 63 + 7);
+    assert(fake_pcanbasic::get_read_count(PCAN_USBBUS2) == 64);
+
+    batch.clear();
+    assert(transceiver->receive_batch(batch, 1000) == FRAME_COUNT - 64);
+    assert(batch[0].identifier_ == 64);
+
+    batch.clear();
+    assert(transceiver->receive_batch(batch, 0) == 0);
+    assert(transceiver->receive_batch(batch, 10) == 0);
+}
+
+static void test_transmit() {
+    auto result = can::driver::pcan::create("PCAN_USBBUS3", {{"fd_bitrate", "f_clock_mhz=80"}});
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    assert(transceiver != nullptr);
+
+    std::array<uint8_t, 64> bytes{};
+    assert(transceiver->transmit(can::frame::create(0x100, 8, bytes.data())));
+    assert(transceiver->transmit(can::frame::create(0x200, 64, bytes.data(), 0, can::frame::FD | can::frame::BRS)));
+    assert(transceiver->transmit(0x300, std::span<const uint8_t>(bytes).first(12), can::frame::FD));
+
+    auto transmitted = fake_pcanbasic::take_transmitted(PCAN_USBBUS3);
+    assert(transmitted.size() == 3);
+    assert(transmitted.at(0).ID == 0x100 && transmitted.at(0).DLC == 8);
+    assert(transmitted.at(1).ID == 0x200 && transmitted.at(1).DLC == 15);
+    assert((transmitted.at(1).MSGTYPE & PCAN_MESSAGE_BRS) != 0);
+    assert(transmitted.at(2).ID == 0x300 && transmitted.at(2).DLC == 9);
+    assert((transmitted.at(2).MSGTYPE & PCAN_MESSAGE_BRS) == 0);
+
+    /* frames of CAN FD channels are received with their flags */
+    auto frame    = make_frame(0x300, 15);
+    frame.MSGTYPE = PCAN_MESSAGE_FD;
+    fake_pcanbasic::inject(PCAN_USBBUS3, frame, 0);
+
+    auto received = transceiver->receive(1000);
+    assert(received != nullptr);
+    assert(received->length_ == 64);
+    assert(received->flags_ == (can::frame::FD | can::frame::HW_TIMESTAMP));
+
+    /* frames can also be received into a caller frame */
+    fake_pcanbasic::inject(PCAN_USBBUS3, frame, 0);
+
+    can::fd_frame inline_frame{};
+    assert(transceiver->receive_into(inline_frame, 1000));
+    assert(inline_frame.identifier_ == 0x300 && inline_frame.length_ == 64);
+    assert(inline_frame.flags_ == (can::frame::FD | can::frame::HW_TIMESTAMP));
+    assert(!transceiver->receive_into(inline_frame, 0));
+}
+
+/*
+ * Compares the throughput of single and batched receptions on a backlog of frames.
+ */
+static void test_throughput() {
+    auto result = can::driver::pcan::create("PCAN_USBBUS4");
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    assert(transceiver != nullptr);
+
+    constexpr size_t FRAME_COUNT = 100000;
+
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        fake_pcanbasic::inject(PCAN_USBBUS4, make_frame(i & 0x7FF, 8), i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        assert(transceiver->receive(1000) != nullptr);
+    }
+    std::chrono::duration<double> single = std::chrono::steady_clock::now() - start;
+
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        fake_pcanbasic::inject(PCAN_USBBUS4, make_frame(i & 0x7FF, 8), i);
+    }
+
+    can::frame_batch batch(64);
+    size_t received = 0;
+
+    start = std::chrono::steady_clock::now();
+    while (received < FRAME_COUNT) {
+        batch.clear();
+        received += transceiver->receive_batch(batch, 1000);
+    }
+    std::chrono::duration<double> batched = std::chrono::steady_clock::now() - start;
+
+    printf("single: %.0f frames/s, batched: %.0f frames/s\n", FRAME_COUNT / single.count(),
+           FRAME_COUNT / batched.count());
+}
+
+int main() {
+    test_interfaces();
+    test_receive();
+    test_receive_batch();
+    test_transmit();
+    test_throughput();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "create.hpp"
+
+#include "can/driver/replay.hpp"
+#include "can/listener.hpp"
+
+/*
+ * Capture of 50 ms with a classic frame, a CAN FD frame switching bitrate, a
+ * remote frame, a comment and an invalid line.
+ */
+static constexpr const char* CAPTURE = "# recorded on the bench\n"
+                                       "(1000.000000) can0 123#DEADBEEF\n"
+                                       "(1000.010000) can0 456##1000102030405060708090A0B\n"
+                                       "(1000.020000) can0 789#R\n"
+                                       "not a frame\n"
+                                       "\n"
+                                       "(1000.050000) can1 7FF#\n";
+
+static constexpr uint64_t FIRST_TIMESTAMP = 1000000000000;
+static constexpr uint64_t DURATION_NS     = 50000000;
+
+/* shift of each pass, the duration plus the average interval of the 3 frames */
+static constexpr uint64_t PASS_NS = DURATION_NS + DURATION_NS / 2;
+
+static std::string write_capture(const std::string& name, const std::string& content) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path);
+    file << content;
+    return path.string();
+}
+
+static void test_create() {
+    auto path = write_capture("test_replay_create.log", CAPTURE);
+
+    assert(can::transceiver::create("replay", path + ".missing") == nullptr);
+    assert(can::transceiver::create("replay", path, {{"speed", "-1"}}) == nullptr);
+    assert(can::transceiver::create("replay", path, {{"speed", "fast"}}) == nullptr);
+    assert(can::transceiver::create("replay", path, {{"remap", "123"}}) == nullptr);
+
+    auto transceiver = test_driver::create("replay", path);
+    assert(!transceiver->set_bitrate(500000));
+    assert(!transceiver->transmit(can::classic_frame{}));
+
+    std::filesystem::remove(path);
+}
+
+static void test_receive() {
+    auto path        = write_capture("test_replay_receive.log", CAPTURE);
+    auto transceiver = test_driver::create("replay", path, {{"speed", "0"}});
+
+    auto frame = transceiver->receive(0);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x123);
+    assert(frame->length_ == 4);
+    assert(frame->bytes_[0] == 0xDE && frame->bytes_[3] == 0xEF);
+    assert(frame->timestamp_ == FIRST_TIMESTAMP);
+    assert(frame->flags_ == 0);
+
+    frame = transceiver->receive(0);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x456);
+    assert(frame->length_ == 12);
+    assert(frame->bytes_[11] == 0x0B);
+    assert(frame->timestamp_ == FIRST_TIMESTAMP + 10000000);
+    assert(frame->flags_ == (can::frame::FD | can::frame::BRS));
+
+    /* the remote frame and the invalid line are skipped */
+    frame = transceiver->receive(0);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x7FF);
+    assert(frame->length_ == 0);
+
+    assert(transceiver->receive(0) == nullptr);
+    assert(transceiver->receive(10) == nullptr);
+    assert(dynamic_cast<can::driver::replay*>(transceiver.get())->finished());
+
+    /* a blocking receive returns at once when the capture is over */
+    assert(transceiver->receive() == nullptr);
+
+    std::filesystem::remove(path);
+}
+
+static void test_repeat() {
+    auto path        = write_capture("test_replay_repeat.log", CAPTURE);
+    auto transceiver =
+        test_driver::create("replay", path, {{"speed", "0"}, {"repeat", "3"}, {"remap", "123:321,7FF:0"}});
+
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+    assert(transceiver->receive_batch(batch, 0) == 9);
+    assert(transceiver->receive_batch(batch, 0) == 0);
+
+    /* each pass starts an average frame interval after the end of the previous one */
+    for (size_t pass = 0; pass < 3; pass++) {
+        assert(batch[pass * 3].identifier_ == 0x321);
+        assert(batch[pass * 3].timestamp_ == FIRST_TIMESTAMP + pass * PASS_NS);
+        assert(batch[pass * 3 + 2].identifier_ == 0);
+    }
+
+    for (size_t i = 1; i < 9; i++) {
+        assert(batch[i].timestamp_ > batch[i - 1].timestamp_);
+    }
+
+    auto forever = test_driver::create("replay", path, {{"speed", "0"}, {"repeat", "0"}});
+    assert(forever->set_filter({0x456}));
+
+    batch.clear();
+    assert(forever->receive_batch(batch, 0) == 16);
+    assert(batch[15].identifier_ == 0x456);
+    assert(batch[15].timestamp_ == FIRST_TIMESTAMP + 10000000 + 15 * PASS_NS);
+
+    /* a filter rejecting every frame doesn't end the capture */
+    assert(forever->set_filter({0x999}));
+    assert(forever->receive(10) == nullptr);
+    assert(!dynamic_cast<can::driver::replay*>(forever.get())->finished());
+
+    /* a blocking receive waits until the filter accepts frames again */
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(forever->clear_filter());
+    });
+    assert(forever->receive() != nullptr);
+    thread.join();
+
+    std::filesystem::remove(path);
+}
+
+static void test_speed() {
+    auto path = write_capture("test_replay_speed.log", CAPTURE);
+
+    /* frames are received as they become due, relative to the first one */
+    for (auto [speed, duration] : {std::pair{"1", DURATION_NS}, std::pair{"5", DURATION_NS / 5}}) {
+        auto transceiver = test_driver::create("replay", path, {{"speed", speed}});
+
+        auto start = std::chrono::steady_clock::now();
+        assert(transceiver->receive(0) != nullptr);
+        assert(transceiver->receive(0) == nullptr);
+        assert(transceiver->receive(1000) != nullptr);
+        assert(transceiver->receive(1000) != nullptr);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        assert(static_cast<uint64_t>(elapsed.count()) >= duration);
+    }
+
+    std::filesystem::remove(path);
+}
+
+static void test_listener() {
+    constexpr size_t FRAME_COUNT = 10000;
+
+    std::string capture;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        capture += "(" + std::to_string(1000 + i) + ".000000) can0 " + std::to_string(100 + i % 100) + "#0102\n";
+    }
+
+    /* hours of recorded traffic, through the usual listener path at full speed */
+    auto path     = write_capture("test_replay_listener.log", capture);
+    auto listener = std::make_shared<can::listener>();
+
+    std::atomic_size_t received = 0;
+    auto guard = listener->subscribe([&](const can::frame::ptr& /* frame */) { received++; });
+    auto quark = listener->start(test_driver::create("replay", path, {{"speed", "0"}}));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (received < FRAME_COUNT && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    assert(received == FRAME_COUNT);
+    listener->shutdown(quark);
+
+    std::filesystem::remove(path);
+}
+
+static void test_subscriptions() {
+    auto path     = write_capture("test_replay_subscriptions.log", CAPTURE);
+    auto listener = std::make_shared<can::listener>();
+
+    std::atomic_size_t received = 0;
+    auto guard = listener->subscribe([&](const can::frame::ptr& /* frame */) { received++; }, 0x123);
+    auto quark = listener->start(test_driver::create("replay", path, {{"speed", "0"}, {"repeat", "0"}}));
+
+    /* filters are pushed down to the transceiver while the producer thread reads the capture */
+    for (size_t i = 0; i < 1000; i++) {
+        auto other = listener->subscribe([](const can::frame::ptr& /* frame */) {}, 0x456 + i % 2);
+        other->unsubscribe();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (received == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    assert(received > 0);
+    listener->shutdown(quark);
+
+    std::filesystem::remove(path);
+}
+
+int main() {
+    test_create();
+    test_receive();
+    test_repeat();
+    test_speed();
+    test_listener();
+    test_subscriptions();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "create.hpp"
+
+#include "can/driver/slcan.hpp"
+
+/*
+ * Pseudo terminal standing for the adapter: the driver opens the tty, the test plays the adapter on the master side.
+ */
+class adapter {
+   public:
+    adapter() : master_(posix_openpt(O_RDWR | O_NOCTTY)) {
+        assert(master_ >= 0);
+        assert(grantpt(master_) == 0);
+        assert(unlockpt(master_) == 0);
+        path_ = ptsname(master_);
+    }
+
+    adapter(const adapter&)            = delete;
+    adapter& operator=(const adapter&) = delete;
+
+    ~adapter() {
+        if (master_ >= 0) {
+            close(master_);
+        }
+    }
+
+    [[nodiscard]] const std::string& path() const { return path_; }
+
+    /*
+     * Closes the master side, as when the adapter is unplugged.
+     */
+    void hang_up() {
+        close(master_);
+        master_ = -1;
+    }
+
+    void send(const std::string& text) const {
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t result = write(master_, text.data() + written, text.size() - written);
+            assert(result > 0);
+            written += static_cast<size_t>(result);
+        }
+    }
+
+    /*
+     * Returns what the driver wrote, waiting until it stops writing for a while.
+     */
+    [[nodiscard]] std::string received(int timeout_ms = 100) const {
+        std::string text;
+        std::array<char, 4096> buffer{};
+
+        pollfd pfd = {.fd = master_, .events = POLLIN, .revents = 0};
+        while (poll(&pfd, 1, timeout_ms) > 0) {
+            ssize_t length = read(master_, buffer.data(), buffer.size());
+            if (length <= 0) {
+                break;
+            }
+
+            text.append(buffer.data(), static_cast<size_t>(length));
+        }
+
+        return text;
+    }
+
+   private:
+    int master_;
+    std::string path_;
+};
+
+static can::fd_frame make_frame(uint32_t identifier, std::initializer_list<uint8_t> bytes, uint8_t flags = 0) {
+    can::fd_frame frame{};
+    frame.identifier_ = identifier;
+    frame.length_     = bytes.size();
+    frame.flags_      = flags;
+    std::copy(bytes.begin(), bytes.end(), frame.bytes_.begin());
+    return frame;
+}
+
+static void test_create() {
+    adapter adapter;
+
+    assert(can::transceiver::create("slcan", "/dev/missing-tty") == nullptr);
+    assert(can::transceiver::create("slcan", adapter.path(), {{"baudrate", "1234"}}) == nullptr);
+    assert(can::transceiver::create("slcan", adapter.path(), {{"bitrate", "123"}}) == nullptr);
+    assert(can::transceiver::create("slcan", adapter.path(), {{"timestamps", "gps"}}) == nullptr);
+    assert(can::transceiver::create("slcan", adapter.path(), {{"listen_only", "yes"}}) == nullptr);
+
+    /* the channel is opened when created, and closed when destroyed */
+    {
+        auto transceiver = test_driver::create("slcan", adapter.path());
+        assert(adapter.received() == "C\rZ0\rO\r");
+
+        assert(transceiver->set_bitrate(250000));
+        assert(adapter.received() == "C\rS5\rO\r");
+        assert(!transceiver->set_bitrate(300000));
+    }
+
+    assert(adapter.received() == "C\r");
+
+    auto transceiver = test_driver::create("slcan", adapter.path(),
+                                           {{"bitrate", "500000"},
+                                            {"timestamps", "device"},
+                                            {"listen_only", "1"},
+                                            {"baudrate", "921600"}});
+    assert(adapter.received() == "C\rS6\rZ1\rL\r");
+    assert(!transceiver->transmit(make_frame(0x123, {})));
+}
+
+static void test_receive() {
+    adapter adapter;
+    auto transceiver = test_driver::create("slcan", adapter.path());
+    (void)adapter.received();
+
+    /* frames of every type, among a remote frame, replies and an invalid line */
+    adapter.send("t1234DEADBEEF\r"
+                 "T1ABCDEF02c0fe\r"
+                 "r1230\r"
+                 "z\r\a"
+                 "V1013\r"
+                 "t12391\r"
+                 "d7FF9000102030405060708090A0B\r"
+                 "B1FFFFFFF0\r");
+
+    auto frame = transceiver->receive(100);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x123 && frame->length_ == 4 && frame->flags_ == 0);
+    assert(frame->bytes_[0] == 0xDE && frame->bytes_[3] == 0xEF);
+
+    frame = transceiver->receive(100);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x1ABCDEF0 && frame->length_ == 2);
+    assert(frame->bytes_[0] == 0xC0 && frame->bytes_[1] == 0xFE);
+
+    frame = transceiver->receive(100);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x7FF && frame->length_ == 12 && frame->flags_ == can::frame::FD);
+    assert(frame->bytes_[11] == 0x0B);
+
+    frame = transceiver->receive(100);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x1FFFFFFF && frame->length_ == 0);
+    assert(frame->flags_ == (can::frame::FD | can::frame::BRS));
+
+    assert(transceiver->receive(0) == nullptr);
+    assert(transceiver->receive(10) == nullptr);
+
+    /* lines split across reads */
+    adapter.send("t45");
+    assert(transceiver->receive(10) == nullptr);
+    adapter.send("61AA\r");
+
+    frame = transceiver->receive(100);
+    assert(frame != nullptr && frame->identifier_ == 0x456 && frame->bytes_[0] == 0xAA);
+
+    /* only the frames of the filter are received */
+    assert(transceiver->set_filter({0x200}));
+    adapter.send("t1000\rt2000\rt3000\r");
+
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+    assert(transceiver->receive_batch(batch, 100) == 1);
+    assert(batch[0].identifier_ == 0x200);
+
+    assert(transceiver->clear_filter());
+    adapter.send("t1000\rt2000\r");
+
+    batch.clear();
+    assert(transceiver->receive_batch(batch, 100) == 2);
+}
+
+static void test_hang_up() {
+    adapter adapter;
+    auto transceiver = test_driver::create("slcan", adapter.path());
+    (void)adapter.received();
+
+    /* a hung up tty is waited for like an idle bus */
+    adapter.hang_up();
+
+    auto start = std::chrono::steady_clock::now();
+    assert(transceiver->receive(50) == nullptr);
+    assert(transceiver->receive(50) == nullptr);
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(90));
+
+    /* a blocking receive only returns when interrupted by a signal */
+    struct sigaction action = {};
+    action.sa_handler       = [](int /* signal */) {};
+    assert(sigaction(SIGUSR1, &action, nullptr) == 0);
+
+    std::atomic_bool returned = false;
+    std::thread reader([&]() {
+        assert(transceiver->receive() == nullptr);
+        returned = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!returned);
+
+    while (!returned) {
+        pthread_kill(reader.native_handle(), SIGUSR1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    reader.join();
+}
+
+static void test_concurrent_filter() {
+    adapter adapter;
+    auto transceiver = test_driver::create("slcan", adapter.path());
+    (void)adapter.received();
+
+    std::atomic_bool running    = true;
+    std::atomic_size_t received = 0;
+    std::thread reader([&]() {
+        can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+        while (running) {
+            batch.clear();
+            received += transceiver->receive_batch(batch, 10);
+        }
+    });
+
+    /* filters of varying sizes are swapped while frames are parsed */
+    for (size_t i = 0; i < 1000; i++) {
+        adapter.send("t1000\rt2000\r");
+
+        std::vector<uint32_t> filter(i % 16 + 1, 0x100);
+        assert(transceiver->set_filter(filter));
+        assert(transceiver->clear_filter());
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (received == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    running = false;
+    reader.join();
+    assert(received > 0);
+}
+
+static void test_transmit() {
+    adapter adapter;
+    auto transceiver = test_driver::create("slcan", adapter.path());
+    (void)adapter.received();
+
+    assert(transceiver->transmit(make_frame(0x123, {0xDE, 0xAD, 0xBE, 0xEF})));
+    assert(adapter.received() == "t1234DEADBEEF\r");
+
+    assert(transceiver->transmit(make_frame(0x1ABCDEF0, {0xC0, 0xFE})));
+    assert(adapter.received() == "T1ABCDEF02C0FE\r");
+
+    /* CAN FD payloads are padded to the length of their DLC */
+    auto fd = make_frame(0x456, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, can::frame::FD | can::frame::BRS);
+    assert(transceiver->transmit(fd));
+    assert(adapter.received() == "b4569000102030405060708090000\r");
+
+    assert(!transceiver->transmit(make_frame(0x20000000, {})));
+    assert(adapter.received().empty());
+
+    /* batches are written at once, up to the first invalid frame */
+    can::frame_batch batch(8, can::frame_batch::FD_STRIDE);
+    const std::array<uint8_t, 1> byte = {0x11};
+    assert(batch.push_back(0x001, byte.size(), byte.data(), 0, 0));
+    assert(batch.push_back(0x002, 0, nullptr, 0, can::frame::FD));
+    assert(batch.push_back(0x40000000, 0, nullptr, 0, 0));
+    assert(batch.push_back(0x003, 0, nullptr, 0, 0));
+
+    assert(transceiver->transmit_batch(batch) == 2);
+    assert(adapter.received() == "t001111\rd0020\r");
+}
+
+static void test_timestamps() {
+    using std::chrono::system_clock;
+
+    adapter adapter;
+    auto host = test_driver::create("slcan", adapter.path());
+
+    auto before = system_clock::now().time_since_epoch();
+    adapter.send("t1001AA1234\r");
+    auto frame = host->receive(100);
+    auto after = system_clock::now().time_since_epoch();
+
+    /* host timestamps are taken when the line is read, device timestamps are ignored */
+    assert(frame != nullptr && (frame->flags_ & can::frame::HW_TIMESTAMP) == 0);
+    assert(frame->timestamp_ >= static_cast<uint64_t>(std::chrono::nanoseconds(before).count()));
+    assert(frame->timestamp_ <= static_cast<uint64_t>(std::chrono::nanoseconds(after).count()));
+
+    auto device = test_driver::create("slcan", adapter.path(), {{"timestamps", "device"}});
+    adapter.send("t1001AA1234\rt1001AA1236\rt1001AAEA5F\rt1001AA0001\r");
+
+    can::frame_batch batch(8, can::frame_batch::FD_STRIDE);
+    assert(device->receive_batch(batch, 100) == 4);
+
+    /* device timestamps keep their spacing, across the wrap of their minute */
+    assert((batch[0].flags_ & can::frame::HW_TIMESTAMP) != 0);
+    assert(batch[1].timestamp_ - batch[0].timestamp_ == 2000000);
+    assert(batch[2].timestamp_ - batch[0].timestamp_ == (0xEA5F - 0x1234) * 1000000ULL);
+    assert(batch[3].timestamp_ - batch[2].timestamp_ == 2000000);
+}
+
+static void test_throughput() {
+    constexpr size_t FRAME_COUNT = 20000;
+
+    adapter adapter;
+    auto transceiver = test_driver::create("slcan", adapter.path());
+    (void)adapter.received();
+
+    /* CAN FD frames of 64 bytes streamed by the adapter, received in batches */
+    std::thread writer([&]() {
+        std::string payload;
+        for (size_t i = 0; i < 64; i++) {
+            payload += "5A";
+        }
+
+        std::string chunk;
+        for (size_t i = 0; i < FRAME_COUNT; i++) {
+            chunk += "d" + std::string(1, "01234567"[i % 8]) + "00F" + payload + "\r";
+            if (chunk.size() > 4096) {
+                adapter.send(chunk);
+                chunk.clear();
+            }
+        }
+
+        adapter.send(chunk);
+    });
+
+    size_t received = 0;
+    can::frame_batch batch(64, can::frame_batch::FD_STRIDE);
+    auto start = std::chrono::steady_clock::now();
+
+    while (received < FRAME_COUNT) {
+        batch.clear();
+        size_t count = transceiver->receive_batch(batch, 1000);
+        assert(count > 0);
+
+        for (size_t i = 0; i < count; i++) {
+            assert(batch[i].identifier_ == ((received + i) % 8) << 8U);
+            assert(batch[i].bytes_.size() == 64 && batch[i].bytes_[63] == 0x5A);
+        }
+
+        received += count;
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "received " << FRAME_COUNT << " frames of 64 bytes in " << elapsed << " s" << std::endl;
+
+    writer.join();
+}
+
+int main() {
+    test_create();
+    test_receive();
+    test_hang_up();
+    test_concurrent_filter();
+    test_transmit();
+    test_timestamps();
+    test_throughput();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
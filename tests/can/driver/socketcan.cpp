@@ -1,7 +1,10 @@
+#include <net/if.h>
 #include <array>
 #include <cassert>
 #include <cstdio>
+#include <ctime>
 #include <iostream>
+#include <string>
 #include <utility>
 
 #include "can/driver/socketcan.hpp"
@@ -53,6 +56,386 @@ static void test_interface(const std::string& device) {
     }
 }
 
+static void test_interface_batch(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device);
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    constexpr size_t FRAME_COUNT = 100;
+
+    std::array<uint8_t, 8> bytes{};
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        bytes[0]      = i;
+        auto send_msg = can::frame::create(i, bytes.size(), bytes.data());
+        assert(transceiver1->transmit(std::move(send_msg)));
+    }
+
+    can::frame_batch batch(FRAME_COUNT);
+    while (!batch.full()) {
+        assert(transceiver2->receive_batch(batch, 1000) > 0);
+    }
+
+    uint64_t last_timestamp = 0;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        auto entry = batch[i];
+        assert(entry.identifier_ == static_cast<uint32_t>(i));
+        assert(entry.bytes_.size() == bytes.size());
+        assert(entry.bytes_[0] == static_cast<uint8_t>(i));
+        assert(entry.timestamp_ >= last_timestamp);
+        last_timestamp = entry.timestamp_;
+    }
+
+    printf("received %zu frames in batches\n", batch.size());
+}
+
+static void test_interface_transmit_batch(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device);
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    constexpr size_t FRAME_COUNT = 100;
+
+    std::array<uint8_t, 8> bytes{};
+    can::frame_batch send_batch(FRAME_COUNT);
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        bytes[0] = i;
+        assert(send_batch.push_back(i, bytes.size(), bytes.data()));
+    }
+    assert(transceiver1->transmit_batch(send_batch) == FRAME_COUNT);
+
+    can::frame_batch batch(FRAME_COUNT);
+    while (!batch.full()) {
+        assert(transceiver2->receive_batch(batch, 1000) > 0);
+    }
+
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        auto entry = batch[i];
+        assert(entry.identifier_ == static_cast<uint32_t>(i));
+        assert(entry.bytes_.size() == bytes.size());
+        assert(entry.bytes_[0] == static_cast<uint8_t>(i));
+    }
+
+    printf("transmitted %zu frames in batches\n", send_batch.size());
+}
+
+static void test_interface_filter(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device);
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    assert(transceiver2->set_filter({0x101, 0x103}));
+
+    std::array<uint8_t, 8> bytes{};
+    for (uint32_t identifier = 0x100; identifier < 0x105; identifier++) {
+        assert(transceiver1->transmit(can::frame::create(identifier, bytes.size(), bytes.data())));
+    }
+
+    auto recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr && recv_msg->identifier_ == 0x101);
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr && recv_msg->identifier_ == 0x103);
+    assert(transceiver2->receive(100) == nullptr);
+
+    assert(transceiver2->clear_filter());
+    assert(transceiver1->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr && recv_msg->identifier_ == 0x100);
+
+    auto* socketcan2 = dynamic_cast<can::driver::socketcan*>(transceiver2.get());
+    assert(socketcan2 != nullptr);
+    assert(socketcan2->attach_filter(can::driver::bpf_filter::byte(0, 0x02) || can::driver::bpf_filter::byte(0, 0x04)));
+
+    for (uint8_t value = 0; value < 5; value++) {
+        bytes[0] = value;
+        assert(transceiver1->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+    }
+
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr && recv_msg->bytes_[0] == 0x02);
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr && recv_msg->bytes_[0] == 0x04);
+    assert(transceiver2->receive(100) == nullptr);
+    assert(socketcan2->detach_filter());
+
+    printf("filtered frames in kernel\n");
+}
+
+static void test_interface_timestamping(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device, {{"timestamping", "software"}});
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    assert(can::driver::socketcan::create(device, {{"timestamping", "invalid"}}) == nullptr);
+
+    timespec before{};
+    clock_gettime(CLOCK_REALTIME, &before);
+
+    std::array<uint8_t, 8> bytes{};
+    assert(transceiver1->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+
+    auto recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert((recv_msg->flags_ & can::frame::HW_TIMESTAMP) == 0);
+
+    /* software stamps are taken against the realtime clock, in nanoseconds */
+    const auto before_ns = static_cast<uint64_t>(before.tv_sec) * 1000000000 + before.tv_nsec;
+    assert(recv_msg->timestamp_ >= before_ns);
+
+    printf("received frame with software timestamp %lu\n", recv_msg->timestamp_);
+}
+
+static void test_interface_ring(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device, {{"backend", "mmap"}, {"ring_timeout_ms", "1"}});
+    if (result2 == nullptr) {
+        printf("packet ring unavailable (requires CAP_NET_RAW), skipping\n");
+        return;
+    }
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    assert(can::driver::socketcan::create(device, {{"backend", "invalid"}}) == nullptr);
+    assert(can::driver::socketcan::create(device, {{"backend", "mmap"}, {"ring_block_size", "100"}}) == nullptr);
+
+    constexpr size_t FRAME_COUNT = 100;
+
+    std::array<uint8_t, 8> bytes{};
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        bytes[0] = i;
+        assert(transceiver1->transmit(can::frame::create(i, bytes.size(), bytes.data())));
+    }
+
+    auto recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0);
+    assert(recv_msg->timestamp_ != 0);
+
+    can::frame_batch batch(FRAME_COUNT - 1);
+    while (!batch.full()) {
+        assert(transceiver2->receive_batch(batch, 1000) > 0);
+    }
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        assert(batch[i].identifier_ == static_cast<uint32_t>(i + 1));
+        assert(batch[i].bytes_[0] == static_cast<uint8_t>(i + 1));
+    }
+
+    /* the frames transmitted by the ring's own transceiver aren't received, like with a raw socket */
+    assert(transceiver2->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+    assert(transceiver2->transmit_batch(batch) == batch.size());
+    assert(transceiver1->transmit(can::frame::create(0x200, bytes.size(), bytes.data())));
+
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x200);
+
+    recv_msg = transceiver1->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x100);
+
+    /* a duplicate from another socket seen before a batch only stands for one frame of this batch */
+    can::frame_batch duplicates(3);
+    for (size_t i = 0; i < duplicates.capacity(); i++) {
+        bytes[0] = i;
+        assert(duplicates.push_back(0x300 + i, bytes.size(), bytes.data()));
+    }
+
+    assert(transceiver1->transmit(can::frame::create(0x302, bytes.size(), bytes.data())));
+    assert(transceiver2->transmit_batch(duplicates) == duplicates.size());
+    assert(transceiver1->transmit(can::frame::create(0x200, bytes.size(), bytes.data())));
+
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x302);
+
+    recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x200);
+
+    printf("received %zu frames from the packet ring\n", batch.size() + 1);
+}
+
+static void test_interface_uring(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device, {{"backend", "io_uring"}});
+    if (result1 == nullptr) {
+        printf("io_uring unavailable, skipping\n");
+        return;
+    }
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(device, {{"backend", "io_uring"}, {"uring_buffer_count", "8"}});
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+    assert(transceiver2->get_poll_fd() >= 0);
+
+    assert(can::driver::socketcan::create(device, {{"backend", "io_uring"}, {"uring_buffer_count", "7"}}) == nullptr);
+
+    /* fewer receive buffers than receive entries still give a valid completion queue */
+    for (const char* count : {"1", "2"}) {
+        assert(can::driver::socketcan::create(device, {{"backend", "io_uring"}, {"uring_buffer_count", count}}) !=
+               nullptr);
+    }
+
+    /* more frames than receive buffers, so the receive request is armed again */
+    constexpr size_t FRAME_COUNT = 100;
+
+    can::frame_batch sent(FRAME_COUNT);
+    std::array<uint8_t, 8> bytes{};
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        bytes[0] = i;
+        assert(sent.push_back(i, bytes.size(), bytes.data()));
+    }
+    assert(transceiver1->transmit_batch(sent) == FRAME_COUNT);
+
+    auto recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0);
+    assert(recv_msg->timestamp_ != 0);
+
+    can::frame_batch batch(FRAME_COUNT - 1);
+    while (!batch.full()) {
+        assert(transceiver2->receive_batch(batch, 1000) > 0);
+    }
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        assert(batch[i].identifier_ == static_cast<uint32_t>(i + 1));
+        assert(batch[i].bytes_[0] == static_cast<uint8_t>(i + 1));
+    }
+
+    printf("exchanged %zu frames through io_uring\n", batch.size() + 1);
+}
+
+static void test_interface_any(const std::string& device) {
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    auto result2 = can::driver::socketcan::create(can::driver::socketcan::ANY_INTERFACE);
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    assert(can::driver::socketcan::create(can::driver::socketcan::ANY_INTERFACE, {{"backend", "mmap"}}) == nullptr);
+    assert(!transceiver2->set_bitrate(500000));
+
+    const auto index = if_nametoindex(device.c_str());
+    assert(index != 0);
+
+    /* frames received from every interface are tagged with their source */
+    std::array<uint8_t, 8> bytes{};
+    assert(transceiver1->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+
+    auto recv_msg = transceiver2->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x100);
+    assert(recv_msg->interface_ == index);
+
+    /* frames transmitted through every interface must name their egress interface */
+    assert(!transceiver2->transmit(can::frame::create(0x200, bytes.size(), bytes.data())));
+    assert(transceiver2->transmit(can::frame::create(0x200, bytes.size(), bytes.data(), 0, 0, index)));
+
+    recv_msg = transceiver1->receive(1000);
+    assert(recv_msg != nullptr);
+    assert(recv_msg->identifier_ == 0x200);
+
+    printf("received frame from interface %u through every interface\n", recv_msg->interface_);
+}
+
+static void test_interface_backpressure(const std::string& device) {
+    assert(can::driver::socketcan::create(device, {{"tx_policy", "unknown"}}) == nullptr);
+    assert(can::driver::socketcan::create(device, {{"tx_queue_size", "-1"}}) == nullptr);
+
+    auto result = can::driver::socketcan::create(
+        device, {{"sndbuf", "4096"}, {"tx_queue_size", "16"}, {"tx_policy", "drop-oldest"}, {"tx_timeout_ms", "100"}});
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    assert(transceiver != nullptr);
+
+    auto* socketcan = dynamic_cast<can::driver::socketcan*>(transceiver.get());
+    assert(socketcan != nullptr);
+
+    /* a burst larger than the socket buffer is queued in user space, or dropped oldest first */
+    constexpr size_t COUNT = 1000;
+    std::array<uint8_t, 8> bytes{};
+    for (size_t i = 0; i < COUNT; i++) {
+        assert(transceiver->transmit(can::frame::create(0x123, bytes.size(), bytes.data())));
+    }
+
+    auto statistics = socketcan->get_transmit_statistics();
+    assert(statistics.queue_depth_ <= 16);
+    assert(statistics.max_queue_depth_ <= 16);
+    assert(statistics.rejected_ == 0);
+
+    assert(socketcan->flush(1000));
+    statistics = socketcan->get_transmit_statistics();
+    assert(statistics.queue_depth_ == 0);
+
+    printf("queued %lu frames, dropped %lu frames\n", statistics.queued_, statistics.dropped_);
+}
+
+static void test_interface_statistics(const std::string& device) {
+    assert(can::driver::socketcan::create(device, {{"rcvbuf", "invalid"}}) == nullptr);
+
+    auto result1 = can::driver::socketcan::create(device);
+    assert(result1 != nullptr);
+    auto transceiver1 = result1.get_unique_transceiver();
+    assert(transceiver1 != nullptr);
+
+    constexpr size_t BUFFER_SIZE = 65536;
+    auto result2 = can::driver::socketcan::create(device, {{"rcvbuf", std::to_string(BUFFER_SIZE)}});
+    assert(result2 != nullptr);
+    auto transceiver2 = result2.get_unique_transceiver();
+    assert(transceiver2 != nullptr);
+
+    auto* socketcan = dynamic_cast<can::driver::socketcan*>(transceiver2.get());
+    assert(socketcan != nullptr);
+
+    auto statistics = socketcan->get_receive_statistics();
+    assert(statistics.received_ == 0);
+    assert(statistics.dropped_ == 0);
+    assert(statistics.buffer_size_ > 0);
+
+    std::array<uint8_t, 8> bytes{};
+    assert(transceiver1->transmit(can::frame::create(0x100, bytes.size(), bytes.data())));
+    assert(transceiver2->receive(1000) != nullptr);
+
+    statistics = socketcan->get_receive_statistics();
+    assert(statistics.received_ == 1);
+
+    printf("receive buffer of %lu bytes, %lu frames dropped\n", statistics.buffer_size_, statistics.dropped_);
+}
+
 int main() {
     auto interfaces = can::driver::socketcan::list_interfaces();
     if (interfaces.empty()) {
@@ -63,6 +446,15 @@ int main() {
     for (const auto& interface : interfaces) {
         std::cout << "Testing interface '" << interface << "'" << std::endl;
         test_interface(interface);
+        test_interface_batch(interface);
+        test_interface_transmit_batch(interface);
+        test_interface_filter(interface);
+        test_interface_timestamping(interface);
+        test_interface_ring(interface);
+        test_interface_uring(interface);
+        test_interface_any(interface);
+        test_interface_backpressure(interface);
+        test_interface_statistics(interface);
         std::cout << std::endl;
     }
 
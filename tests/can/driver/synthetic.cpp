@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include "create.hpp"
+
+#include "can/driver/synthetic.hpp"
+#include "can/format/dbc/object.hpp"
+
+/*
+ * In-memory database, so the schedule doesn't depend on the DBC parser.
+ */
+class test_signal : public can::database::signal {
+   public:
+    test_signal(std::string name, unsigned short start_bit, unsigned char bit_count, bool is_signed, float scale,
+                std::optional<float> min, std::optional<float> max, multiplexing multiplexing = false)
+        : name_(std::move(name)),
+          start_bit_(start_bit),
+          bit_count_(bit_count),
+          signed_(is_signed),
+          scale_(scale),
+          min_(min),
+          max_(max),
+          multiplexing_(multiplexing) {}
+
+    [[nodiscard]] const std::string& get_name() const override {
+        return name_;
+    }
+
+    [[nodiscard]] unsigned short get_start_bit() const override {
+        return start_bit_;
+    }
+
+    [[nodiscard]] unsigned char get_bit_count() const override {
+        return bit_count_;
+    }
+
+    [[nodiscard]] endian get_byte_order() const override {
+        return endian::LITTLE;
+    }
+
+    [[nodiscard]] bool is_integral() const override {
+        return true;
+    }
+
+    [[nodiscard]] bool is_signed() const override {
+        return signed_;
+    }
+
+    [[nodiscard]] float get_scale() const override {
+        return scale_;
+    }
+
+    [[nodiscard]] float get_offset() const override {
+        return 0;
+    }
+
+    [[nodiscard]] std::optional<float> get_min() const override {
+        return min_;
+    }
+
+    [[nodiscard]] std::optional<float> get_max() const override {
+        return max_;
+    }
+
+    [[nodiscard]] const std::string& get_unit() const override {
+        return unit_;
+    }
+
+    [[nodiscard]] const std::vector<std::string>& get_nodes() const override {
+        return nodes_;
+    }
+
+    [[nodiscard]] multiplexing get_multiplexing() const override {
+        return multiplexing_;
+    }
+
+    [[nodiscard]] const std::string& resolve(uint64_t /* raw_value */) const override {
+        return unit_;
+    }
+
+   private:
+    std::string name_;
+    unsigned short start_bit_;
+    unsigned char bit_count_;
+    bool signed_;
+    float scale_;
+    std::optional<float> min_;
+    std::optional<float> max_;
+    multiplexing multiplexing_;
+    std::string unit_;
+    std::vector<std::string> nodes_;
+};
+
+class test_message : public can::database::message, public can::format::dbc::object {
+   public:
+    test_message(std::string name, unsigned int identifier, unsigned short byte_count, int64_t cycle_time_ms,
+                 std::vector<can::database::signal::const_ptr> signals)
+        : object((cycle_time_ms > 0) ? std::map<std::string, int64_t>{{"GenMsgCycleTime", cycle_time_ms}}
+                                     : std::map<std::string, int64_t>{},
+                 {}, {}),
+          name_(std::move(name)),
+          identifier_(identifier),
+          byte_count_(byte_count),
+          signals_(std::move(signals)) {}
+
+    [[nodiscard]] const std::string& get_name() const override {
+        return name_;
+    }
+
+    [[nodiscard]] unsigned int get_identifier() const override {
+        return identifier_;
+    }
+
+    [[nodiscard]] unsigned short get_byte_count() const override {
+        return byte_count_;
+    }
+
+    [[nodiscard]] const std::string& get_node() const override {
+        return node_;
+    }
+
+    [[nodiscard]] std::vector<can::database::signal::const_ptr> get_signals() const override {
+        return signals_;
+    }
+
+    [[nodiscard]] can::database::signal::const_ptr get_signal(const std::string& name) const override {
+        for (const auto& signal : signals_) {
+            if (signal->get_name() == name) {
+                return signal;
+            }
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] can::database::signal::const_ptr get_signal(can::quark /* quark */) const override {
+        return nullptr;
+    }
+
+   private:
+    std::string name_;
+    unsigned int identifier_;
+    unsigned short byte_count_;
+    std::string node_;
+    std::vector<can::database::signal::const_ptr> signals_;
+};
+
+class test_database : public can::database {
+   public:
+    explicit test_database(std::vector<message::const_ptr> messages) : messages_(std::move(messages)) {}
+
+    [[nodiscard]] std::vector<message::const_ptr> get_messages() const override {
+        return messages_;
+    }
+
+    [[nodiscard]] message::const_ptr get_message(unsigned int identifier) const override {
+        for (const auto& message : messages_) {
+            if (message->get_identifier() == identifier) {
+                return message;
+            }
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] message::const_ptr get_message(const std::string& name) const override {
+        for (const auto& message : messages_) {
+            if (message->get_name() == name) {
+                return message;
+            }
+        }
+
+        return nullptr;
+    }
+
+   private:
+    std::vector<message::const_ptr> messages_;
+};
+
+static constexpr uint64_t MSEC_TO_NSEC = 1000000;
+
+/*
+ * ENGINE (0x100) every 10 ms, STATUS (0x050) every 20 ms, a CAN FD message (0x300) every 40 ms and a message without
+ * cycle time (0x200).
+ */
+static can::database::const_ptr create_database() {
+    auto speed       = std::make_shared<test_signal>("SPEED", 0, 16, false, 0.5F, 0.0F, 100.0F);
+    auto temperature = std::make_shared<test_signal>("TEMPERATURE", 16, 8, true, 1.0F, std::nullopt, std::nullopt);
+    auto first       = std::make_shared<test_signal>("FIRST", 32, 8, false, 1.0F, std::nullopt, std::nullopt,
+                                               static_cast<unsigned short>(1));
+    auto second      = std::make_shared<test_signal>("SECOND", 32, 8, false, 1.0F, std::nullopt, std::nullopt,
+                                                static_cast<unsigned short>(2));
+    auto mode        = std::make_shared<test_signal>("MODE", 24, 8, false, 1.0F, std::nullopt, std::nullopt, true);
+    auto counter     = std::make_shared<test_signal>("COUNTER", 0, 8, false, 1.0F, 0.0F, 3.0F);
+    auto payload     = std::make_shared<test_signal>("PAYLOAD", 88, 8, false, 1.0F, std::nullopt, std::nullopt);
+    auto idle        = std::make_shared<test_signal>("IDLE", 0, 8, false, 1.0F, std::nullopt, std::nullopt);
+
+    using signals = std::vector<can::database::signal::const_ptr>;
+    return std::make_shared<test_database>(std::vector<can::database::message::const_ptr>{
+        std::make_shared<test_message>("ENGINE", 0x100, 8, 10, signals{speed, temperature, first, second, mode}),
+        std::make_shared<test_message>("STATUS", 0x050, 2, 20, signals{counter}),
+        std::make_shared<test_message>("PAYLOAD", 0x300, 12, 40, signals{payload}),
+        std::make_shared<test_message>("IDLE", 0x200, 1, 0, signals{idle}),
+    });
+}
+
+static float decode(const can::database::const_ptr& database, const can::frame::ptr& frame, const std::string& name) {
+    auto signal = database->get_message(frame->identifier_)->get_signal(name);
+    return signal->decode(signal->extract(frame->bytes_, frame->length_));
+}
+
+static void test_create() {
+    auto database = create_database();
+
+    assert(can::driver::synthetic::create(can::database::const_ptr(nullptr)) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"speed", "-1"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"seed", "abc"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator", "sine"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator", "random:1"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator", "constant:abc"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator", "ramp:0"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator.ENGINE.RPM", "random"}}) == nullptr);
+    assert(can::driver::synthetic::create(database, {{"generator.ENGINE", "random"}}) == nullptr);
+
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(database));
+    assert(!transceiver->set_bitrate(500000));
+    assert(!transceiver->transmit(can::classic_frame{}));
+}
+
+static void test_schedule() {
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(create_database(), {{"speed", "0"}}));
+    /* messages due at once are ordered by identifier, and the message without cycle time is left out */
+    constexpr std::array<std::pair<uint32_t, uint64_t>, 10> EXPECTED = {{
+        {0x050, 0},
+        {0x100, 0},
+        {0x300, 0},
+        {0x100, 10},
+        {0x050, 20},
+        {0x100, 20},
+        {0x100, 30},
+        {0x050, 40},
+        {0x100, 40},
+        {0x300, 40},
+    }};
+
+    auto first = transceiver->receive(0);
+    assert(first != nullptr);
+    assert(first->identifier_ == EXPECTED[0].first);
+
+    for (size_t i = 1; i < EXPECTED.size(); i++) {
+        auto frame = transceiver->receive(0);
+        assert(frame != nullptr);
+        assert(frame->identifier_ == EXPECTED.at(i).first);
+        assert(frame->timestamp_ == first->timestamp_ + EXPECTED.at(i).second * MSEC_TO_NSEC);
+
+        if (frame->identifier_ == 0x300) {
+            assert(frame->length_ == 12);
+            assert(frame->flags_ == can::frame::FD);
+        } else {
+            assert(frame->flags_ == 0);
+        }
+    }
+
+    /* messages without cycle time can be given one */
+    auto fallback = test_driver::unwrap(
+        can::driver::synthetic::create(create_database(), {{"speed", "0"}, {"cycle_time_ms", "5"}}));
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+    assert(fallback->receive_batch(batch, 0) == 16);
+    assert(batch[1].identifier_ == 0x100 && batch[2].identifier_ == 0x200 && batch[4].identifier_ == 0x200);
+}
+
+static void test_generators() {
+    auto database    = create_database();
+    auto options     = can::transceiver::options{
+        {"speed", "0"},
+        {"generator", "constant:7"},
+        {"generator.ENGINE.SPEED", "constant:42.5"},
+        {"generator.ENGINE.TEMPERATURE", "constant:-5"},
+        {"generator.ENGINE.MODE", "constant:2"},
+        {"generator.STATUS.COUNTER", "ramp"},
+    };
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(database, options));
+
+    std::vector<float> counters;
+    for (size_t i = 0; i < 20; i++) {
+        auto frame = transceiver->receive(0);
+        if (frame->identifier_ == 0x100) {
+            assert(decode(database, frame, "SPEED") == 42.5F);
+            assert(frame->bytes_[2] == static_cast<uint8_t>(-5));
+            assert(decode(database, frame, "MODE") == 2);
+
+            /* only the signal selected by the multiplexer is generated */
+            assert(decode(database, frame, "SECOND") == 7);
+            assert(frame->bytes_[4] == 7);
+        } else if (frame->identifier_ == 0x050) {
+            counters.push_back(decode(database, frame, "COUNTER"));
+        }
+    }
+
+    /* ramps go from the minimum to the maximum, then again */
+    assert((counters == std::vector<float>{0, 1, 2, 3, 0, 1}));
+
+    /* random values stay in the range of the signal, and a seed makes them reproducible */
+    auto random = test_driver::unwrap(can::driver::synthetic::create(database, {{"speed", "0"}, {"seed", "42"}}));
+    auto same   = test_driver::unwrap(can::driver::synthetic::create(database, {{"speed", "0"}, {"seed", "42"}}));
+
+    bool varied = false;
+    for (size_t i = 0; i < 100; i++) {
+        auto frame = random->receive(0);
+        auto other = same->receive(0);
+        assert(std::equal(frame->bytes_, frame->bytes_ + frame->length_, other->bytes_));
+
+        if (frame->identifier_ == 0x100) {
+            auto speed = decode(database, frame, "SPEED");
+            assert(speed >= 0 && speed <= 100);
+            varied = varied || speed != 0;
+        }
+    }
+
+    assert(varied);
+}
+
+static void test_filter() {
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(create_database(), {{"speed", "0"}}));
+    assert(transceiver->set_filter({0x050}));
+
+    /* filtered messages keep their schedule */
+    auto first = transceiver->receive(0);
+    for (size_t i = 1; i < 5; i++) {
+        auto frame = transceiver->receive(0);
+        assert(frame->identifier_ == 0x050);
+        assert(frame->timestamp_ == first->timestamp_ + i * 20 * MSEC_TO_NSEC);
+    }
+
+    assert(transceiver->set_filter({}));
+    assert(transceiver->receive(0) == nullptr);
+
+    /* the other messages resume where they were left */
+    assert(transceiver->clear_filter());
+    auto frame = transceiver->receive(0);
+    assert(frame->identifier_ == 0x100);
+    assert(frame->timestamp_ == first->timestamp_ + 80 * MSEC_TO_NSEC);
+
+    /* a blocking receive waits until the filter accepts messages again */
+    assert(transceiver->set_filter({}));
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(transceiver->clear_filter());
+    });
+    assert(transceiver->receive() != nullptr);
+    thread.join();
+}
+
+static void test_concurrent_filter() {
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(create_database(), {{"speed", "0"}}));
+
+    std::atomic_bool running    = true;
+    std::atomic_size_t received = 0;
+    std::thread thread([&]() {
+        can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+        while (running) {
+            batch.clear();
+            received += transceiver->receive_batch(batch, 1);
+        }
+    });
+
+    /* filters are changed while frames are generated, including filters disabling every message */
+    for (size_t i = 0; i < 1000 || received == 0; i++) {
+        assert(transceiver->set_filter({0x050}));
+        assert(transceiver->set_filter({}));
+        assert(transceiver->clear_filter());
+    }
+
+    running = false;
+    thread.join();
+    assert(received > 0);
+}
+
+static void test_speed() {
+    auto transceiver = test_driver::unwrap(can::driver::synthetic::create(create_database(), {{"speed", "2"}}));
+
+    /* the messages due at the start are received at once, the next one after half its cycle time */
+    auto start = std::chrono::steady_clock::now();
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+    assert(transceiver->receive_batch(batch, 0) == 3);
+    assert(transceiver->receive(0) == nullptr);
+    assert(transceiver->receive(1000) != nullptr);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    assert(static_cast<uint64_t>(elapsed.count()) >= 5 * MSEC_TO_NSEC);
+}
+
+int main() {
+    test_create();
+    test_schedule();
+    test_generators();
+    test_filter();
+    test_concurrent_filter();
+    test_speed();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
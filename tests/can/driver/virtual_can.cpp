@@ -0,0 +1,272 @@
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <thread>
+
+#include "create.hpp"
+
+#include "can/driver/virtual_can.hpp"
+#include "can/utils/wire.hpp"
+
+static can::fd_frame make_frame(uint32_t identifier, size_t length) {
+    can::fd_frame frame{};
+    frame.identifier_ = identifier;
+    frame.length_     = length;
+    for (size_t i = 0; i < length; i++) {
+        frame.bytes_.at(i) = static_cast<uint8_t>(identifier + i);
+    }
+
+    return frame;
+}
+
+static void test_interfaces() {
+    assert(can::transceiver::list_interfaces().at("virtual").empty());
+
+    {
+        auto first  = test_driver::create("virtual", "vbus0");
+        auto second = test_driver::create("virtual", "vbus0");
+        auto third  = test_driver::create("virtual", "vbus1");
+        assert((can::transceiver::list_interfaces().at("virtual") == std::list<std::string>{"vbus0", "vbus1"}));
+    }
+
+    /* buses only live as long as their transceivers */
+    assert(can::transceiver::list_interfaces().at("virtual").empty());
+
+    assert(can::transceiver::create("virtual", "vbus0", {{"queue_size", "0"}}) == nullptr);
+    assert(can::transceiver::create("virtual", "vbus0", {{"virtual_time", "1"}}) == nullptr);
+}
+
+static void test_exchange() {
+    auto first    = test_driver::create("virtual", "vbus0");
+    auto second   = test_driver::create("virtual", "vbus0");
+    auto loopback = test_driver::create("virtual", "vbus0", {{"loopback", "1"}});
+    auto other    = test_driver::create("virtual", "vbus1");
+
+    assert(first->transmit(make_frame(0x123, 4)));
+
+    auto frame = second->receive(0);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x123);
+    assert(frame->length_ == 4);
+    assert(frame->bytes_[3] == static_cast<uint8_t>(0x123 + 3));
+    assert(frame->flags_ == 0);
+    assert(frame->timestamp_ > 0);
+
+    /* the transmitting transceiver only receives its own frames with loopback */
+    assert(first->receive(0) == nullptr);
+    assert(loopback->receive(0) != nullptr);
+    assert(other->receive(0) == nullptr);
+
+    assert(loopback->transmit(make_frame(0x456, 64)));
+    assert(first->receive(0)->length_ == 64);
+    assert(second->receive(0)->identifier_ == 0x456);
+    assert(loopback->receive(0)->identifier_ == 0x456);
+}
+
+static uint64_t count_allocations() {
+    uint64_t count = 0;
+    for (const auto& statistics : can::frame::get_pool_statistics()) {
+        count += statistics.hits_ + statistics.misses_;
+    }
+
+    return count;
+}
+
+static void test_fields() {
+    auto first  = test_driver::create("virtual", "vbus0");
+    auto second = test_driver::create("virtual", "vbus0");
+
+    /* frames given by their fields are handed to the bus without allocating a frame */
+    const std::array<uint8_t, 12> bytes = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    const uint64_t allocations          = count_allocations();
+    for (uint32_t identifier = 0; identifier < 16; identifier++) {
+        assert(first->transmit(identifier, bytes, can::frame::FD | can::frame::BRS));
+    }
+    assert(count_allocations() == allocations);
+
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+    assert(second->receive_batch(batch, 0) == 16);
+    assert(batch[15].identifier_ == 15);
+    assert(batch[15].flags_ == (can::frame::FD | can::frame::BRS));
+    assert(batch[15].bytes_.size() == bytes.size() && batch[15].bytes_[11] == 11);
+
+    const std::array<uint8_t, 65> too_long{};
+    assert(!first->transmit(0x123, too_long));
+}
+
+static void test_receive_into() {
+    auto first  = test_driver::create("virtual", "vbus0");
+    auto second = test_driver::create("virtual", "vbus0");
+
+    for (uint32_t identifier = 0; identifier < 16; identifier++) {
+        assert(first->transmit(make_frame(identifier, 8)));
+    }
+
+    /* frames received into a caller frame don't allocate a frame either */
+    can::fd_frame frame{};
+    const uint64_t allocations = count_allocations();
+    for (uint32_t identifier = 0; identifier < 16; identifier++) {
+        assert(second->receive_into(frame, 0));
+        assert(frame.identifier_ == identifier);
+        assert(frame.length_ == 8 && frame.bytes_[7] == identifier + 7);
+    }
+    assert(count_allocations() == allocations);
+
+    assert(!second->receive_into(frame, 0));
+    assert(!second->receive_into(frame, 10));
+}
+
+static void test_batches() {
+    auto first  = test_driver::create("virtual", "vbus0");
+    auto second = test_driver::create("virtual", "vbus0");
+
+    constexpr size_t FRAME_COUNT = 100;
+    can::frame_batch sent(FRAME_COUNT);
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        auto frame = make_frame(i, 8);
+        assert(sent.push_back(frame.identifier_, frame.length_, frame.bytes_.data()));
+    }
+
+    assert(first->transmit_batch(sent) == FRAME_COUNT);
+
+    /* a single call drains the queue until the batch is full */
+    can::frame_batch batch(64);
+    assert(second->receive_batch(batch, 1000) == 64);
+    assert(batch[63].identifier_ == 63);
+    assert(batch[63].bytes_[7] == 63 + 7);
+
+    batch.clear();
+    assert(second->receive_batch(batch, 1000) == FRAME_COUNT - 64);
+    assert(batch[0].identifier_ == 64);
+
+    batch.clear();
+    assert(second->receive_batch(batch, 0) == 0);
+    assert(second->receive_batch(batch, 10) == 0);
+}
+
+static void test_filter() {
+    auto first  = test_driver::create("virtual", "vbus0");
+    auto second = test_driver::create("virtual", "vbus0");
+
+    assert(second->set_filter({0x300, 0x100}));
+    for (uint32_t identifier = 0; identifier < 0x400; identifier += 0x80) {
+        assert(first->transmit(make_frame(identifier, 1)));
+    }
+
+    assert(second->receive(0)->identifier_ == 0x100);
+    assert(second->receive(0)->identifier_ == 0x300);
+    assert(second->receive(0) == nullptr);
+
+    assert(second->clear_filter());
+    assert(first->transmit(make_frame(0x080, 1)));
+    assert(second->receive(0)->identifier_ == 0x080);
+}
+
+static void test_overrun() {
+    auto result = can::driver::virtual_can::create("vbus0", {{"queue_size", "4"}});
+    assert(result != nullptr);
+    auto transceiver = result.get_unique_transceiver();
+    auto* receiver   = dynamic_cast<can::driver::virtual_can*>(transceiver.get());
+    assert(receiver != nullptr);
+
+    auto first = test_driver::create("virtual", "vbus0");
+    for (uint32_t i = 0; i < 10; i++) {
+        assert(first->transmit(make_frame(i, 0)));
+    }
+
+    /* frames transmitted while the queue is full are lost, like on a controller overrun */
+    assert(receiver->get_overrun_count() == 6);
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(receiver->receive(0)->identifier_ == i);
+    }
+
+    assert(receiver->receive(0) == nullptr);
+}
+
+static void test_wakeup() {
+    auto first  = test_driver::create("virtual", "vbus0");
+    auto second = test_driver::create("virtual", "vbus0");
+
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(first->transmit(make_frame(0x42, 0)));
+    });
+
+    auto frame = second->receive(1000);
+    assert(frame != nullptr);
+    assert(frame->identifier_ == 0x42);
+
+    thread.join();
+}
+
+static void test_virtual_time() {
+    constexpr unsigned long BITRATE = 500000;
+
+    auto first = test_driver::create("virtual", "vbus0",
+                                     {{"bitrate", std::to_string(BITRATE)}, {"virtual_time", "1"}});
+    auto second = test_driver::create("virtual", "vbus0", {{"virtual_time", "1"}});
+    assert(can::transceiver::create("virtual", "vbus0") == nullptr);
+
+    /* the bus time only depends on the frames, so it is the same on every run */
+    uint64_t expected = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        auto frame = make_frame(i, i % 9);
+        expected += can::utils::wire::get_duration_ns(
+            can::utils::wire::count_bits(frame.identifier_, frame.length_, frame.bytes_.data(), 0), BITRATE);
+
+        assert(first->transmit(frame));
+
+        auto received = second->receive(0);
+        assert(received != nullptr);
+        assert(received->timestamp_ == expected);
+        assert(received->flags_ == can::frame::HW_TIMESTAMP);
+    }
+}
+
+static void test_bitrate() {
+    constexpr unsigned long BITRATE = 1000000;
+    constexpr size_t FRAME_COUNT    = 100;
+
+    auto first  = test_driver::create("virtual", "vbus0", {{"bitrate", std::to_string(BITRATE)}});
+    auto second = test_driver::create("virtual", "vbus0");
+
+    auto frame = make_frame(0x123, 8);
+    auto time  = can::utils::wire::get_duration_ns(
+        can::utils::wire::count_bits(frame.identifier_, frame.length_, frame.bytes_.data(), 0), BITRATE);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        assert(first->transmit(frame));
+    }
+
+    /* transmissions complete once the frame would have been sent on the wire */
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    assert(static_cast<uint64_t>(elapsed.count()) >= FRAME_COUNT * time);
+
+    uint64_t previous = 0;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        auto received = second->receive(0);
+        assert(received != nullptr);
+        assert(received->timestamp_ >= previous);
+        assert(received->flags_ == 0);
+        previous = received->timestamp_;
+    }
+}
+
+int main() {
+    test_interfaces();
+    test_exchange();
+    test_fields();
+    test_receive_into();
+    test_batches();
+    test_filter();
+    test_overrun();
+    test_wakeup();
+    test_virtual_time();
+    test_bitrate();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
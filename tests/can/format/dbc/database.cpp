@@ -1,3 +1,4 @@
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -329,8 +330,154 @@ static void test_simple_database() {
     assert(node_debug->get_string_attributes().empty());
 }
 
+static void test_fd_database() {
+    char input[] =
+        "VERSION \"\"\n"
+        "\n"
+        "\n"
+        "NS_ :\n"
+        "\tBA_\n"
+        "\tBA_DEF_\n"
+        "\tCM_\n"
+        "\n"
+        "BS_:\n"
+        "\n"
+        "BU_ : MASTER DEBUG\n"
+        "\n"
+        "BO_ 512 FD_PAYLOAD: 64 MASTER\n"
+        " SG_ FD_FIRST : 0|8@1+ (1,0) [0|255] \"\" DEBUG\n"
+        " SG_ FD_EIGHTH : 56|8@1+ (1,0) [0|255] \"\" DEBUG\n"
+        " SG_ FD_WIDE : 448|64@1+ (1,0) [0|0] \"\" DEBUG\n"
+        " SG_ FD_LAST : 500|12@1+ (1,0) [0|4095] \"\" DEBUG\n";
+
+    auto database = parse(lexy::string_input<lexy::utf8_encoding>(input, sizeof(input)));
+
+    auto message = database->get_message(512);
+    assert(message != nullptr);
+    assert(message->get_byte_count() == 64);
+
+    std::array<uint8_t, 64> bytes{};
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes.at(i) = i;
+    }
+
+    auto values = message->extract(bytes.data(), bytes.size());
+    assert(values.size() == 4);
+
+    for (const auto& [signal, value] : values) {
+        if (signal->get_name() == "FD_FIRST") {
+            assert(value == 0x00);
+        } else if (signal->get_name() == "FD_EIGHTH") {
+            assert(value == 0x07);
+        } else if (signal->get_name() == "FD_WIDE") {
+            assert(value == 0x3F3E3D3C3B3A3938);
+        } else if (signal->get_name() == "FD_LAST") {
+            assert(signal->get_start_bit() == 500);
+            assert(value == ((0x3E >> 4) | (0x3F << 4)));
+        } else {
+            assert(false);
+        }
+    }
+
+    /* a truncated payload can't hold the last signals */
+    auto truncated = database->get_message(512)->get_signal("FD_LAST")->extract(bytes.data(), 32);
+    assert(truncated == 0);
+}
+
+static void test_encode_signals() {
+    char input[] =
+        "VERSION \"\"\n"
+        "\n"
+        "\n"
+        "NS_ :\n"
+        "\tCM_\n"
+        "\n"
+        "BS_:\n"
+        "\n"
+        "BU_ : MASTER DEBUG\n"
+        "\n"
+        "BO_ 256 ENCODED: 8 MASTER\n"
+        " SG_ ENCODED_CROSSING : 4|12@1+ (0.5,-10) [-10|2037.5] \"\" DEBUG\n"
+        " SG_ ENCODED_SIGNED : 16|8@1- (1,0) [-128|127] \"\" DEBUG\n"
+        " SG_ ENCODED_UNSIGNED : 24|8@1+ (1,0) [0|255] \"\" DEBUG\n"
+        " SG_ ENCODED_MOTOROLA : 39|8@0+ (1,0) [0|255] \"\" DEBUG\n"
+        "\n"
+        "BO_ 257 ENCODED_WIDE: 8 MASTER\n"
+        " SG_ ENCODED_WIDE : 0|64@1+ (1,0) [0|0] \"\" DEBUG\n";
+
+    auto database = parse(lexy::string_input<lexy::utf8_encoding>(input, sizeof(input)));
+
+    auto message = database->get_message(256);
+    assert(message != nullptr);
+
+    /* a signal crossing a byte boundary round trips and leaves its neighbours untouched */
+    auto crossing = message->get_signal("ENCODED_CROSSING");
+    std::array<uint8_t, 8> bytes{};
+    bytes.fill(0xA5);
+
+    auto raw_value = crossing->encode(100.5F);
+    assert(raw_value == 221);
+    crossing->insert(raw_value, bytes.data(), bytes.size());
+    assert(bytes.at(0) == 0xD5);
+    assert(bytes.at(1) == 0x0D);
+    assert(bytes.at(2) == 0xA5);
+    assert(crossing->extract(bytes.data(), bytes.size()) == raw_value);
+    assert(almost_equal(crossing->decode(raw_value), 100.5F));
+
+    /* signed values saturate at both ends of their range */
+    auto signed_signal = message->get_signal("ENCODED_SIGNED");
+    assert(signed_signal->encode(-1.0F) == 0xFF);
+    assert(signed_signal->encode(-128.0F) == 0x80);
+    assert(signed_signal->encode(-1000.0F) == 0x80);
+    assert(signed_signal->encode(127.0F) == 0x7F);
+    assert(signed_signal->encode(1000.0F) == 0x7F);
+
+    signed_signal->insert(signed_signal->encode(-2.0F), bytes.data(), bytes.size());
+    assert(bytes.at(2) == 0xFE);
+    assert(signed_signal->extract(bytes.data(), bytes.size()) == 0xFE);
+
+    /* unsigned values are clamped, negative values included */
+    auto unsigned_signal = message->get_signal("ENCODED_UNSIGNED");
+    assert(unsigned_signal->encode(42.0F) == 42);
+    assert(unsigned_signal->encode(-5.0F) == 0);
+    assert(unsigned_signal->encode(255.0F) == 255);
+    assert(unsigned_signal->encode(300.0F) == 255);
+
+    /* a frame too small for the signal is left untouched */
+    unsigned_signal->insert(42, bytes.data(), 3);
+    assert(bytes.at(3) == 0xA5);
+    assert(unsigned_signal->extract(bytes.data(), 3) == 0);
+
+    unsigned_signal->insert(42, bytes.data(), bytes.size());
+    assert(bytes.at(3) == 42);
+    assert(unsigned_signal->extract(bytes.data(), bytes.size()) == 42);
+
+    /* big-endian signals are not supported and are left untouched */
+    auto motorola = message->get_signal("ENCODED_MOTOROLA");
+    motorola->insert(0x12, bytes.data(), bytes.size());
+    assert(bytes.at(4) == 0xA5);
+
+    /* a signal as wide as the raw value */
+    auto wide = database->get_message(257)->get_signal("ENCODED_WIDE");
+    assert(wide->encode(-1.0F) == 0);
+    assert(wide->encode(1e30F) == UINT64_MAX);
+
+    bytes.fill(0);
+    wide->insert(UINT64_MAX, bytes.data(), bytes.size());
+    for (auto byte : bytes) {
+        assert(byte == 0xFF);
+    }
+
+    wide->insert(0x0123456789ABCDEF, bytes.data(), bytes.size());
+    assert(bytes.at(0) == 0xEF);
+    assert(bytes.at(7) == 0x01);
+    assert(wide->extract(bytes.data(), bytes.size()) == 0x0123456789ABCDEF);
+}
+
 int main() {
     test_simple_database();
+    test_fd_database();
+    test_encode_signals();
 
     return 0;
 }
\ No newline at end of file
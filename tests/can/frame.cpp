@@ -0,0 +1,66 @@
+#include <array>
+#include <cassert>
+
+#include "can/frame.hpp"
+
+static void test_static_frame() {
+    std::array<uint8_t, 12> bytes = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+    /* heap frame to inline frame */
+    auto ptr     = can::frame::create(0x123, bytes.size(), bytes.data(), 42, 0, 3);
+    auto fd      = can::fd_frame::from(*ptr);
+    auto classic = can::classic_frame::from(*ptr);
+    assert(fd.has_value());
+    assert(!classic.has_value());
+    assert(fd->identifier_ == 0x123);
+    assert(fd->timestamp_ == 42);
+    assert(fd->interface_ == 3);
+    assert(fd->length_ == bytes.size());
+    for (size_t i = 0; i < bytes.size(); i++) {
+        assert(fd->bytes_.at(i) == bytes.at(i));
+    }
+
+    /* inline frame to heap frame */
+    auto copy = fd->to_ptr();
+    assert(copy->identifier_ == ptr->identifier_);
+    assert(copy->timestamp_ == ptr->timestamp_);
+    assert(copy->interface_ == ptr->interface_);
+    assert(copy->length_ == ptr->length_);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        assert(copy->bytes_[i] == bytes.at(i));
+    }
+}
+
+static void test_pool() {
+    std::array<uint8_t, 128> bytes{};
+
+    auto before = can::frame::get_pool_statistics();
+    assert(before.size() == 2);
+
+    {
+        /* classic, fd and oversized frames */
+        auto classic   = can::frame::create(1, 8, bytes.data());
+        auto fd        = can::frame::create(2, 64, bytes.data());
+        auto oversized = can::frame::create(3, bytes.size(), bytes.data());
+    }
+
+    auto after = can::frame::get_pool_statistics();
+    assert(after.at(0).hits_ == before.at(0).hits_ + 1);
+    assert(after.at(1).hits_ == before.at(1).hits_ + 1);
+    assert(after.at(0).misses_ == before.at(0).misses_);
+    assert(after.at(1).misses_ == before.at(1).misses_);
+
+    /* exhausting a size class falls back to the heap */
+    std::vector<can::frame::ptr> frames;
+    for (size_t i = 0; i < after.at(0).capacity_ + 1; i++) {
+        frames.push_back(can::frame::create(i, 8, bytes.data()));
+    }
+    assert(can::frame::get_pool_statistics().at(0).misses_ == after.at(0).misses_ + 1);
+}
+
+int main() {
+    test_static_frame();
+    test_pool();
+
+    return 0;
+}
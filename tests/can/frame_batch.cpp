@@ -0,0 +1,118 @@
+#include <array>
+#include <cassert>
+
+#include "can/frame_batch.hpp"
+
+static void test_push_back() {
+    can::frame_batch batch(4);
+    assert(batch.empty());
+    assert(batch.capacity() == 4);
+    assert(batch.stride() == can::frame_batch::CLASSIC_STRIDE);
+
+    std::array<uint8_t, 64> bytes{};
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes.at(i) = i;
+    }
+
+    /* payloads larger than the stride are rejected */
+    assert(!batch.push_back(0x100, 9, bytes.data()));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(batch.push_back(0x100 + i, i + 1, bytes.data(), 10 * i));
+    }
+    assert(batch.full());
+    assert(!batch.push_back(0x200, 1, bytes.data()));
+
+    size_t index = 0;
+    for (auto entry : batch) {
+        assert(entry.identifier_ == 0x100 + index);
+        assert(entry.timestamp_ == 10 * index);
+        assert(entry.bytes_.size() == index + 1);
+        for (size_t i = 0; i < entry.bytes_.size(); i++) {
+            assert(entry.bytes_[i] == bytes.at(i));
+        }
+        index++;
+    }
+    assert(index == 4);
+
+    auto ptr = batch[2].to_ptr();
+    assert(ptr->identifier_ == 0x102);
+    assert(ptr->timestamp_ == 20);
+    assert(ptr->length_ == 3);
+
+    batch.clear();
+    assert(batch.empty());
+    assert(batch.push_back(*ptr));
+    assert(batch[0].identifier_ == 0x102);
+}
+
+static void test_columns() {
+    can::frame_batch batch(16, can::frame_batch::FD_STRIDE);
+
+    std::array<uint8_t, 64> bytes{};
+    for (uint32_t i = 0; i < 16; i++) {
+        bytes.at(0) = i;
+        assert(batch.push_back(i % 4, 64, bytes.data(), 100 + i, 0, i + 1));
+    }
+
+    assert(batch.get_identifiers().size() == 16);
+    assert(batch.get_timestamps()[3] == 103);
+    assert(batch.get_lengths()[3] == 64);
+    assert(batch.get_bytes(7)[0] == 7);
+    assert(batch.get_interfaces()[3] == 4);
+    assert(batch[5].to_ptr()->interface_ == 6);
+
+    /* identifier scan */
+    assert(batch.find(2) == 2);
+    assert(batch.find(2, 3) == 6);
+    assert(batch.find(9) == batch.size());
+
+    /* time range scan */
+    auto begin = batch.lower_bound(104);
+    auto end   = batch.lower_bound(108);
+    assert(begin == 4);
+    assert(end == 8);
+
+    auto slice = batch.slice(begin, end);
+    assert(slice.size() == 4);
+    assert(slice[0].timestamp_ == 104);
+    assert(slice[0].bytes_[0] == 4);
+    assert(slice[0].interface_ == 5);
+    assert(slice.find(3) == 3);
+    assert(slice.slice(1, 100).size() == 3);
+}
+
+static void test_move() {
+    std::array<uint8_t, 8> bytes{1, 2, 3, 4, 5, 6, 7, 8};
+
+    can::frame_batch batch(2);
+    assert(batch.push_back(0x100, 8, bytes.data(), 10));
+
+    /* the moved-from batch is left empty and detached from the columns */
+    can::frame_batch moved(std::move(batch));
+    assert(moved.size() == 1);
+    assert(moved[0].identifier_ == 0x100);
+    assert(moved[0].bytes_[7] == 8);
+    assert(batch.empty());
+    assert(batch.get_identifiers().empty());
+    assert(!batch.push_back(0x101, 8, bytes.data()));
+
+    can::frame_batch other(4);
+    assert(other.push_back(0x200, 1, bytes.data()));
+    other = std::move(moved);
+    assert(other.size() == 1);
+    assert(other.capacity() == 2);
+    assert(other[0].timestamp_ == 10);
+    assert(other.push_back(0x101, 8, bytes.data()));
+    assert(other.full());
+    assert(moved.empty());
+    assert(moved.begin() == moved.end());
+}
+
+int main() {
+    test_push_back();
+    test_columns();
+    test_move();
+
+    return 0;
+}
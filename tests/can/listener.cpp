@@ -0,0 +1,193 @@
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "can/listener.hpp"
+
+/*
+ * In-memory transceiver, optionally exposing an eventfd as poll file descriptor.
+ */
+class fake_transceiver : public can::transceiver {
+   public:
+    explicit fake_transceiver(bool pollable) : fd_(pollable ? eventfd(0, EFD_NONBLOCK | EFD_SEMAPHORE) : -1) {}
+
+    ~fake_transceiver() override {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void inject(uint32_t identifier) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        identifiers_.push(identifier);
+        if (fd_ >= 0) {
+            uint64_t one      = 1;
+            const auto result = write(fd_, &one, sizeof(one));
+            assert(result == sizeof(one));
+            (void)result;
+        }
+        condition_.notify_one();
+    }
+
+    std::optional<std::vector<uint32_t>> get_filter() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return filter_;
+    }
+
+    bool set_bitrate(unsigned long /* bitrate */) override {
+        return true;
+    }
+
+    bool transmit(can::frame::ptr /* msg */) override {
+        return false;
+    }
+
+    can::frame::ptr receive(long timeout_ms) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() { return !identifiers_.empty(); })) {
+            return nullptr;
+        }
+
+        auto identifier = identifiers_.front();
+        identifiers_.pop();
+        if (fd_ >= 0) {
+            uint64_t value    = 0;
+            const auto result = read(fd_, &value, sizeof(value));
+            assert(result == sizeof(value));
+            (void)result;
+        }
+
+        return can::frame::create(identifier, 0, nullptr);
+    }
+
+    bool set_filter(const std::vector<uint32_t>& identifiers) override {
+        std::lock_guard<std::mutex> guard(mutex_);
+        filter_ = identifiers;
+        return true;
+    }
+
+    bool clear_filter() override {
+        std::lock_guard<std::mutex> guard(mutex_);
+        filter_.reset();
+        return true;
+    }
+
+    [[nodiscard]] int get_poll_fd() const override {
+        return fd_;
+    }
+
+   private:
+    const int fd_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::queue<uint32_t> identifiers_;
+    std::optional<std::vector<uint32_t>> filter_;
+};
+
+static bool wait_for(const std::atomic_size_t& counter, size_t expected) {
+    for (int i = 0; i < 500 && counter < expected; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return counter == expected;
+}
+
+static void test_listener(unsigned int io_threads) {
+    auto listener = std::make_shared<can::listener>(io_threads);
+
+    std::vector<fake_transceiver*> transceivers;
+    std::vector<can::quark> quarks;
+    for (bool pollable : {true, true, true, false}) {
+        auto transceiver = std::make_shared<fake_transceiver>(pollable);
+        transceivers.push_back(transceiver.get());
+        quarks.push_back(listener->start(can::utils::unique_owner_ptr<can::transceiver>(transceiver)));
+    }
+
+    std::atomic_size_t received = 0;
+    std::atomic_size_t filtered = 0;
+    auto all                    = listener->subscribe([&](const can::frame::ptr& /* frame */) { received++; });
+    auto one = listener->subscribe([&](const can::frame::ptr& frame) { filtered += (frame->identifier_ == 7); }, 7);
+
+    constexpr size_t FRAME_COUNT = 100;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        for (auto* transceiver : transceivers) {
+            transceiver->inject(i);
+        }
+    }
+
+    assert(wait_for(received, FRAME_COUNT * transceivers.size()));
+    assert(wait_for(filtered, transceivers.size()));
+
+    /* a transceiver shut down alone doesn't affect the others */
+    listener->shutdown(quarks.front());
+    transceivers.erase(transceivers.begin());
+
+    received = 0;
+    for (auto* transceiver : transceivers) {
+        transceiver->inject(1);
+    }
+    assert(wait_for(received, transceivers.size()));
+
+    /* subscriptions are pushed down as filters */
+    for (auto* transceiver : transceivers) {
+        assert(!transceiver->get_filter().has_value());
+    }
+
+    all->unsubscribe();
+    for (auto* transceiver : transceivers) {
+        auto filter = transceiver->get_filter();
+        assert(filter.has_value() && filter.value() == std::vector<uint32_t>{7});
+    }
+
+    one->unsubscribe();
+    for (auto* transceiver : transceivers) {
+        auto filter = transceiver->get_filter();
+        assert(filter.has_value() && filter->empty());
+    }
+
+    listener->shutdown();
+}
+
+static void test_busy_poll() {
+    auto listener = std::make_shared<can::listener>();
+
+    auto transceiver = std::make_shared<fake_transceiver>(false);
+    auto* fake       = transceiver.get();
+    auto quark       = listener->start_busy_poll(can::utils::unique_owner_ptr<can::transceiver>(transceiver), 0);
+
+    std::atomic_size_t received = 0;
+    auto all = listener->subscribe([&](const can::frame::ptr& /* frame */) { received++; });
+
+    constexpr size_t FRAME_COUNT = 100;
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        fake->inject(i);
+    }
+
+    assert(wait_for(received, FRAME_COUNT));
+
+    all->unsubscribe();
+    auto filter = fake->get_filter();
+    assert(filter.has_value() && filter->empty());
+
+    listener->shutdown(quark);
+    listener->shutdown();
+}
+
+int main() {
+    test_listener(0);
+    test_listener(1);
+    test_listener(2);
+    test_busy_poll();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "can/listener.hpp"
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*
+ * In-memory transceiver, handing over frames stamped with the time they were injected at.
+ */
+class loopback_transceiver : public can::transceiver {
+   public:
+    void inject(uint32_t identifier) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        timestamps_.emplace(identifier, now_ns());
+        condition_.notify_one();
+    }
+
+    bool set_bitrate(unsigned long /* bitrate */) override {
+        return true;
+    }
+
+    bool transmit(can::frame::ptr /* msg */) override {
+        return false;
+    }
+
+    can::frame::ptr receive(long timeout_ms) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() { return !timestamps_.empty(); })) {
+            return nullptr;
+        }
+
+        auto [identifier, timestamp] = timestamps_.front();
+        timestamps_.pop();
+
+        return can::frame::create(identifier, 0, nullptr, timestamp);
+    }
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::queue<std::pair<uint32_t, uint64_t>> timestamps_;
+};
+
+/*
+ * Measures the time from the injection of a frame to its delivery to a subscriber, one frame at a time, along with
+ * the CPU time the process used meanwhile.
+ */
+static void benchmark(const char* name, bool busy_poll) {
+    constexpr size_t FRAME_COUNT = 2000;
+    constexpr auto INTERVAL      = std::chrono::microseconds(200);
+
+    auto listener     = std::make_shared<can::listener>();
+    auto transceiver  = std::make_shared<loopback_transceiver>();
+    auto* loopback    = transceiver.get();
+    auto owned        = can::utils::unique_owner_ptr<can::transceiver>(transceiver);
+    auto last_cpu     = std::thread::hardware_concurrency() - 1;
+    auto quark        = busy_poll ? listener->start_busy_poll(std::move(owned), last_cpu)
+                                  : listener->start(std::move(owned));
+
+    std::atomic_size_t received = 0;
+    std::vector<uint64_t> latencies(FRAME_COUNT);
+    auto guard = listener->subscribe([&](const can::frame::ptr& frame) {
+        latencies.at(frame->identifier_) = now_ns() - frame->timestamp_;
+        received++;
+    });
+
+    const auto wall_start = std::chrono::steady_clock::now();
+    const auto cpu_start  = std::clock();
+
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        loopback->inject(i);
+        while (received <= i) {
+            std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(INTERVAL);
+    }
+
+    const auto cpu_time  = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    const auto wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    listener->shutdown(quark);
+
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-10s p50 %7.1f us  p99 %7.1f us  max %8.1f us  cpu %5.1f %%\n", name,
+           latencies.at(FRAME_COUNT / 2) / 1e3, latencies.at(FRAME_COUNT * 99 / 100) / 1e3,
+           latencies.back() / 1e3, 100 * cpu_time / wall_time);
+}
+
+/*
+ * Measures the rate at which a listener delivers frames to a subscriber, fed at full speed through a virtual bus so
+ * no kernel or device is involved.
+ */
+static void benchmark_throughput() {
+    constexpr size_t FRAME_COUNT = 2000000;
+    constexpr size_t QUEUE_SIZE  = 65536;
+    constexpr size_t BATCH_SIZE  = 64;
+
+    auto receiver = can::transceiver::create("virtual", "benchmark", {{"queue_size", std::to_string(QUEUE_SIZE)}});
+    auto sender   = can::transceiver::create("virtual", "benchmark").get_unique_transceiver();
+
+    auto listener = std::make_shared<can::listener>();
+    auto quark    = listener->start(receiver.get_unique_transceiver());
+
+    std::atomic_size_t received = 0;
+    auto guard = listener->subscribe([&](const can::frame::ptr& /* frame */) { received++; });
+
+    can::frame_batch batch(BATCH_SIZE);
+    const std::array<uint8_t, 8> bytes{};
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        batch.push_back(i, bytes.size(), bytes.data());
+    }
+
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    /* stay below the capacity of the receive queue, frames would be dropped otherwise */
+    for (size_t sent = 0; sent < FRAME_COUNT; sent += BATCH_SIZE) {
+        while (sent - received >= QUEUE_SIZE - BATCH_SIZE) {
+            std::this_thread::yield();
+        }
+
+        sender->transmit_batch(batch);
+    }
+
+    while (received < FRAME_COUNT) {
+        std::this_thread::yield();
+    }
+
+    const auto wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    listener->shutdown(quark);
+
+    printf("%-10s %7.2f M frames/s\n", "virtual", FRAME_COUNT / wall_time / 1e6);
+}
+
+int main() {
+    benchmark("queued", false);
+    benchmark("busy-poll", true);
+    benchmark_throughput();
+
+    return 0;
+}
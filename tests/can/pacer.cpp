@@ -0,0 +1,97 @@
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+#include "can/pacer.hpp"
+#include "can/utils/wire.hpp"
+
+/*
+ * Transmitter accepting every frame, except when told to refuse them.
+ */
+class fake_transmitter : public can::transmitter {
+   public:
+    bool transmit(can::frame::ptr /* msg */) override {
+        return !refusing_;
+    }
+
+    bool refusing_ = false;
+};
+
+static void test_invalid() {
+    auto transmitter = std::make_shared<fake_transmitter>();
+    assert(can::pacer::create(transmitter, 0, 50) == nullptr);
+    assert(can::pacer::create(transmitter, 500000, 0) == nullptr);
+    assert(can::pacer::create(transmitter, 500000, 101) == nullptr);
+}
+
+static void test_load() {
+    constexpr unsigned long BITRATE = 500000;
+    constexpr double LOAD           = 20;
+    constexpr size_t FRAME_COUNT    = 200;
+
+    auto transmitter = std::make_shared<fake_transmitter>();
+    auto pacer       = can::pacer::create(transmitter, BITRATE, LOAD);
+    assert(pacer != nullptr);
+
+    std::array<uint8_t, 8> bytes{};
+    const auto bits = can::utils::wire::count_bits(0x123, bytes.size(), bytes.data(), 0);
+    const auto time = can::utils::wire::get_duration_ns(bits, BITRATE);
+
+    can::classic_frame frame{};
+    frame.identifier_ = 0x123;
+    frame.length_     = bytes.size();
+
+    /* each bit of a classic frame lasts a nominal bit time */
+    assert(bits.data_ == 0);
+    assert(time == bits.nominal_ * (1000000000 / BITRATE));
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        assert(pacer->transmit(frame));
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    auto statistics = pacer->get_statistics();
+    assert(statistics.frames_ == FRAME_COUNT);
+    assert(statistics.bits_ == FRAME_COUNT * bits.nominal_);
+    assert(statistics.bus_time_ns_ == FRAME_COUNT * time);
+
+    /*
+     * The last frame is only taken once the bucket, full at first, was refilled with the bus time of the others,
+     * at LOAD percent of the elapsed time. Only this lower bound is checked, as a loaded machine only adds to it.
+     * The achieved load is thus only bounded from above, the burst and the last frame allowing it to exceed LOAD
+     * slightly.
+     */
+    const auto minimum = std::chrono::nanoseconds(static_cast<int64_t>((FRAME_COUNT - 1) * time * 100 / LOAD)) -
+                         can::pacer::DEFAULT_BURST * static_cast<int64_t>(100 / LOAD);
+    assert(elapsed >= minimum);
+    assert(statistics.load_ > 0);
+    assert(statistics.load_ <= LOAD * 1.05);
+
+    std::cout << "achieved " << statistics.load_ << "% bus load over " << statistics.elapsed_ns_ / 1000 << " us"
+              << std::endl;
+}
+
+static void test_refused() {
+    auto transmitter = std::make_shared<fake_transmitter>();
+    auto pacer       = can::pacer::create(transmitter, 500000, 50);
+    assert(pacer != nullptr);
+
+    /* refused frames don't count as bus load */
+    transmitter->refusing_ = true;
+    assert(!pacer->transmit(can::frame::create(0x123, 0, nullptr)));
+
+    auto statistics = pacer->get_statistics();
+    assert(statistics.frames_ == 0);
+    assert(statistics.bus_time_ns_ == 0);
+}
+
+int main() {
+    test_invalid();
+    test_load();
+    test_refused();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
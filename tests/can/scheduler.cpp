@@ -0,0 +1,130 @@
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "can/scheduler.hpp"
+
+/*
+ * Transmitter recording the identifiers it is given, which can be held to let
+ * frames pile up in the scheduler.
+ */
+class fake_transmitter : public can::transmitter {
+   public:
+    bool transmit(can::frame::ptr msg) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&]() { return !held_; });
+        identifiers_.push_back(msg->identifier_);
+        return msg->identifier_ != REFUSED_IDENTIFIER;
+    }
+
+    void hold(bool held) {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            held_ = held;
+        }
+        condition_.notify_all();
+    }
+
+    std::vector<uint32_t> get_identifiers() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return identifiers_;
+    }
+
+    static constexpr uint32_t REFUSED_IDENTIFIER = 0x7FF;
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool held_ = false;
+    std::vector<uint32_t> identifiers_;
+};
+
+static void test_priority() {
+    auto transmitter = std::make_shared<fake_transmitter>();
+    can::scheduler scheduler(transmitter);
+
+    /* the first frame is stuck in the driver while the others are queued */
+    transmitter->hold(true);
+    assert(scheduler.transmit(can::frame::create(0x400, 0, nullptr)));
+    while (scheduler.get_statistics().pending_ != 0) {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t identifier : {0x300, 0x100, 0x200, 0x100}) {
+        assert(scheduler.transmit(can::frame::create(identifier, 0, nullptr)));
+    }
+
+    assert(scheduler.transmit(can::frame::create(fake_transmitter::REFUSED_IDENTIFIER, 0, nullptr)));
+
+    transmitter->hold(false);
+    assert(scheduler.flush(1000));
+
+    auto identifiers = transmitter->get_identifiers();
+    assert((identifiers == std::vector<uint32_t>{0x400, 0x100, 0x100, 0x200, 0x300, 0x7FF}));
+
+    auto statistics = scheduler.get_statistics();
+    assert(statistics.pending_ == 0);
+    assert(statistics.transmitted_ == 5);
+    assert(statistics.failed_ == 1);
+    assert(statistics.expired_ == 0);
+}
+
+static void test_deadline() {
+    auto transmitter = std::make_shared<fake_transmitter>();
+    can::scheduler scheduler(transmitter);
+
+    transmitter->hold(true);
+    assert(scheduler.transmit(can::frame::create(0x400, 0, nullptr)));
+    while (scheduler.get_statistics().pending_ != 0) {
+        std::this_thread::yield();
+    }
+
+    /* frames still queued when their deadline passes are dropped */
+    auto now = can::scheduler::clock::now();
+    assert(scheduler.transmit(can::frame::create(0x100, 0, nullptr), now + std::chrono::milliseconds(10)));
+    assert(scheduler.transmit(can::frame::create(0x200, 0, nullptr), now + std::chrono::seconds(10)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    transmitter->hold(false);
+    assert(scheduler.flush(1000));
+
+    auto identifiers = transmitter->get_identifiers();
+    assert((identifiers == std::vector<uint32_t>{0x400, 0x200}));
+
+    auto statistics = scheduler.get_statistics();
+    assert(statistics.transmitted_ == 2);
+    assert(statistics.expired_ == 1);
+}
+
+static void test_capacity() {
+    auto transmitter = std::make_shared<fake_transmitter>();
+    can::scheduler scheduler(transmitter, 2);
+
+    transmitter->hold(true);
+    assert(scheduler.transmit(can::frame::create(0x400, 0, nullptr)));
+    while (scheduler.get_statistics().pending_ != 0) {
+        std::this_thread::yield();
+    }
+
+    assert(scheduler.transmit(can::frame::create(0x100, 0, nullptr)));
+    assert(scheduler.transmit(can::frame::create(0x200, 0, nullptr)));
+    assert(!scheduler.transmit(can::frame::create(0x300, 0, nullptr)));
+    assert(!scheduler.flush(10));
+
+    transmitter->hold(false);
+    assert(scheduler.flush(1000));
+    assert(scheduler.get_statistics().rejected_ == 1);
+}
+
+int main() {
+    test_priority();
+    test_deadline();
+    test_capacity();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}
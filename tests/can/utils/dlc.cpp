@@ -0,0 +1,36 @@
+#include <cassert>
+
+#include "can/utils/dlc.hpp"
+
+/* classic lengths are their own code */
+static_assert(can::utils::dlc::from_length(0) == 0);
+static_assert(can::utils::dlc::from_length(8) == 8);
+static_assert(can::utils::dlc::to_length(0) == 0);
+static_assert(can::utils::dlc::to_length(8) == 8);
+
+/* CAN FD lengths */
+static_assert(can::utils::dlc::to_length(9) == 12);
+static_assert(can::utils::dlc::to_length(13) == 32);
+static_assert(can::utils::dlc::to_length(15) == 64);
+static_assert(can::utils::dlc::from_length(12) == 9);
+static_assert(can::utils::dlc::from_length(48) == 14);
+static_assert(can::utils::dlc::from_length(64) == 15);
+
+/* lengths between two codes are rounded up */
+static_assert(can::utils::dlc::from_length(9) == 9);
+static_assert(can::utils::dlc::from_length(33) == 14);
+static_assert(can::utils::dlc::pad_length(9) == 12);
+static_assert(can::utils::dlc::pad_length(49) == 64);
+
+/* out of range values are cropped */
+static_assert(can::utils::dlc::to_length(16) == 64);
+static_assert(can::utils::dlc::to_length(255) == 64);
+static_assert(can::utils::dlc::from_length(65) == 15);
+
+int main() {
+    for (uint8_t dlc = 0; dlc <= can::utils::dlc::MAX_DLC; dlc++) {
+        assert(can::utils::dlc::from_length(can::utils::dlc::to_length(dlc)) == dlc);
+    }
+
+    return 0;
+}
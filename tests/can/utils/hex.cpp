@@ -0,0 +1,69 @@
+#include <array>
+#include <cassert>
+#include <string>
+
+#include "can/utils/hex.hpp"
+
+static constexpr bool decodes_to(const char* text, size_t length, std::array<uint8_t, 8> expected) {
+    std::array<uint8_t, 8> bytes{};
+    return can::utils::hex::decode(text, length, bytes.data()) && bytes == expected;
+}
+
+/* digits in both cases */
+static_assert(can::utils::hex::decode_digit('0') == 0);
+static_assert(can::utils::hex::decode_digit('9') == 9);
+static_assert(can::utils::hex::decode_digit('a') == 10);
+static_assert(can::utils::hex::decode_digit('F') == 15);
+static_assert(can::utils::hex::decode_digit('G') == -1);
+static_assert(can::utils::hex::decode_digit('/') == -1);
+
+/* payloads, decoded by words and then digit by digit */
+static_assert(decodes_to("DEADBEEF", 4, {0xDE, 0xAD, 0xBE, 0xEF}));
+static_assert(decodes_to("0123456789abcdef", 8, {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF}));
+static_assert(decodes_to("C0FFEE", 3, {0xC0, 0xFF, 0xEE}));
+static_assert(!decodes_to("DEADBEEG", 4, {}));
+static_assert(!decodes_to("0123456789ABCDE:", 8, {}));
+
+int main() {
+    /* every character at every position of a word agrees with the decoding of a single digit */
+    for (size_t position = 0; position < 8; position++) {
+        for (int character = 0; character < 256; character++) {
+            std::string text = "00000000";
+            text[position]   = static_cast<char>(character);
+
+            std::array<uint8_t, 4> bytes{};
+            const int digit = can::utils::hex::decode_digit(static_cast<char>(character));
+            assert(can::utils::hex::decode(text.data(), bytes.size(), bytes.data()) == (digit >= 0));
+
+            if (digit >= 0) {
+                const int shift = (position % 2 == 0) ? 4 : 0;
+                assert(bytes.at(position / 2) == (digit << shift));
+            }
+        }
+    }
+
+    /* encoding round trips */
+    std::array<uint8_t, 64> bytes{};
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes.at(i) = static_cast<uint8_t>(i * 37);
+    }
+
+    std::string text(bytes.size() * 2, ' ');
+    can::utils::hex::encode(bytes.data(), bytes.size(), text.data());
+    assert(text.substr(0, 6) == "00254A");
+
+    std::array<uint8_t, 64> decoded{};
+    assert(can::utils::hex::decode(text.data(), decoded.size(), decoded.data()));
+    assert(decoded == bytes);
+
+    std::string identifier(8, ' ');
+    can::utils::hex::encode_integer(0x1ABCDEF0U, identifier.size(), identifier.data());
+    assert(identifier == "1ABCDEF0");
+
+    uint32_t value = 0;
+    assert(can::utils::hex::decode_integer(identifier.data(), identifier.size(), value));
+    assert(value == 0x1ABCDEF0U);
+    assert(!can::utils::hex::decode_integer("12x", 3, value));
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <cassert>
+#include <cstdint>
+
+#include "can/utils/options.hpp"
+
+int main() {
+    const std::map<std::string, std::string> options = {
+        {"count", "42"}, {"negative", "-3"}, {"large", "300"}, {"text", "abc"}, {"suffix", "12ms"}, {"empty", ""},
+        {"ratio", "2.5"}, {"infinite", "inf"},
+    };
+
+    /* missing options fall back to the default value */
+    assert(can::utils::get_integral_option<uint32_t>(options, "missing", 7) == 7U);
+
+    /* valid numbers */
+    assert(can::utils::get_integral_option<uint32_t>(options, "count", 0) == 42U);
+    assert(can::utils::get_integral_option<int>(options, "negative", 0) == -3);
+
+    /* invalid numbers for the type */
+    assert(!can::utils::get_integral_option<uint32_t>(options, "negative", 0).has_value());
+    assert(!can::utils::get_integral_option<uint8_t>(options, "large", 0).has_value());
+    assert(!can::utils::get_integral_option<uint32_t>(options, "text", 0).has_value());
+    assert(!can::utils::get_integral_option<uint32_t>(options, "suffix", 0).has_value());
+    assert(!can::utils::get_integral_option<uint32_t>(options, "empty", 0).has_value());
+    assert(!can::utils::get_integral_option<uint32_t>(options, "ratio", 0).has_value());
+
+    /* floating point numbers */
+    assert(can::utils::get_floating_option<double>(options, "missing", 1.5) == 1.5);
+    assert(can::utils::get_floating_option<double>(options, "ratio", 0) == 2.5);
+    assert(can::utils::get_floating_option<double>(options, "negative", 0) == -3);
+    assert(!can::utils::get_floating_option<double>(options, "infinite", 0).has_value());
+    assert(!can::utils::get_floating_option<double>(options, "suffix", 0).has_value());
+    assert(!can::utils::get_floating_option<double>(options, "empty", 0).has_value());
+
+    return 0;
+}
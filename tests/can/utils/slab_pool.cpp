@@ -0,0 +1,83 @@
+#include <cassert>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "can/utils/slab_pool.hpp"
+
+static void test_exhaustion() {
+    can::utils::slab_pool pool(24, 4);
+    assert(pool.get_block_count() == 4);
+    assert(pool.get_block_size() >= 24);
+
+    std::set<void*> blocks;
+    for (int i = 0; i < 4; i++) {
+        void* block = pool.allocate();
+        assert(block != nullptr);
+        assert(pool.owns(block));
+        blocks.insert(block);
+    }
+
+    /* every block is distinct and the pool is now empty */
+    assert(blocks.size() == 4);
+    assert(pool.allocate() == nullptr);
+    assert(pool.get_hits() == 4);
+    assert(pool.get_misses() == 1);
+
+    /* foreign pointers are rejected */
+    int foreign = 0;
+    assert(!pool.owns(&foreign));
+    assert(!pool.release(&foreign));
+
+    /* released blocks are recycled */
+    void* block = *blocks.begin();
+    assert(pool.release(block));
+    assert(pool.allocate() == block);
+}
+
+static void test_concurrency() {
+    constexpr int THREAD_COUNT    = 8;
+    constexpr int ITERATION_COUNT = 100000;
+    constexpr uint32_t BLOCKS     = 64;
+
+    can::utils::slab_pool pool(sizeof(int), BLOCKS);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&pool, t]() {
+            for (int i = 0; i < ITERATION_COUNT; i++) {
+                auto* block = static_cast<int*>(pool.allocate());
+                if (block == nullptr) {
+                    continue;
+                }
+
+                /* a block must never be handed to two threads at once */
+                *block = t;
+                std::this_thread::yield();
+                assert(*block == t);
+                assert(pool.release(block));
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /* all blocks must be back in the pool */
+    std::set<void*> blocks;
+    for (uint32_t i = 0; i < BLOCKS; i++) {
+        void* block = pool.allocate();
+        assert(block != nullptr);
+        blocks.insert(block);
+    }
+    assert(blocks.size() == BLOCKS);
+    assert(pool.allocate() == nullptr);
+}
+
+int main() {
+    test_exhaustion();
+    test_concurrency();
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "can/utils/wire.hpp"
+
+static size_t count_classic(uint32_t identifier, const std::vector<uint8_t>& bytes) {
+    auto bits = can::utils::wire::count_bits(identifier, bytes.size(), bytes.data(), 0);
+    assert(bits.data_ == 0);
+    return bits.nominal_;
+}
+
+static void test_classic() {
+    /* 47 bits without stuffing for an empty frame, 111 bits with 8 bytes */
+    assert(count_classic(0x7FF, {}) == 50);
+    assert(count_classic(0x123, {0x11, 0x22, 0x33, 0x44}) == 80);
+
+    /* alternating levels never need stuffing, long runs of zeros do */
+    assert(count_classic(0x555, std::vector<uint8_t>(8, 0x55)) == 112);
+    assert(count_classic(0x000, std::vector<uint8_t>(8, 0x00)) == 127);
+}
+
+static void test_fd() {
+    std::array<uint8_t, 64> bytes{};
+
+    /* without bitrate switch, the whole frame is sent at the nominal bitrate */
+    auto bits = can::utils::wire::count_bits(0x123, bytes.size(), bytes.data(), can::frame::FD);
+    assert(bits.data_ == 0);
+    assert(bits.nominal_ > 17 + 1 + 4 + 512 + 4 + 21 + 7 + 13);
+
+    /* with bitrate switch, only the arbitration phase and the tail are */
+    auto switched =
+        can::utils::wire::count_bits(0x123, bytes.size(), bytes.data(), can::frame::FD | can::frame::BRS);
+    assert(switched.nominal_ + switched.data_ == bits.nominal_);
+    assert(switched.nominal_ >= 17 + 13 && switched.nominal_ < 17 + 13 + 4);
+
+    /* payloads are padded to the next valid length */
+    auto padded = can::utils::wire::count_bits(0x123, 9, bytes.data(), can::frame::FD);
+    auto full   = can::utils::wire::count_bits(0x123, 12, bytes.data(), can::frame::FD);
+    assert(padded.nominal_ == full.nominal_);
+
+    /* the data phase is shortened by the data bitrate */
+    assert(can::utils::wire::get_duration_ns(bits, 500000) == bits.nominal_ * 2000);
+    assert(can::utils::wire::get_duration_ns(switched, 500000, 2000000) ==
+           switched.nominal_ * 2000 + switched.data_ * 500);
+}
+
+int main() {
+    test_classic();
+    test_fd();
+
+    std::cout << "all tests passed" << std::endl;
+    return 0;
+}